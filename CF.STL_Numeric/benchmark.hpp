@@ -0,0 +1,261 @@
+//
+//  benchmark.hpp
+//  CF.STL_Numeric
+//
+//  MARK: - References.
+//  @see: https://github.com/google/benchmark (DoNotOptimize / ClobberMemory)
+//  @see: https://en.cppreference.com/w/cpp/chrono/steady_clock
+//
+
+#ifndef benchmark_hpp
+#define benchmark_hpp
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace cfnum::bench {
+
+/*
+ *  MARK: do_not_optimize(), clobber_memory()
+ *
+ *  Keep a result (or the memory it lives in) observable so the optimiser cannot
+ *  delete the work being timed.
+ */
+template <typename T>
+inline void do_not_optimize(T const & value) {
+  if constexpr (std::is_trivially_copyable_v<T> && sizeof(T) <= sizeof(void *)) {
+    asm volatile("" : : "r,m"(value) : "memory");
+  }
+  else {
+    asm volatile("" : : "m"(value) : "memory");
+  }
+}
+
+inline void clobber_memory() {
+  asm volatile("" : : : "memory");
+}
+
+/*
+ *  MARK: options, result
+ */
+struct options {
+  std::size_t warmup = 3;             //  untimed calls first: page faults, caches, branch predictors
+  std::size_t samples = 21;           //  timed samples kept for the statistics
+  double min_sample_ms = 0.05;        //  short calls are batched until a sample lasts this long
+  std::size_t elements = 0;           //  per call, for elements/s (0 = not reported)
+  std::size_t bytes = 0;              //  per call, for bytes/s (0 = not reported)
+};
+
+struct result {
+  std::string name;
+  std::size_t samples = 0;
+  std::size_t iterations = 0;         //  calls per sample
+  double min_ns = 0.0;                //  all times are per call
+  double median_ns = 0.0;
+  double p99_ns = 0.0;
+  double mean_ns = 0.0;
+  std::size_t elements = 0;
+  std::size_t bytes = 0;
+
+  double elements_per_s() const noexcept { return elements ? elements * 1e9 / median_ns : 0.0; }
+  double bytes_per_s() const noexcept { return bytes ? bytes * 1e9 / median_ns : 0.0; }
+  double median_ms() const noexcept { return median_ns * 1e-6; }
+};
+
+/*
+ *  MARK: registry
+ *
+ *  Every run() lands here so main() can dump the whole session as JSON or CSV.
+ */
+class registry {
+public:
+  void add(result const & r_) { results_.push_back(r_); }
+  std::vector<result> const & all() const noexcept { return results_; }
+
+  void write_csv(std::ostream & os) const {
+    os << "name,samples,iterations,min_ns,median_ns,p99_ns,mean_ns,elements,bytes,elements_per_s,bytes_per_s\n";
+    for (auto const & r_ : results_) {
+      os << '"' << csv_quoted(r_.name) << '"' << ','
+         << r_.samples << ',' << r_.iterations << ','
+         << r_.min_ns << ',' << r_.median_ns << ',' << r_.p99_ns << ',' << r_.mean_ns << ','
+         << r_.elements << ',' << r_.bytes << ','
+         << r_.elements_per_s() << ',' << r_.bytes_per_s() << '\n';
+    }
+  }
+
+  void write_json(std::ostream & os) const {
+    os << "{\n  \"benchmarks\": [";
+    char const * sep = "\n";
+    for (auto const & r_ : results_) {
+      os << sep << "    { \"name\": \"" << escaped(r_.name) << "\""
+         << ", \"samples\": " << r_.samples
+         << ", \"iterations\": " << r_.iterations
+         << ", \"min_ns\": " << r_.min_ns
+         << ", \"median_ns\": " << r_.median_ns
+         << ", \"p99_ns\": " << r_.p99_ns
+         << ", \"mean_ns\": " << r_.mean_ns
+         << ", \"elements\": " << r_.elements
+         << ", \"bytes\": " << r_.bytes
+         << ", \"elements_per_s\": " << r_.elements_per_s()
+         << ", \"bytes_per_s\": " << r_.bytes_per_s()
+         << " }";
+      sep = ",\n";
+    }
+    os << "\n  ]\n}\n";
+  }
+
+  bool write_csv_file(std::string const & path) const {
+    return write_file(path, &registry::write_csv);
+  }
+
+  bool write_json_file(std::string const & path) const {
+    return write_file(path, &registry::write_json);
+  }
+
+private:
+  bool write_file(std::string const & path, void (registry::*write)(std::ostream &) const) const {
+    std::ofstream out(path);
+    if (!out) {
+      return false;
+    }
+    out << std::setprecision(10);
+    (this->*write)(out);
+    return static_cast<bool>(out);
+  }
+
+  static std::string escaped(std::string const & s_) {
+    std::string e_;
+    for (char c_ : s_) {
+      if (c_ == '"' || c_ == '\\') {
+        e_ += '\\';
+      }
+      e_ += c_;
+    }
+    return e_;
+  }
+
+  //  RFC 4180: a quote inside a quoted field is written twice.
+  static std::string csv_quoted(std::string const & s_) {
+    std::string e_;
+    for (char c_ : s_) {
+      if (c_ == '"') {
+        e_ += '"';
+      }
+      e_ += c_;
+    }
+    return e_;
+  }
+
+  std::vector<result> results_;
+};
+
+inline registry & results() {
+  static registry r_;
+  return r_;
+}
+
+/*
+ *  MARK: run()
+ *
+ *  Calls fn() opts.warmup times, calibrates how many calls make one sample, then
+ *  records opts.samples samples and reports min / median / p99 per call.
+ *  Wrap the value fn() computes in do_not_optimize() inside fn.
+ */
+template <typename Fn>
+result run(std::string name, options const & opts, Fn && fn) {
+  using clock = std::chrono::steady_clock;
+
+  for (std::size_t w_ = 0; w_ < opts.warmup; ++w_) {
+    fn();
+    clobber_memory();
+  }
+
+  std::size_t iterations = 1;
+  for (;;) {
+    auto const t1 = clock::now();
+    for (std::size_t i_ = 0; i_ < iterations; ++i_) {
+      fn();
+      clobber_memory();
+    }
+    std::chrono::duration<double, std::milli> const ms = clock::now() - t1;
+    if (ms.count() >= opts.min_sample_ms || iterations >= (std::size_t(1) << 24)) {
+      break;
+    }
+    iterations *= 2;
+  }
+
+  std::vector<double> ns(std::max<std::size_t>(opts.samples, 1));
+  for (auto & s_ : ns) {
+    auto const t1 = clock::now();
+    for (std::size_t i_ = 0; i_ < iterations; ++i_) {
+      fn();
+      clobber_memory();
+    }
+    std::chrono::duration<double, std::nano> const d_ = clock::now() - t1;
+    s_ = d_.count() / static_cast<double>(iterations);
+  }
+  std::sort(ns.begin(), ns.end());
+
+  result r_;
+  r_.name = std::move(name);
+  r_.samples = ns.size();
+  r_.iterations = iterations;
+  r_.min_ns = ns.front();
+  r_.median_ns = ns.size() % 2 ? ns[ns.size() / 2] : (ns[ns.size() / 2 - 1] + ns[ns.size() / 2]) / 2;
+  r_.p99_ns = ns[static_cast<std::size_t>(std::ceil(0.99 * static_cast<double>(ns.size()))) - 1];
+  double total = 0.0;
+  for (auto s_ : ns) {
+    total += s_;
+  }
+  r_.mean_ns = total / static_cast<double>(ns.size());
+  r_.elements = opts.elements;
+  r_.bytes = opts.bytes;
+
+  results().add(r_);
+  return r_;
+}
+
+/*
+ *  MARK: print()
+ */
+inline void print_header(std::ostream & os = std::cout) {
+  auto const flags = os.flags();
+  os << std::left << std::setw(64) << "benchmark" << std::right
+     << std::setw(12) << "min ms"
+     << std::setw(12) << "median ms"
+     << std::setw(12) << "p99 ms"
+     << std::setw(12) << "Melem/s"
+     << std::setw(10) << "GB/s"
+     << '\n';
+  os.flags(flags);
+}
+
+inline void print(result const & r_, std::ostream & os = std::cout) {
+  auto const flags = os.flags();
+  auto const prec = os.precision();
+  os << std::left << std::setw(64) << r_.name << std::right << std::fixed
+     << std::setprecision(4)
+     << std::setw(12) << r_.min_ns * 1e-6
+     << std::setw(12) << r_.median_ns * 1e-6
+     << std::setw(12) << r_.p99_ns * 1e-6
+     << std::setprecision(1)
+     << std::setw(12) << r_.elements_per_s() * 1e-6
+     << std::setprecision(2)
+     << std::setw(10) << r_.bytes_per_s() * 1e-9
+     << '\n';
+  os.flags(flags);
+  os.precision(prec);
+}
+
+} /* namespace cfnum::bench */
+
+#endif /* benchmark_hpp */
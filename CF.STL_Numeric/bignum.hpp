@@ -0,0 +1,452 @@
+//
+//  bignum.hpp
+//  CF.STL_Numeric
+//
+//  MARK: - References.
+//  @see: Knuth, TAOCP vol. 2, 4.3 (multiple-precision arithmetic)
+//  @see: https://en.wikipedia.org/wiki/Karatsuba_algorithm
+//  @see: http://www.luschny.de/math/factorial/FastFactorialFunctions.htm (binary splitting)
+//
+
+#ifndef bignum_hpp
+#define bignum_hpp
+
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "thread_pool.hpp"
+
+namespace cfnum {
+
+namespace detail {
+
+using limb = std::uint64_t;
+using limb_vector = std::vector<limb>;
+using wide_limb = unsigned __int128;
+
+//  Below this many limbs in the shorter operand, schoolbook beats Karatsuba.
+inline constexpr std::size_t karatsuba_limbs = 32;
+//  Products at least this large split their three half-products over the pool.
+inline constexpr std::size_t parallel_mul_limbs = 1'024;
+
+inline std::size_t trimmed(limb const * p_, std::size_t n_) noexcept {
+  while (n_ != 0 && p_[n_ - 1] == 0) {
+    --n_;
+  }
+  return n_;
+}
+
+inline void trim(limb_vector & v_) noexcept {
+  v_.resize(trimmed(v_.data(), v_.size()));
+}
+
+//  r += a * B^shift, growing r as needed.
+inline void add_at(limb_vector & r_, limb const * a_, std::size_t na, std::size_t shift) {
+  if (r_.size() < shift + na + 1) {
+    r_.resize(shift + na + 1, 0);
+  }
+  limb carry = 0;
+  std::size_t i_ = 0;
+  for (; i_ < na; ++i_) {
+    wide_limb const s_ = wide_limb(r_[shift + i_]) + a_[i_] + carry;
+    r_[shift + i_] = limb(s_);
+    carry = limb(s_ >> 64);
+  }
+  for (std::size_t j_ = shift + i_; carry != 0; ++j_) {
+    if (j_ == r_.size()) {
+      r_.push_back(0);
+    }
+    wide_limb const s_ = wide_limb(r_[j_]) + carry;
+    r_[j_] = limb(s_);
+    carry = limb(s_ >> 64);
+  }
+}
+
+//  r -= a; requires r >= a.
+inline void sub_in_place(limb_vector & r_, limb const * a_, std::size_t na) noexcept {
+  limb borrow = 0;
+  std::size_t i_ = 0;
+  for (; i_ < na; ++i_) {
+    limb const x_ = r_[i_];
+    limb const d_ = x_ - a_[i_] - borrow;
+    borrow = (x_ < a_[i_]) || (x_ - a_[i_] < borrow);
+    r_[i_] = d_;
+  }
+  for (; borrow != 0 && i_ < r_.size(); ++i_) {
+    borrow = r_[i_] == 0;
+    --r_[i_];
+  }
+  trim(r_);
+}
+
+inline limb_vector add(limb const * a_, std::size_t na, limb const * b_, std::size_t nb) {
+  if (na < nb) {
+    std::swap(a_, b_);
+    std::swap(na, nb);
+  }
+  limb_vector r_(a_, a_ + na);
+  add_at(r_, b_, nb, 0);
+  trim(r_);
+  return r_;
+}
+
+//  out[0, na + nb) = a * b; out must be zeroed.
+inline void mul_schoolbook(limb const * a_, std::size_t na, limb const * b_, std::size_t nb, limb * out) noexcept {
+  for (std::size_t j_ = 0; j_ < nb; ++j_) {
+    limb carry = 0;
+    for (std::size_t i_ = 0; i_ < na; ++i_) {
+      wide_limb const t_ = wide_limb(a_[i_]) * b_[j_] + out[i_ + j_] + carry;
+      out[i_ + j_] = limb(t_);
+      carry = limb(t_ >> 64);
+    }
+    out[na + j_] = carry;
+  }
+}
+
+//  v *= m.
+inline void mul_small(limb_vector & v_, limb m_) {
+  limb carry = 0;
+  for (auto & x_ : v_) {
+    wide_limb const t_ = wide_limb(x_) * m_ + carry;
+    x_ = limb(t_);
+    carry = limb(t_ >> 64);
+  }
+  if (carry != 0) {
+    v_.push_back(carry);
+  }
+  if (m_ == 0) {
+    v_.clear();
+  }
+}
+
+/*
+ *  Karatsuba on (pointer, length) views:
+ *    a = a1 B^m + a0,  b = b1 B^m + b0
+ *    a b = z2 B^2m + (z1 - z2 - z0) B^m + z0,  z1 = (a0 + a1)(b0 + b1)
+ *  Operands of very different length are cut into pieces of the shorter one's size
+ *  so each piece is a balanced product.
+ */
+inline limb_vector mul(limb const * a_, std::size_t na, limb const * b_, std::size_t nb, thread_pool * pool) {
+  na = trimmed(a_, na);
+  nb = trimmed(b_, nb);
+  if (na < nb) {
+    std::swap(a_, b_);
+    std::swap(na, nb);
+  }
+  if (nb == 0) {
+    return {};
+  }
+  if (nb < karatsuba_limbs) {
+    limb_vector r_(na + nb, 0);
+    mul_schoolbook(a_, na, b_, nb, r_.data());
+    trim(r_);
+    return r_;
+  }
+  bool const parallel = pool != nullptr && nb >= parallel_mul_limbs;
+
+  if (2 * nb <= na) {
+    std::size_t const pieces = (na + nb - 1) / nb;
+    std::vector<limb_vector> part(pieces);
+    auto piece = [&](std::size_t p_) {
+      std::size_t const off = p_ * nb;
+      part[p_] = mul(a_ + off, std::min(nb, na - off), b_, nb, nullptr);
+    };
+    if (parallel) {
+      pool->parallel_for(pieces, piece);
+    }
+    else {
+      for (std::size_t p_ = 0; p_ < pieces; ++p_) {
+        piece(p_);
+      }
+    }
+    limb_vector r_;
+    r_.reserve(na + nb + 1);
+    for (std::size_t p_ = 0; p_ < pieces; ++p_) {
+      add_at(r_, part[p_].data(), part[p_].size(), p_ * nb);
+    }
+    trim(r_);
+    return r_;
+  }
+
+  std::size_t const m_ = na / 2;
+  limb const * a0 = a_;
+  limb const * a1 = a_ + m_;
+  limb const * b0 = b_;
+  limb const * b1 = b_ + m_;
+  std::size_t const na0 = trimmed(a0, m_);
+  std::size_t const nb0 = trimmed(b0, m_);
+  std::size_t const na1 = na - m_;
+  std::size_t const nb1 = nb - m_;
+
+  limb_vector z0, z1, z2;
+  auto const sa = add(a0, na0, a1, na1);
+  auto const sb = add(b0, nb0, b1, nb1);
+  //  Serial inside each task: the pool runs nested parallel_for calls serially.
+  auto half = [&](std::size_t k_) {
+    switch (k_) {
+      case 0:  z0 = mul(a0, na0, b0, nb0, nullptr); break;
+      case 1:  z2 = mul(a1, na1, b1, nb1, nullptr); break;
+      default: z1 = mul(sa.data(), sa.size(), sb.data(), sb.size(), nullptr); break;
+    }
+  };
+  if (parallel) {
+    pool->parallel_for(3, half);
+  }
+  else {
+    half(0);
+    half(1);
+    half(2);
+  }
+  sub_in_place(z1, z0.data(), z0.size());
+  sub_in_place(z1, z2.data(), z2.size());
+
+  limb_vector r_ = std::move(z0);
+  r_.reserve(na + nb + 1);
+  add_at(r_, z1.data(), z1.size(), m_);
+  add_at(r_, z2.data(), z2.size(), 2 * m_);
+  trim(r_);
+  return r_;
+}
+
+} /* namespace detail */
+
+/*
+ *  MARK: biguint
+ *
+ *  Arbitrary-precision unsigned integer: little-endian 64-bit limbs with no
+ *  leading zero limb (zero has none).  Value type; arithmetic never throws
+ *  beyond std::bad_alloc.  Subtraction requires a >= b, as with unsigned.
+ */
+class biguint {
+public:
+  using limb = detail::limb;
+
+  biguint() = default;
+  biguint(std::uint64_t v_) { if (v_ != 0) { limbs_.push_back(v_); } }
+  explicit biguint(unsigned __int128 v_) {
+    for (; v_ != 0; v_ >>= 64) {
+      limbs_.push_back(limb(v_));
+    }
+  }
+
+  bool is_zero() const noexcept { return limbs_.empty(); }
+  std::size_t size() const noexcept { return limbs_.size(); }
+  std::span<limb const> limbs() const noexcept { return limbs_; }
+
+  std::size_t bit_width() const noexcept {
+    return limbs_.empty() ? 0 : 64 * (limbs_.size() - 1) + (64 - __builtin_clzll(limbs_.back()));
+  }
+
+  biguint & operator+=(biguint const & b_) {
+    detail::add_at(limbs_, b_.limbs_.data(), b_.limbs_.size(), 0);
+    detail::trim(limbs_);
+    return *this;
+  }
+
+  biguint & operator-=(biguint const & b_) {
+    detail::sub_in_place(limbs_, b_.limbs_.data(), b_.limbs_.size());
+    return *this;
+  }
+
+  biguint & operator*=(std::uint64_t m_) {
+    detail::mul_small(limbs_, m_);
+    return *this;
+  }
+
+  biguint & operator*=(biguint const & b_) {
+    return *this = multiply(*this, b_);
+  }
+
+  friend biguint operator+(biguint a_, biguint const & b_) { return a_ += b_; }
+  friend biguint operator-(biguint a_, biguint const & b_) { return a_ -= b_; }
+  friend biguint operator*(biguint a_, std::uint64_t m_) { return a_ *= m_; }
+  friend biguint operator*(biguint const & a_, biguint const & b_) { return multiply(a_, b_); }
+
+  //  Product on the pool: the top level of the Karatsuba recursion runs its
+  //  three half-size products as parallel tasks.  Pass a pool only from outside
+  //  a running task; inside one, pass nullptr.
+  friend biguint multiply(biguint const & a_, biguint const & b_, thread_pool * pool = nullptr) {
+    biguint r_;
+    r_.limbs_ = detail::mul(a_.limbs_.data(), a_.limbs_.size(), b_.limbs_.data(), b_.limbs_.size(), pool);
+    return r_;
+  }
+
+  friend bool operator==(biguint const &, biguint const &) = default;
+
+  friend std::strong_ordering operator<=>(biguint const & a_, biguint const & b_) noexcept {
+    if (a_.limbs_.size() != b_.limbs_.size()) {
+      return a_.limbs_.size() <=> b_.limbs_.size();
+    }
+    for (std::size_t i_ = a_.limbs_.size(); i_-- != 0; ) {
+      if (a_.limbs_[i_] != b_.limbs_[i_]) {
+        return a_.limbs_[i_] <=> b_.limbs_[i_];
+      }
+    }
+    return std::strong_ordering::equal;
+  }
+
+  //  Decimal text, 19 digits per pass of short division by 10^19: quadratic, so
+  //  meant for values up to some ten thousand digits.
+  std::string to_string() const {
+    if (limbs_.empty()) {
+      return "0";
+    }
+    constexpr limb chunk = 10'000'000'000'000'000'000ULL;
+    detail::limb_vector q_ = limbs_;
+    std::vector<limb> parts;
+    while (!q_.empty()) {
+      limb rem = 0;
+      for (std::size_t i_ = q_.size(); i_-- != 0; ) {
+        detail::wide_limb const cur = (detail::wide_limb(rem) << 64) | q_[i_];
+        q_[i_] = limb(cur / chunk);
+        rem = limb(cur % chunk);
+      }
+      detail::trim(q_);
+      parts.push_back(rem);
+    }
+    std::string s_ = std::to_string(parts.back());
+    for (std::size_t i_ = parts.size() - 1; i_-- != 0; ) {
+      std::string d_ = std::to_string(parts[i_]);
+      s_.append(19 - d_.size(), '0').append(d_);
+    }
+    return s_;
+  }
+
+private:
+  detail::limb_vector limbs_;
+};
+
+/*
+ *  MARK: product_tree()
+ *
+ *  Product of many values, multiplied pairwise level by level so every
+ *  multiplication has operands of similar size (where Karatsuba pays off).
+ *  Each level's products run in parallel on the pool, and the last one is
+ *  split by a parallel Karatsuba.
+ */
+inline biguint product_tree(std::vector<biguint> level, thread_pool & pool) {
+  if (level.empty()) {
+    return biguint(std::uint64_t(1));
+  }
+  while (level.size() > 1) {
+    std::size_t const pairs = level.size() / 2;
+    std::vector<biguint> next((level.size() + 1) / 2);
+    if (pairs == 1) {
+      //  The root product, from this thread: Karatsuba splits it on the pool.
+      //  Inside parallel_for the pool would run its nested calls serially.
+      next[0] = multiply(level[0], level[1], &pool);
+    }
+    else {
+      pool.parallel_for(pairs, [&](std::size_t i_) {
+        next[i_] = multiply(level[2 * i_], level[2 * i_ + 1], nullptr);
+      });
+    }
+    if (level.size() % 2 != 0) {
+      next.back() = std::move(level.back());
+    }
+    level = std::move(next);
+  }
+  return std::move(level.front());
+}
+
+namespace detail {
+
+//  Product of lo+1 .. hi by binary splitting; leaves pack as many factors into
+//  one 64-bit word as fit before touching the bignum.
+inline biguint range_product(std::uint64_t lo, std::uint64_t hi) {
+  if (hi - lo <= 32) {
+    biguint r_(std::uint64_t(1));
+    limb acc = 1;
+    for (std::uint64_t k_ = lo + 1; k_ <= hi; ++k_) {
+      if (acc > ~limb(0) / k_) {
+        r_ *= acc;
+        acc = 1;
+      }
+      acc *= k_;
+    }
+    return r_ *= acc;
+  }
+  std::uint64_t const mid = lo + (hi - lo) / 2;
+  return range_product(lo, mid) * range_product(mid, hi);
+}
+
+} /* namespace detail */
+
+/*
+ *  MARK: big_factorial()
+ *
+ *  n! by binary splitting: 1..n is cut into one range per task, each range's
+ *  product built by recursive halving, and the partial products combined with a
+ *  product tree.  Balanced operands keep every multiplication in Karatsuba's
+ *  favourable regime, which a running product times a small factor never is.
+ */
+inline biguint big_factorial(std::uint64_t n_, thread_pool & pool) {
+  std::size_t const tasks = n_ < 2'048 ? 1 : std::min<std::size_t>(pool.size() * 4, n_ / 512);
+  std::vector<biguint> part(tasks);
+  pool.parallel_for(tasks, [&](std::size_t t_) {
+    part[t_] = detail::range_product(n_ * t_ / tasks, n_ * (t_ + 1) / tasks);
+  });
+  return product_tree(std::move(part), pool);
+}
+
+inline biguint big_factorial(std::uint64_t n_) {
+  return big_factorial(n_, default_pool());
+}
+
+/*
+ *  MARK: big_fibonacci()
+ *
+ *  F(n) by fast doubling from the top bit of n down:
+ *    F(2k) = F(k) (2 F(k+1) - F(k)),  F(2k+1) = F(k)^2 + F(k+1)^2
+ *  O(log n) steps of three multiplications each.  Once the operands are large
+ *  the three run as tasks on the pool, each one serial inside its task (nested
+ *  parallel_for calls would only run serially anyway); smaller ones run one
+ *  after another from this thread.
+ */
+inline biguint big_fibonacci(std::uint64_t n_, thread_pool & pool) {
+  biguint a_;                             //  F(k)
+  biguint b_(std::uint64_t(1));           //  F(k + 1)
+  for (int bit = 63 - __builtin_clzll(n_ | 1); bit >= 0; --bit) {
+    biguint c_, a2, b2;
+    biguint const t_ = b_ + b_ - a_;
+    auto step = [&](std::size_t k_) {
+      switch (k_) {
+        case 0:  c_ = multiply(a_, t_, nullptr); break;
+        case 1:  a2 = multiply(a_, a_, nullptr); break;
+        default: b2 = multiply(b_, b_, nullptr); break;
+      }
+    };
+    if (a_.size() >= detail::parallel_mul_limbs) {
+      pool.parallel_for(3, step);
+    }
+    else {
+      step(0);
+      step(1);
+      step(2);
+    }
+    biguint d_ = a2 + b2;
+    if ((n_ >> bit) & 1) {
+      a_ = std::move(d_);
+      b_ = c_ + a_;
+    }
+    else {
+      a_ = std::move(c_);
+      b_ = std::move(d_);
+    }
+  }
+  return a_;
+}
+
+inline biguint big_fibonacci(std::uint64_t n_) {
+  return big_fibonacci(n_, default_pool());
+}
+
+} /* namespace cfnum */
+
+#endif /* bignum_hpp */
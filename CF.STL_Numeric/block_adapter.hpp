@@ -0,0 +1,164 @@
+//
+//  block_adapter.hpp
+//  CF.STL_Numeric
+//
+//  MARK: - References.
+//  @see: https://en.cppreference.com/w/cpp/iterator/contiguous_iterator
+//
+
+#ifndef block_adapter_hpp
+#define block_adapter_hpp
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <span>
+#include <type_traits>
+
+#include "simd_kernels.hpp"
+
+namespace cfnum {
+
+namespace detail {
+
+//  Elements gathered per block from a node-based container: 8 KB of int64_t,
+//  small enough to stay in L1 while the kernel reads it back.
+inline constexpr std::size_t scratch_block = 1'024;
+
+//  Everything that is not contiguous, std::deque included: the standard gives no
+//  portable way to find where a deque's fixed-size arrays end.
+template <typename It>
+concept gathered_iterator = !std::contiguous_iterator<It>;
+
+struct no_buffer {};
+
+//  Hands out a range as spans: in place where the elements are contiguous,
+//  otherwise copied a block at a time into a scratch buffer.
+template <typename It>
+class block_reader {
+public:
+  using value_type = std::iter_value_t<It>;
+
+  explicit block_reader(It it_) : it_(it_) {}
+
+  //  Most elements the next take() can return without gathering.
+  std::size_t run() const noexcept {
+    if constexpr (std::contiguous_iterator<It>) {
+      return std::numeric_limits<std::size_t>::max();
+    }
+    else {
+      return scratch_block;
+    }
+  }
+
+  //  Up to max_ elements, fewer at the end of the range; an empty span only at
+  //  last_.
+  template <typename Sent>
+  std::span<value_type const> take(std::size_t max_, Sent const & last_) {
+    std::size_t n_ = std::min(max_, run());
+    if constexpr (gathered_iterator<It>) {
+      std::size_t k_ = 0;
+      for (; k_ < n_ && it_ != last_; ++k_, ++it_) {
+        buf_[k_] = *it_;
+      }
+      return { buf_.data(), k_ };
+    }
+    else {
+      if constexpr (std::sized_sentinel_for<Sent, It>) {
+        n_ = std::min(n_, static_cast<std::size_t>(last_ - it_));
+      }
+      value_type const * p_ = std::to_address(it_);
+      it_ += static_cast<std::iter_difference_t<It>>(n_);
+      return { p_, n_ };
+    }
+  }
+
+private:
+  It it_;
+  [[no_unique_address]] std::conditional_t<gathered_iterator<It>,
+                                           std::array<value_type, scratch_block>, no_buffer> buf_;
+};
+
+} /* namespace detail */
+
+/*
+ *  MARK: for_each_block()
+ *
+ *  Calls fn(std::span<T const>) over [first, last) in order: once for a
+ *  contiguous range, once per gathered block of scratch_block elements for
+ *  deque, list, forward_list, set and anything else.
+ */
+template <typename InputIt, typename Fn>
+void for_each_block(InputIt first, InputIt last, Fn fn) {
+  detail::block_reader<InputIt> r_(first);
+  for (auto b_ = r_.take(r_.run(), last); !b_.empty(); b_ = r_.take(r_.run(), last)) {
+    fn(b_);
+  }
+}
+
+/*
+ *  MARK: blocked_reduce(), blocked_transform_reduce()
+ *
+ *  std::reduce(first, last, init) and the two-range
+ *  std::transform_reduce(first1, last1, first2, init) with every block run
+ *  through simd::sum / simd::dot, whatever the containers are.  The two ranges
+ *  may be different kinds (a std::set against a std::vector): each block is cut
+ *  where the first contiguous run of either one ends.  The simd path needs one
+ *  kernel_type for the elements and init; anything else calls the std algorithm.
+ *  Like std::reduce, floating-point sums are reassociated.
+ */
+template <typename InputIt, typename T>
+T blocked_reduce(InputIt first, InputIt last, T init) {
+  using V = std::iter_value_t<InputIt>;
+  if constexpr (simd::kernel_type<V> && std::is_same_v<T, V>) {
+    for_each_block(first, last, [&init](std::span<V const> b_) { init += simd::sum(b_); });
+    return init;
+  }
+  else {
+    return std::accumulate(first, last, init);
+  }
+}
+
+template <typename InputIt1, typename InputIt2, typename T>
+T blocked_transform_reduce(InputIt1 first1, InputIt1 last1, InputIt2 first2, T init) {
+  using V = std::iter_value_t<InputIt1>;
+  if constexpr (simd::kernel_type<V> && std::is_same_v<T, V> && std::is_same_v<std::iter_value_t<InputIt2>, V>
+                && detail::gathered_iterator<InputIt1> && detail::gathered_iterator<InputIt2>) {
+    //  Both node-based: gather them in the same loop so the two pointer chases
+    //  overlap, as they do in std::transform_reduce.
+    std::array<V, detail::scratch_block> x_;
+    std::array<V, detail::scratch_block> y_;
+    while (first1 != last1) {
+      std::size_t k_ = 0;
+      for (; k_ < detail::scratch_block && first1 != last1; ++k_, ++first1, ++first2) {
+        x_[k_] = *first1;
+        y_[k_] = *first2;
+      }
+      init += simd::dot(std::span<V const>(x_.data(), k_), std::span<V const>(y_.data(), k_));
+    }
+    return init;
+  }
+  else if constexpr (simd::kernel_type<V> && std::is_same_v<T, V> && std::is_same_v<std::iter_value_t<InputIt2>, V>) {
+    detail::block_reader<InputIt1> a_(first1);
+    detail::block_reader<InputIt2> b_(first2);
+    for (auto x_ = a_.take(b_.run(), last1); !x_.empty(); x_ = a_.take(b_.run(), last1)) {
+      init += simd::dot(x_, b_.take(x_.size(), std::unreachable_sentinel));
+    }
+    return init;
+  }
+  else {
+    return std::transform_reduce(first1, last1, first2, init);
+  }
+}
+
+template <typename R, typename T>
+T blocked_reduce(R const & r_, T init) {
+  return blocked_reduce(std::ranges::begin(r_), std::ranges::end(r_), init);
+}
+
+} /* namespace cfnum */
+
+#endif /* block_adapter_hpp */
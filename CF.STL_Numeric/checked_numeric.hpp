@@ -0,0 +1,594 @@
+//
+//  checked_numeric.hpp
+//  CF.STL_Numeric
+//
+//  MARK: - References.
+//  @see: https://gcc.gnu.org/onlinedocs/gcc/Integer-Overflow-Builtins.html
+//  @see: https://en.cppreference.com/w/cpp/numeric/add_sat (C++26 saturation arithmetic)
+//  @see: SEI CERT C, INT32-C. Ensure that operations on signed integers do not result in overflow
+//
+
+#ifndef checked_numeric_hpp
+#define checked_numeric_hpp
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <type_traits>
+
+#include "simd_kernels.hpp"
+
+namespace cfnum {
+
+/*
+ *  MARK: checked_plus, checked_minus, checked_multiplies
+ *
+ *  Integer operations that detect overflow with __builtin_*_overflow (one flag
+ *  test after the add / sub / imul on x86).  Used as function objects they give
+ *  std::nullopt on overflow; the folds below call the static members directly:
+ *    overflows(a, b, r)  stores the wrapped result in r and returns the flag
+ *    saturate(a, b)      the limit of T the exact result lies beyond
+ */
+//  std::integral and the 128-bit integers, which std::integral only admits in
+//  GNU modes: the widening folds below take their last step in __int128.
+template <typename T>
+concept checked_integral = std::integral<T> || std::same_as<T, __int128> || std::same_as<T, unsigned __int128>;
+
+struct checked_plus {
+  template <checked_integral T>
+  static constexpr bool overflows(T a_, T b_, T & r_) noexcept { return __builtin_add_overflow(a_, b_, &r_); }
+
+  template <checked_integral T>
+  static constexpr T saturate(T, T b_) noexcept {
+    if constexpr (T(-1) < T(0)) {
+      if (b_ < 0) {
+        return std::numeric_limits<T>::min();
+      }
+    }
+    return std::numeric_limits<T>::max();
+  }
+
+  template <checked_integral T>
+  constexpr std::optional<T> operator()(T a_, T b_) const noexcept {
+    T r_;
+    return overflows(a_, b_, r_) ? std::nullopt : std::optional<T>(r_);
+  }
+};
+
+struct checked_minus {
+  template <checked_integral T>
+  static constexpr bool overflows(T a_, T b_, T & r_) noexcept { return __builtin_sub_overflow(a_, b_, &r_); }
+
+  template <checked_integral T>
+  static constexpr T saturate(T, T b_) noexcept {
+    if constexpr (T(-1) < T(0)) {
+      if (b_ < 0) {
+        return std::numeric_limits<T>::max();
+      }
+    }
+    return std::numeric_limits<T>::min();
+  }
+
+  template <checked_integral T>
+  constexpr std::optional<T> operator()(T a_, T b_) const noexcept {
+    T r_;
+    return overflows(a_, b_, r_) ? std::nullopt : std::optional<T>(r_);
+  }
+};
+
+struct checked_multiplies {
+  template <checked_integral T>
+  static constexpr bool overflows(T a_, T b_, T & r_) noexcept { return __builtin_mul_overflow(a_, b_, &r_); }
+
+  template <checked_integral T>
+  static constexpr T saturate(T a_, T b_) noexcept {
+    if constexpr (T(-1) < T(0)) {
+      if ((a_ < 0) != (b_ < 0)) {
+        return std::numeric_limits<T>::min();
+      }
+    }
+    return std::numeric_limits<T>::max();
+  }
+
+  template <checked_integral T>
+  constexpr std::optional<T> operator()(T a_, T b_) const noexcept {
+    T r_;
+    return overflows(a_, b_, r_) ? std::nullopt : std::optional<T>(r_);
+  }
+};
+
+template <typename Op, typename T>
+concept overflow_op = checked_integral<T> && requires(T a_, T & r_) {
+  { Op::overflows(a_, a_, r_) } -> std::same_as<bool>;
+  { Op::saturate(a_, a_) } -> std::same_as<T>;
+};
+
+/*
+ *  MARK: saturating<Op>
+ *
+ *  The same operation clamped to the range of T, as an ordinary binary function
+ *  object (so it also drops into std::accumulate and friends).
+ */
+template <typename Op>
+struct saturating {
+  template <checked_integral T>
+    requires overflow_op<Op, T>
+  constexpr T operator()(T a_, T b_) const noexcept {
+    T r_;
+    return Op::overflows(a_, b_, r_) ? Op::saturate(a_, b_) : r_;
+  }
+};
+
+using saturating_plus = saturating<checked_plus>;
+using saturating_minus = saturating<checked_minus>;
+using saturating_multiplies = saturating<checked_multiplies>;
+
+/*
+ *  MARK: fold_result, scan_result
+ *
+ *  `index` is the position of the first element whose step overflowed, or the
+ *  number of elements folded when none did (as with cfnum::lcm on spans).
+ *  A checked fold stops there and `value` is the last result that fitted; a
+ *  saturating fold carries on from the clamped value.  Tests true without overflow.
+ */
+template <typename T>
+struct fold_result {
+  T value;
+  std::size_t index = 0;
+  bool overflow = false;
+
+  explicit operator bool() const noexcept { return !overflow; }
+};
+
+template <typename OutputIt, typename T>
+struct scan_result : fold_result<T> {
+  OutputIt out;                         //  one past the last element written
+};
+
+/*
+ *  MARK: widening
+ *
+ *  int32 -> int64 -> __int128 (and the unsigned ladder).  A widening fold runs in
+ *  T until a step overflows, then redoes that step one size up, and so on; the
+ *  narrow prefix costs no more than the checked fold.
+ */
+template <typename T> struct wider { using type = void; };
+template <> struct wider<signed char> { using type = short; };
+template <> struct wider<short> { using type = int; };
+template <> struct wider<int> { using type = std::int64_t; };
+template <> struct wider<long> { using type = __int128; };
+template <> struct wider<long long> { using type = __int128; };
+template <> struct wider<unsigned char> { using type = unsigned short; };
+template <> struct wider<unsigned short> { using type = unsigned; };
+template <> struct wider<unsigned> { using type = std::uint64_t; };
+template <> struct wider<unsigned long> { using type = unsigned __int128; };
+template <> struct wider<unsigned long long> { using type = unsigned __int128; };
+
+template <typename T>
+using wider_t = typename wider<T>::type;
+
+template <typename T, typename W = wider_t<T>>
+struct widest { using type = typename widest<W>::type; };
+template <typename T>
+struct widest<T, void> { using type = T; };
+
+template <typename T>
+using widest_t = typename widest<T>::type;
+
+//  `value` is held in the widest type; `bits` is the width of the type that held
+//  the final result and `widened_at` the first index that did not fit in T (the
+//  count when all did).  `overflow` is set only if even the widest type overflowed.
+template <typename T>
+struct widening_result : fold_result<widest_t<T>> {
+  std::size_t widened_at = 0;
+  int bits = 0;
+};
+
+namespace detail {
+
+//  Block size of the fast summation path.
+inline constexpr std::size_t checked_block = 4'096;
+
+template <typename It, typename T, typename Op>
+concept block_summable = std::contiguous_iterator<It> && std::same_as<Op, checked_plus>
+                      && (std::same_as<T, std::int32_t> || std::same_as<T, std::uint32_t>)
+                      && std::same_as<std::iter_value_t<It>, T>;
+
+//  Wrapping sum and largest magnitude of a block, as 32-bit lanes.
+template <std::size_t Bytes, bool Signed>
+[[gnu::always_inline]] inline void sum_bound_kernel(std::uint32_t const * p_, std::size_t n_,
+                                                    std::uint32_t & sum, std::uint32_t & peak) noexcept {
+  using V = typename simd::detail::vec<std::uint32_t, Bytes>::type;
+  constexpr std::size_t L = simd::detail::vec<std::uint32_t, Bytes>::lanes;
+  V s0 {}, s1 {}, m0 {}, m1 {};
+  V x0, x1;
+  std::size_t i_ = 0;
+  for (; i_ + 2 * L <= n_; i_ += 2 * L) {
+    simd::detail::load(x0, p_ + i_);
+    simd::detail::load(x1, p_ + i_ + L);
+    s0 += x0;
+    s1 += x1;
+    simd::detail::magnitude_lanes<Signed, V, std::uint32_t>(x0);
+    simd::detail::magnitude_lanes<Signed, V, std::uint32_t>(x1);
+    m0 = m0 > x0 ? m0 : x0;
+    m1 = m1 > x1 ? m1 : x1;
+  }
+  s0 += s1;
+  m0 = m0 > m1 ? m0 : m1;
+  sum = 0;
+  peak = 0;
+  for (std::size_t l_ = 0; l_ < L; ++l_) {
+    sum += s0[l_];
+    peak = std::max(peak, std::uint32_t(m0[l_]));
+  }
+  for (; i_ < n_; ++i_) {
+    std::uint32_t const x_ = p_[i_];
+    std::uint32_t const t_ = Signed ? x_ >> 31 : 0;
+    sum += x_;
+    peak = std::max(peak, (x_ ^ (0U - t_)) + t_);
+  }
+}
+
+template <bool Signed>
+inline void sum_bound_scalar(std::uint32_t const * p_, std::size_t n_, std::uint32_t & sum, std::uint32_t & peak) noexcept {
+  sum = 0;
+  peak = 0;
+  for (std::size_t i_ = 0; i_ < n_; ++i_) {
+    std::uint32_t const x_ = p_[i_];
+    std::uint32_t const t_ = Signed ? x_ >> 31 : 0;
+    sum += x_;
+    peak = std::max(peak, (x_ ^ (0U - t_)) + t_);
+  }
+}
+
+#if defined(CFNUM_SIMD_X86)
+template <bool Signed>
+[[gnu::target("avx512f,avx512dq")]] void sum_bound_avx512(std::uint32_t const * p_, std::size_t n_,
+                                                          std::uint32_t & sum, std::uint32_t & peak) noexcept {
+  sum_bound_kernel<64, Signed>(p_, n_, sum, peak);
+}
+
+template <bool Signed>
+[[gnu::target("avx2,fma")]] void sum_bound_avx2(std::uint32_t const * p_, std::size_t n_,
+                                                std::uint32_t & sum, std::uint32_t & peak) noexcept {
+  sum_bound_kernel<32, Signed>(p_, n_, sum, peak);
+}
+#endif
+
+/*
+ *  True (and acc += the block) when no partial sum of the block can leave the
+ *  range of T: |acc| + m * max |x| <= max T.  The block sum is then exact modulo
+ *  2^32 and so exact.  Otherwise the caller steps through the block.
+ */
+template <typename T>
+inline bool add_block(T & acc, T const * p_, std::size_t n_) noexcept {
+  constexpr bool Signed = std::is_signed_v<T>;
+  auto const * u_ = reinterpret_cast<std::uint32_t const *>(p_);
+  std::uint32_t sum, peak;
+  switch (simd::active_isa()) {
+#if defined(CFNUM_SIMD_X86)
+    case simd::isa::avx512: sum_bound_avx512<Signed>(u_, n_, sum, peak); break;
+    case simd::isa::avx2:   sum_bound_avx2<Signed>(u_, n_, sum, peak); break;
+    case simd::isa::sse2:   sum_bound_kernel<16, Signed>(u_, n_, sum, peak); break;
+#elif defined(CFNUM_SIMD_NEON)
+    case simd::isa::neon:   sum_bound_kernel<16, Signed>(u_, n_, sum, peak); break;
+#endif
+    default:                sum_bound_scalar<Signed>(u_, n_, sum, peak); break;
+  }
+  std::int64_t room = std::int64_t(std::numeric_limits<T>::max()) - std::int64_t(acc);
+  if constexpr (Signed) {
+    room = acc < 0 ? std::int64_t(std::numeric_limits<T>::max()) + acc : room;
+  }
+  if (std::int64_t(peak) * std::int64_t(n_) > room) {
+    return false;
+  }
+  acc = T(std::uint32_t(acc) + sum);
+  return true;
+}
+
+template <typename T, typename It, typename Op>
+inline fold_result<T> checked_steps(It first, It last, T acc, std::size_t i_, Op) {
+  for (; first != last; ++first, ++i_) {
+    T r_;
+    if (Op::overflows(acc, T(*first), r_)) [[unlikely]] {
+      return { acc, i_, true };
+    }
+    acc = r_;
+  }
+  return { acc, i_, false };
+}
+
+/*
+ *  The widening engine: `step(acc, it, out)` folds *it into acc in whatever type
+ *  acc has and reports overflow; `sink(acc)` sees every accepted partial result.
+ *  W climbs the ladder up to Top.
+ */
+template <typename W, typename Top, typename T, typename It, typename Step, typename Sink>
+inline void widen(It first, It last, W acc, std::size_t i_, Step & step, Sink & sink, widening_result<T> & r_) {
+  for (; first != last; ++first, ++i_) {
+    W n_;
+    if (step(acc, first, n_)) [[unlikely]] {
+      if constexpr (!std::is_void_v<wider_t<W>> && sizeof(W) < sizeof(Top)) {
+        r_.widened_at = std::min(r_.widened_at, i_);
+        return widen<wider_t<W>, Top>(first, last, wider_t<W>(acc), i_, step, sink, r_);
+      }
+      else {
+        r_.widened_at = std::min(r_.widened_at, i_);
+        r_.value = acc;
+        r_.index = i_;
+        r_.overflow = true;
+        r_.bits = int(8 * sizeof(W));
+        return;
+      }
+    }
+    acc = n_;
+    sink(acc);
+  }
+  r_.widened_at = std::min(r_.widened_at, i_);
+  r_.value = acc;
+  r_.index = i_;
+  r_.bits = int(8 * sizeof(W));
+}
+
+} /* namespace detail */
+
+/*
+ *  MARK: checked_accumulate(), saturating_accumulate(), widening_accumulate()
+ *
+ *  Left folds of [first, last) into init with an overflow_op (checked_plus by
+ *  default).  Elements are converted to T first, as std::accumulate does.
+ *  Sums of contiguous 32-bit data take a blocked path: a block whose magnitude
+ *  bound proves no partial sum can overflow is added by a vector kernel, and only
+ *  a block that might overflow is stepped through to find the index.
+ */
+template <std::input_iterator It, std::integral T, typename Op = checked_plus>
+  requires overflow_op<Op, T>
+inline fold_result<T> checked_accumulate(It first, It last, T init, Op op = {}) {
+  if constexpr (detail::block_summable<It, T, Op>) {
+    T const * p_ = std::to_address(first);
+    std::size_t const n_ = static_cast<std::size_t>(last - first);
+    for (std::size_t b_ = 0; b_ < n_; b_ += detail::checked_block) {
+      std::size_t const m_ = std::min(detail::checked_block, n_ - b_);
+      if (!detail::add_block(init, p_ + b_, m_)) {
+        auto const r_ = detail::checked_steps(p_ + b_, p_ + b_ + m_, init, b_, op);
+        if (r_.overflow) {
+          return r_;
+        }
+        init = r_.value;
+      }
+    }
+    return { init, n_, false };
+  }
+  else {
+    return detail::checked_steps(first, last, init, 0, op);
+  }
+}
+
+//  Every step is clamped to the range of T; `index` is the first step that was.
+template <std::input_iterator It, std::integral T, typename Op = checked_plus>
+  requires overflow_op<Op, T>
+inline fold_result<T> saturating_accumulate(It first, It last, T init, Op = {}) {
+  std::size_t clamped = std::numeric_limits<std::size_t>::max();
+  auto step = [&](T x_, std::size_t i_) {
+    T r_;
+    if (Op::overflows(init, x_, r_)) [[unlikely]] {
+      r_ = Op::saturate(init, x_);
+      clamped = std::min(clamped, i_);
+    }
+    init = r_;
+  };
+  std::size_t n_ = 0;
+  if constexpr (detail::block_summable<It, T, Op>) {
+    T const * p_ = std::to_address(first);
+    n_ = static_cast<std::size_t>(last - first);
+    for (std::size_t b_ = 0; b_ < n_; b_ += detail::checked_block) {
+      std::size_t const m_ = std::min(detail::checked_block, n_ - b_);
+      if (!detail::add_block(init, p_ + b_, m_)) {
+        for (std::size_t i_ = b_; i_ < b_ + m_; ++i_) {
+          step(p_[i_], i_);
+        }
+      }
+    }
+  }
+  else {
+    for (; first != last; ++first, ++n_) {
+      step(T(*first), n_);
+    }
+  }
+  bool const overflow = clamped != std::numeric_limits<std::size_t>::max();
+  return { init, overflow ? clamped : n_, overflow };
+}
+
+//  Overflow moves the fold up the int32 -> int64 -> __int128 ladder instead of
+//  failing; the narrow prefix goes through checked_accumulate, blocked path and all.
+template <std::forward_iterator It, std::integral T, typename Op = checked_plus>
+  requires overflow_op<Op, T>
+inline widening_result<T> widening_accumulate(It first, It last, T init, Op op = {}) {
+  widening_result<T> r_;
+  auto const narrow = checked_accumulate(first, last, init, op);
+  r_.widened_at = narrow.index;
+  if (!narrow.overflow) {
+    r_.value = narrow.value;
+    r_.index = narrow.index;
+    r_.bits = int(8 * sizeof(T));
+    return r_;
+  }
+  auto step = [](auto acc, It it_, auto & out) {
+    using W = decltype(acc);
+    return Op::overflows(acc, W(*it_), out);
+  };
+  auto sink = [](auto) {};
+  if constexpr (std::is_void_v<wider_t<T>>) {
+    r_.value = narrow.value;
+    r_.index = narrow.index;
+    r_.overflow = true;
+    r_.bits = int(8 * sizeof(T));
+  }
+  else {
+    detail::widen<wider_t<T>, widest_t<T>>(std::next(first, narrow.index), last, wider_t<T>(narrow.value),
+                                          narrow.index, step, sink, r_);
+  }
+  return r_;
+}
+
+/*
+ *  MARK: checked_partial_sum(), saturating_partial_sum(), widening_partial_sum()
+ *
+ *  std::partial_sum with an overflow_op (checked_plus by default), accumulating
+ *  in the input value type.  The checked scan writes results up to, not
+ *  including, `index` and stops; the saturating scan writes all of them.
+ */
+template <std::input_iterator It, typename OutputIt, typename Op = checked_plus>
+  requires overflow_op<Op, std::iter_value_t<It>>
+inline scan_result<OutputIt, std::iter_value_t<It>> checked_partial_sum(It first, It last, OutputIt d_first, Op = {}) {
+  using T = std::iter_value_t<It>;
+  if (first == last) {
+    return { { T(), 0, false }, d_first };
+  }
+  T acc = *first;
+  *d_first = acc;
+  ++d_first;
+  std::size_t i_ = 1;
+  for (++first; first != last; ++first, ++i_) {
+    T r_;
+    if (Op::overflows(acc, T(*first), r_)) [[unlikely]] {
+      return { { acc, i_, true }, d_first };
+    }
+    acc = r_;
+    *d_first = acc;
+    ++d_first;
+  }
+  return { { acc, i_, false }, d_first };
+}
+
+template <std::input_iterator It, typename OutputIt, typename Op = checked_plus>
+  requires overflow_op<Op, std::iter_value_t<It>>
+inline scan_result<OutputIt, std::iter_value_t<It>> saturating_partial_sum(It first, It last, OutputIt d_first, Op = {}) {
+  using T = std::iter_value_t<It>;
+  if (first == last) {
+    return { { T(), 0, false }, d_first };
+  }
+  std::size_t clamped = std::numeric_limits<std::size_t>::max();
+  T acc = *first;
+  *d_first = acc;
+  ++d_first;
+  std::size_t i_ = 1;
+  for (++first; first != last; ++first, ++i_) {
+    T const x_ = *first;
+    T r_;
+    if (Op::overflows(acc, x_, r_)) [[unlikely]] {
+      r_ = Op::saturate(acc, x_);
+      clamped = std::min(clamped, i_);
+    }
+    acc = r_;
+    *d_first = acc;
+    ++d_first;
+  }
+  bool const overflow = clamped != std::numeric_limits<std::size_t>::max();
+  return { { acc, overflow ? clamped : i_, overflow }, d_first };
+}
+
+//  Scans into a wider output (e.g. uint64_t factors into unsigned __int128
+//  results): each partial result is formed in the narrowest type of the ladder
+//  that holds it, up to the output value type, and `index` reports overflow of that.
+template <std::input_iterator It, std::forward_iterator OutputIt, typename Op = checked_plus>
+  requires overflow_op<Op, std::iter_value_t<It>>
+        && (sizeof(std::iter_value_t<OutputIt>) >= sizeof(std::iter_value_t<It>))
+inline widening_result<std::iter_value_t<It>> widening_partial_sum(It first, It last, OutputIt d_first, Op = {}) {
+  using T = std::iter_value_t<It>;
+  using O = std::iter_value_t<OutputIt>;
+  widening_result<T> r_;
+  r_.widened_at = std::numeric_limits<std::size_t>::max();
+  if (first == last) {
+    r_.value = T();
+    r_.widened_at = 0;
+    r_.bits = int(8 * sizeof(T));
+    return r_;
+  }
+  auto step = [](auto acc, It it_, auto & out) {
+    using W = decltype(acc);
+    return Op::overflows(acc, W(*it_), out);
+  };
+  auto sink = [&d_first](auto acc) {
+    *d_first = static_cast<O>(acc);
+    ++d_first;
+  };
+  T const acc = *first;
+  sink(acc);
+  detail::widen<T, O>(std::next(first), last, acc, 1, step, sink, r_);
+  return r_;
+}
+
+/*
+ *  MARK: checked_inner_product(), saturating_inner_product(), widening_inner_product()
+ *
+ *  init + sum a[i] * b[i] with both operations checked; `index` is the first pair
+ *  whose product or running sum overflowed.  Two flag tests per element, no
+ *  extra pass.
+ */
+template <std::input_iterator It1, std::input_iterator It2, std::integral T,
+          typename Add = checked_plus, typename Mul = checked_multiplies>
+  requires overflow_op<Add, T> && overflow_op<Mul, T>
+inline fold_result<T> checked_inner_product(It1 first1, It1 last1, It2 first2, T init, Add = {}, Mul = {}) {
+  std::size_t i_ = 0;
+  for (; first1 != last1; ++first1, ++first2, ++i_) {
+    T p_, r_;
+    if (Mul::overflows(T(*first1), T(*first2), p_) || Add::overflows(init, p_, r_)) [[unlikely]] {
+      return { init, i_, true };
+    }
+    init = r_;
+  }
+  return { init, i_, false };
+}
+
+template <std::input_iterator It1, std::input_iterator It2, std::integral T,
+          typename Add = checked_plus, typename Mul = checked_multiplies>
+  requires overflow_op<Add, T> && overflow_op<Mul, T>
+inline fold_result<T> saturating_inner_product(It1 first1, It1 last1, It2 first2, T init, Add = {}, Mul = {}) {
+  std::size_t clamped = std::numeric_limits<std::size_t>::max();
+  std::size_t i_ = 0;
+  for (; first1 != last1; ++first1, ++first2, ++i_) {
+    T const a_ = T(*first1);
+    T const b_ = T(*first2);
+    T p_, r_;
+    bool over = false;
+    if (Mul::overflows(a_, b_, p_)) [[unlikely]] {
+      p_ = Mul::saturate(a_, b_);
+      over = true;
+    }
+    if (Add::overflows(init, p_, r_)) [[unlikely]] {
+      r_ = Add::saturate(init, p_);
+      over = true;
+    }
+    clamped = over ? std::min(clamped, i_) : clamped;
+    init = r_;
+  }
+  bool const overflow = clamped != std::numeric_limits<std::size_t>::max();
+  return { init, overflow ? clamped : i_, overflow };
+}
+
+//  Products that overflow T are formed one size up, so int32 data never fails
+//  below __int128.
+template <std::input_iterator It1, std::input_iterator It2, std::integral T,
+          typename Add = checked_plus, typename Mul = checked_multiplies>
+  requires overflow_op<Add, T> && overflow_op<Mul, T>
+inline widening_result<T> widening_inner_product(It1 first1, It1 last1, It2 first2, T init, Add = {}, Mul = {}) {
+  widening_result<T> r_;
+  r_.widened_at = std::numeric_limits<std::size_t>::max();
+  auto step = [&first2](auto acc, It1 it_, auto & out) {
+    using W = decltype(acc);
+    W p_;
+    return Mul::overflows(W(*it_), W(*first2), p_) || Add::overflows(acc, p_, out);
+  };
+  auto sink = [&first2](auto) { ++first2; };
+  detail::widen<T, widest_t<T>>(first1, last1, init, 0, step, sink, r_);
+  return r_;
+}
+
+} /* namespace cfnum */
+
+#endif /* checked_numeric_hpp */
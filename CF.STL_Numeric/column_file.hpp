@@ -0,0 +1,220 @@
+//
+//  column_file.hpp
+//  CF.STL_Numeric
+//
+//  MARK: - References.
+//  @see: https://arrow.apache.org/docs/format/Columnar.html (64-byte aligned buffers)
+//  @see: https://numpy.org/doc/stable/reference/generated/numpy.lib.format.html
+//
+
+#ifndef column_file_hpp
+#define column_file_hpp
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "mapped_file.hpp"
+
+namespace cfnum {
+
+/*
+ *  MARK: dtype
+ *
+ *  Element type tag stored in a column file.  Only fixed-width arithmetic types
+ *  are allowed, so a file written on one build maps directly on another with the
+ *  same byte order.
+ */
+enum class dtype : std::uint32_t {
+  unknown = 0,
+  i8, u8, i16, u16, i32, u32, i64, u64,
+  f32, f64,
+};
+
+template <typename T> inline constexpr dtype dtype_of = dtype::unknown;
+template <> inline constexpr dtype dtype_of<std::int8_t>   = dtype::i8;
+template <> inline constexpr dtype dtype_of<std::uint8_t>  = dtype::u8;
+template <> inline constexpr dtype dtype_of<std::int16_t>  = dtype::i16;
+template <> inline constexpr dtype dtype_of<std::uint16_t> = dtype::u16;
+template <> inline constexpr dtype dtype_of<std::int32_t>  = dtype::i32;
+template <> inline constexpr dtype dtype_of<std::uint32_t> = dtype::u32;
+template <> inline constexpr dtype dtype_of<std::int64_t>  = dtype::i64;
+template <> inline constexpr dtype dtype_of<std::uint64_t> = dtype::u64;
+template <> inline constexpr dtype dtype_of<float>         = dtype::f32;
+template <> inline constexpr dtype dtype_of<double>        = dtype::f64;
+
+template <typename T>
+concept column_type = dtype_of<T> != dtype::unknown;
+
+constexpr std::string_view dtype_name(dtype d_) noexcept {
+  constexpr std::array<std::string_view, 11> names {
+    "unknown", "i8", "u8", "i16", "u16", "i32", "u32", "i64", "u64", "f32", "f64",
+  };
+  auto const i_ = static_cast<std::size_t>(d_);
+  return i_ < names.size() ? names[i_] : names[0];
+}
+
+/*
+ *  MARK: column_header
+ *
+ *  Fixed 64-byte header, then the payload at `offset` (a multiple of `alignment`,
+ *  itself at least 64).  mmap returns page-aligned memory, so the mapped payload
+ *  is cache-line aligned and the SIMD kernels see aligned loads.
+ */
+struct column_header {
+  static constexpr std::array<char, 8> signature { 'C', 'F', 'N', 'U', 'M', 'C', 'O', 'L', };
+  static constexpr std::uint32_t current_version = 1;
+  static constexpr std::uint32_t default_alignment = 64;
+
+  std::array<char, 8> magic = signature;
+  std::uint32_t version = current_version;
+  dtype type = dtype::unknown;
+  std::uint32_t element_size = 0;
+  std::uint32_t alignment = default_alignment;
+  std::uint64_t count = 0;
+  std::uint64_t offset = default_alignment;     //  payload start, from the beginning of the file
+  std::array<std::byte, 24> reserved {};
+
+  bool valid(std::size_t file_size) const noexcept {
+    return magic == signature && version == current_version
+        && alignment >= default_alignment && (alignment & (alignment - 1)) == 0
+        && offset >= sizeof(column_header) && offset % alignment == 0
+        && element_size != 0 && offset <= file_size
+        && count <= (file_size - offset) / element_size;
+  }
+};
+static_assert(sizeof(column_header) == column_header::default_alignment);
+
+/*
+ *  MARK: column_reader
+ *
+ *  Maps a column file read-only; values() is a zero-copy view of the payload.
+ *  Tests false if the file is missing, truncated, or holds another dtype.
+ */
+template <column_type T>
+class column_reader {
+public:
+  column_reader() = default;
+
+  explicit column_reader(std::string const & path,
+                         mapped_file::advice hint = mapped_file::advice::sequential) {
+    open(path, hint);
+  }
+
+  bool open(std::string const & path, mapped_file::advice hint = mapped_file::advice::sequential) {
+    values_ = {};
+    if (!map_.open(path) || map_.size() < sizeof(column_header)) {
+      map_.close();
+      return false;
+    }
+    std::memcpy(&header_, map_.data(), sizeof(column_header));
+    if (!header_.valid(map_.size()) || header_.type != dtype_of<T> || header_.element_size != sizeof(T)) {
+      map_.close();
+      return false;
+    }
+    values_ = { reinterpret_cast<T const *>(map_.data() + header_.offset), header_.count };
+    advise(hint);
+    return true;
+  }
+
+  //  madvise hint over the payload, e.g. random for gathers or huge_pages for
+  //  repeated passes over a large column.
+  void advise(mapped_file::advice hint) const noexcept {
+    map_.advise(hint, header_.offset, values_.size_bytes());
+  }
+
+  explicit operator bool() const noexcept { return static_cast<bool>(map_); }
+
+  column_header const & header() const noexcept { return header_; }
+  std::span<T const> values() const noexcept { return values_; }
+  std::size_t size() const noexcept { return values_.size(); }
+
+private:
+  mapped_file map_;
+  column_header header_;
+  std::span<T const> values_;
+};
+
+/*
+ *  MARK: column_writer
+ *
+ *  Creates a column file of `count` elements and maps it read-write, so results
+ *  can be produced straight into values() (e.g. as the d_first of a scan).
+ *  The payload is zero-filled until written; commit() flushes it to disk.
+ */
+template <column_type T>
+class column_writer {
+public:
+  column_writer() = default;
+
+  column_writer(std::string const & path, std::size_t count,
+                std::uint32_t alignment = column_header::default_alignment) {
+    open(path, count, alignment);
+  }
+
+  bool open(std::string const & path, std::size_t count,
+            std::uint32_t alignment = column_header::default_alignment) {
+    values_ = {};
+    header_ = {};
+    header_.type = dtype_of<T>;
+    header_.element_size = sizeof(T);
+    header_.alignment = alignment;
+    header_.count = count;
+    header_.offset = alignment < sizeof(column_header) ? sizeof(column_header) : alignment;
+    if (!header_.valid(header_.offset + count * sizeof(T))
+        || !map_.open(path, mapped_file::mode::read_write, header_.offset + count * sizeof(T))) {
+      return false;
+    }
+    std::memcpy(map_.mutable_data(), &header_, sizeof(column_header));
+    values_ = { reinterpret_cast<T *>(map_.mutable_data() + header_.offset), count };
+    return true;
+  }
+
+  bool commit() noexcept { return map_ && map_.sync(); }
+
+  void advise(mapped_file::advice hint) const noexcept {
+    map_.advise(hint, header_.offset, values_.size_bytes());
+  }
+
+  explicit operator bool() const noexcept { return static_cast<bool>(map_); }
+
+  column_header const & header() const noexcept { return header_; }
+  std::span<T> values() noexcept { return values_; }
+  std::size_t size() const noexcept { return values_.size(); }
+
+private:
+  mapped_file map_;
+  column_header header_;
+  std::span<T> values_;
+};
+
+/*
+ *  MARK: write_column(), read_column()
+ *
+ *  One-call helpers.  read_column returns an empty reader (testing false) on error.
+ */
+template <column_type T>
+bool write_column(std::string const & path, std::span<T const> values) {
+  column_writer<T> out(path, values.size());
+  if (!out) {
+    return false;
+  }
+  if (!values.empty()) {
+    std::memcpy(out.values().data(), values.data(), values.size_bytes());
+  }
+  return out.commit();
+}
+
+template <column_type T>
+column_reader<T> read_column(std::string const & path,
+                             mapped_file::advice hint = mapped_file::advice::sequential) {
+  return column_reader<T>(path, hint);
+}
+
+} /* namespace cfnum */
+
+#endif /* column_file_hpp */
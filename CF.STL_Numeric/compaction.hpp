@@ -0,0 +1,391 @@
+//
+//  compaction.hpp
+//  CF.STL_Numeric
+//
+//  MARK: - References.
+//  @see: https://en.cppreference.com/w/cpp/algorithm/remove
+//  @see: https://en.cppreference.com/w/cpp/container/vector/erase2 (std::erase_if)
+//  @see: Intel SDM, VPCOMPRESSD / VCOMPRESSPS (AVX-512 compress-store)
+//
+
+#ifndef compaction_hpp
+#define compaction_hpp
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "thread_pool.hpp"
+#include "parallel_reduce.hpp"
+#include "simd_kernels.hpp"
+
+namespace cfnum {
+
+//  Below this many elements per chunk the extra pass over the chunk totals costs more than it saves.
+inline constexpr std::size_t compact_grain = 65'536;
+
+namespace detail {
+
+//  Sum type for a mean that cannot overflow: int32 in int64, float in double,
+//  int64 in __int128.
+template <typename T>
+struct mean_sum { using type = double; };
+
+template <>
+struct mean_sum<std::int32_t> { using type = std::int64_t; };
+
+template <>
+struct mean_sum<std::int64_t> { using type = __int128; };
+
+template <typename T>
+using mean_sum_t = typename mean_sum<T>::type;
+
+//  Each half-width load is widened lane for lane (vpmovsxdq, vcvtps2pd) before
+//  it is added; two accumulators are enough to keep the conversions busy.
+template <std::size_t Bytes, typename T, typename S>
+[[gnu::always_inline]] inline S wide_sum_kernel(T const * p_, std::size_t n_) noexcept {
+  using W = typename simd::detail::vec<S, Bytes>::type;
+  constexpr std::size_t L = simd::detail::vec<S, Bytes>::lanes;
+  using N = typename simd::detail::vec<T, L * sizeof(T)>::type;
+  W a0 {}, a1 {};
+  N x0, x1;
+  std::size_t i_ = 0;
+  for (; i_ + 2 * L <= n_; i_ += 2 * L) {
+    simd::detail::load(x0, p_ + i_);
+    simd::detail::load(x1, p_ + i_ + L);
+    a0 += __builtin_convertvector(x0, W);
+    a1 += __builtin_convertvector(x1, W);
+  }
+  a0 += a1;
+  S r_ {};
+  for (std::size_t l_ = 0; l_ < L; ++l_) {
+    r_ += a0[l_];
+  }
+  for (; i_ < n_; ++i_) {
+    r_ += S(p_[i_]);
+  }
+  return r_;
+}
+
+template <typename T, typename S>
+inline S wide_sum_scalar(T const * p_, std::size_t n_) noexcept {
+  S r_ {};
+  for (std::size_t i_ = 0; i_ < n_; ++i_) {
+    r_ += S(p_[i_]);
+  }
+  return r_;
+}
+
+#if defined(CFNUM_SIMD_X86)
+template <typename T, typename S>
+[[gnu::target("avx512f,avx512dq")]] S wide_sum_avx512(T const * p_, std::size_t n_) noexcept {
+  return wide_sum_kernel<64, T, S>(p_, n_);
+}
+
+template <typename T, typename S>
+[[gnu::target("avx2,fma")]] S wide_sum_avx2(T const * p_, std::size_t n_) noexcept {
+  return wide_sum_kernel<32, T, S>(p_, n_);
+}
+#endif
+
+template <simd::kernel_type T>
+inline mean_sum_t<T> wide_sum(std::span<T const> s_) noexcept {
+  using S = mean_sum_t<T>;
+  if constexpr (std::is_same_v<S, __int128>) {
+    return wide_sum_scalar<T, S>(s_.data(), s_.size());
+  }
+  else {
+    switch (simd::active_isa()) {
+#if defined(CFNUM_SIMD_X86)
+      case simd::isa::avx512: return wide_sum_avx512<T, S>(s_.data(), s_.size());
+      case simd::isa::avx2:   return wide_sum_avx2<T, S>(s_.data(), s_.size());
+      case simd::isa::sse2:   return wide_sum_kernel<16, T, S>(s_.data(), s_.size());
+#elif defined(CFNUM_SIMD_NEON)
+      case simd::isa::neon:   return wide_sum_kernel<16, T, S>(s_.data(), s_.size());
+#endif
+      default:                return wide_sum_scalar<T, S>(s_.data(), s_.size());
+    }
+  }
+}
+
+//  The T with (x < t) == (x < m) for every T x, so the filter compares in T and
+//  never converts an element: ceil(m) for integers (clamped below to the range of
+//  T), the smallest T >= m for floating point.  A NaN m stays NaN and keeps
+//  everything; std::nullopt when m is above every T, so nothing is kept.
+template <simd::kernel_type T>
+inline std::optional<T> below_bound(double m_) noexcept {
+  if constexpr (std::floating_point<T>) {
+    T t_ = static_cast<T>(m_);
+    if (static_cast<double>(t_) < m_) {
+      t_ = std::nextafter(t_, std::numeric_limits<T>::infinity());
+    }
+    return t_;
+  }
+  else {
+    double const c_ = std::ceil(m_);
+    if (!(c_ > static_cast<double>(std::numeric_limits<T>::min()))) {
+      return std::numeric_limits<T>::min();
+    }
+    //  2^digits is max + 1, exact in double where max itself may round up to it.
+    if (c_ >= std::ldexp(1.0, std::numeric_limits<T>::digits)) {
+      return std::nullopt;
+    }
+    return static_cast<T>(c_);
+  }
+}
+
+//  Stable and branch-free: every element is stored, the cursor only moves past the
+//  kept ones.  out_ may equal in_ (it never overtakes the read position).
+template <typename T>
+inline std::size_t keep_at_least_scalar(T const * in_, std::size_t n_, T t_, T * out_) noexcept {
+  std::size_t k_ = 0;
+  for (std::size_t i_ = 0; i_ < n_; ++i_) {
+    T const x_ = in_[i_];
+    out_[k_] = x_;
+    k_ += !(x_ < t_);
+  }
+  return k_;
+}
+
+//  One compare into a mask register and one compress-store per vector.  The
+//  predicate is "not less than" (_CMP_NLT_UQ for floating point) so NaNs are
+//  kept, as in the scalar loop; quiet, so NaNs raise no invalid exception.
+#if defined(CFNUM_SIMD_X86)
+template <typename T>
+[[gnu::target("avx512f")]] std::size_t keep_at_least_avx512(T const * in_, std::size_t n_, T t_, T * out_) noexcept {
+  using V = typename simd::detail::vec<T, 64>::type;
+  constexpr std::size_t L = simd::detail::vec<T, 64>::lanes;
+  V const tv = V {} + t_;
+  V x_;
+  std::size_t k_ = 0;
+  std::size_t i_ = 0;
+  for (; i_ + L <= n_; i_ += L) {
+    simd::detail::load(x_, in_ + i_);
+    unsigned m_ = 0;
+    if constexpr (std::is_same_v<T, std::int32_t>) {
+      auto const k16 = __builtin_ia32_cmpd512_mask(x_, tv, 5, 0xFFFF);
+      __builtin_ia32_compressstoresi512_mask(reinterpret_cast<V *>(out_ + k_), x_, k16);
+      m_ = k16;
+    }
+    else if constexpr (std::is_same_v<T, std::int64_t>) {
+      typedef long long Q __attribute__((vector_size(64)));
+      auto const k8 = __builtin_ia32_cmpq512_mask(Q(x_), Q(tv), 5, 0xFF);
+      __builtin_ia32_compressstoredi512_mask(reinterpret_cast<Q *>(out_ + k_), Q(x_), k8);
+      m_ = k8;
+    }
+    else if constexpr (std::is_same_v<T, float>) {
+      auto const k16 = __builtin_ia32_cmpps512_mask(x_, tv, 21, 0xFFFF, 4);
+      __builtin_ia32_compressstoresf512_mask(reinterpret_cast<V *>(out_ + k_), x_, k16);
+      m_ = k16;
+    }
+    else {
+      auto const k8 = __builtin_ia32_cmppd512_mask(x_, tv, 21, 0xFF, 4);
+      __builtin_ia32_compressstoredf512_mask(reinterpret_cast<V *>(out_ + k_), x_, k8);
+      m_ = k8;
+    }
+    k_ += static_cast<std::size_t>(std::popcount(m_));
+  }
+  return k_ + keep_at_least_scalar(in_ + i_, n_ - i_, t_, out_ + k_);
+}
+#endif
+
+//  Only AVX-512 has a compress-store; everywhere else the scalar loop, which has
+//  no branch to mispredict however the kept elements are scattered.
+template <simd::kernel_type T>
+inline std::size_t keep_at_least(T const * in_, std::size_t n_, T t_, T * out_) noexcept {
+  switch (simd::active_isa()) {
+#if defined(CFNUM_SIMD_X86)
+    case simd::isa::avx512: return keep_at_least_avx512(in_, n_, t_, out_);
+#endif
+    default:                return keep_at_least_scalar(in_, n_, t_, out_);
+  }
+}
+
+template <typename It>
+concept compactable = std::contiguous_iterator<It>
+                   && simd::kernel_type<std::iter_value_t<It>>
+                   && !std::is_const_v<std::remove_reference_t<std::iter_reference_t<It>>>;
+
+//  Threshold as the element type: an element-typed threshold is used as is,
+//  any other arithmetic one goes through below_bound().  std::nullopt: every
+//  element is below it.
+template <simd::kernel_type V, typename T>
+inline std::optional<V> as_bound(T const & threshold) noexcept {
+  if constexpr (std::is_same_v<T, V>) {
+    return threshold;
+  }
+  else {
+    return below_bound<V>(static_cast<double>(threshold));
+  }
+}
+
+} /* namespace detail */
+
+/*
+ *  MARK: mean()
+ *
+ *  Arithmetic mean as a double.  Contiguous kernel_type ranges are summed by a
+ *  widening simd kernel in a type that cannot overflow (int32 in int64, float in
+ *  double, int64 in __int128); anything else is summed in double.  NaN for an
+ *  empty range, as 0.0 / 0 would be.
+ */
+template <typename ForwardIt>
+double mean(ForwardIt first, ForwardIt last) {
+  using V = std::iter_value_t<ForwardIt>;
+  if constexpr (std::contiguous_iterator<ForwardIt> && simd::kernel_type<V>) {
+    auto const n_ = static_cast<std::size_t>(std::distance(first, last));
+    auto const s_ = detail::wide_sum(std::span<V const>(std::to_address(first), n_));
+    return static_cast<double>(s_) / static_cast<double>(n_);
+  }
+  else {
+    double s_ = 0.0;
+    std::size_t n_ = 0;
+    for (; first != last; ++first, ++n_) {
+      s_ += static_cast<double>(*first);
+    }
+    return s_ / static_cast<double>(n_);
+  }
+}
+
+template <typename R>
+double mean(R const & r_) {
+  return mean(std::ranges::begin(r_), std::ranges::end(r_));
+}
+
+/*
+ *  MARK: remove_below(), erase_below()
+ *
+ *  std::remove_if(first, last, [&](auto x) { return x < threshold; }) as one
+ *  stable, branch-free pass; contiguous kernel_type ranges compare in the element
+ *  type and compress-store a vector at a time under AVX-512.  remove_below()
+ *  returns the new end (what lies past it is unspecified); erase_below() erases
+ *  the tail and returns how many elements went, like std::erase_if.
+ */
+template <typename ForwardIt, typename T>
+ForwardIt remove_below(ForwardIt first, ForwardIt last, T const & threshold) {
+  if constexpr (detail::compactable<ForwardIt>) {
+    using V = std::iter_value_t<ForwardIt>;
+    auto * p_ = std::to_address(first);
+    auto const n_ = static_cast<std::size_t>(std::distance(first, last));
+    auto const t_ = detail::as_bound<V>(threshold);
+    if (!t_) {
+      return first;
+    }
+    return first + static_cast<std::ptrdiff_t>(detail::keep_at_least(p_, n_, *t_, p_));
+  }
+  else {
+    return std::remove_if(first, last, [&threshold](auto const & x_) { return x_ < threshold; });
+  }
+}
+
+template <typename Container, typename T>
+std::size_t erase_below(Container & c_, T const & threshold) {
+  auto const end_ = remove_below(c_.begin(), c_.end(), threshold);
+  auto const n_ = static_cast<std::size_t>(std::distance(end_, c_.end()));
+  c_.erase(end_, c_.end());
+  return n_;
+}
+
+/*
+ *  MARK: erase_below_mean()
+ *
+ *  The "drop everything below the average" filter in two linear passes, one for
+ *  the mean and one stable compaction, in place of erasing element by element
+ *  (O(n^2) moves).  An empty container has a NaN mean and loses nothing.
+ */
+struct mean_filter_result {
+  double mean = 0.0;
+  std::size_t kept = 0;
+  std::size_t removed = 0;
+};
+
+template <typename Container>
+mean_filter_result erase_below_mean(Container & c_) {
+  double const m_ = mean(c_.begin(), c_.end());
+  std::size_t const removed = erase_below(c_, m_);
+  return { m_, c_.size(), removed };
+}
+
+/*
+ *  MARK: parallel_remove_below(), parallel_erase_below_mean()
+ *
+ *  Chunked on the pool: each chunk sums (for the mean) and then compacts itself in
+ *  place, after which the kept runs are slid down to close the gaps, left to
+ *  right on the calling thread (each run only ever moves towards the front, so the
+ *  serial pass is a plain overlapping move and stays stable).
+ */
+template <simd::kernel_type T, typename U>
+std::size_t parallel_remove_below(thread_pool & pool, std::span<T> s_, U const & threshold,
+                                  std::size_t grain = compact_grain) {
+  std::size_t const n = s_.size();
+  auto const b_ = detail::as_bound<T>(threshold);
+  if (!b_) {
+    return 0;
+  }
+  T const t_ = *b_;
+  std::size_t const chunks = detail::chunk_count(n, pool.size(), grain);
+  if (chunks == 1) {
+    return detail::keep_at_least(s_.data(), n, t_, s_.data());
+  }
+
+  std::vector<detail::padded<std::size_t>> kept(chunks);
+  pool.parallel_for(chunks, [&](std::size_t c_) {
+    std::size_t const lo = n * c_ / chunks;
+    std::size_t const hi = n * (c_ + 1) / chunks;
+    kept[c_].value = detail::keep_at_least(s_.data() + lo, hi - lo, t_, s_.data() + lo);
+  });
+
+  std::size_t k_ = kept[0].value;
+  for (std::size_t c_ = 1; c_ < chunks; ++c_) {
+    T const * from = s_.data() + n * c_ / chunks;
+    std::move(from, from + kept[c_].value, s_.data() + k_);
+    k_ += kept[c_].value;
+  }
+  return k_;
+}
+
+template <typename Container>
+  requires std::contiguous_iterator<typename Container::iterator>
+        && simd::kernel_type<typename Container::value_type>
+mean_filter_result parallel_erase_below_mean(thread_pool & pool, Container & v_,
+                                             std::size_t grain = compact_grain) {
+  using T = typename Container::value_type;
+  using S = detail::mean_sum_t<T>;
+  std::span<T> const s_(v_.data(), v_.size());
+  std::size_t const n = s_.size();
+  std::size_t const chunks = detail::chunk_count(n, pool.size(), grain);
+
+  std::vector<detail::padded<S>> partial(chunks);
+  pool.parallel_for(chunks, [&](std::size_t c_) {
+    std::size_t const lo = n * c_ / chunks;
+    std::size_t const hi = n * (c_ + 1) / chunks;
+    partial[c_].value = detail::wide_sum(std::span<T const>(s_.subspan(lo, hi - lo)));
+  });
+  S sum_ {};
+  for (auto const & p_ : partial) {
+    sum_ += p_.value;
+  }
+  double const m_ = static_cast<double>(sum_) / static_cast<double>(n);
+
+  std::size_t const k_ = parallel_remove_below(pool, s_, m_, grain);
+  v_.erase(v_.begin() + static_cast<std::ptrdiff_t>(k_), v_.end());
+  return { m_, k_, n - k_ };
+}
+
+template <typename Container>
+mean_filter_result parallel_erase_below_mean(Container & c_) {
+  return parallel_erase_below_mean(default_pool(), c_);
+}
+
+} /* namespace cfnum */
+
+#endif /* compaction_hpp */
@@ -0,0 +1,515 @@
+//
+//  delta_codec.hpp
+//  CF.STL_Numeric
+//
+//  MARK: - References.
+//  @see: Lemire & Boytsov, "Decoding billions of integers per second through vectorization" (2015), SIMD-BP128
+//  @see: https://developers.google.com/protocol-buffers/docs/encoding#signed-ints (zigzag)
+//  @see: https://en.wikipedia.org/wiki/Delta_encoding
+//
+
+#ifndef delta_codec_hpp
+#define delta_codec_hpp
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "simd_kernels.hpp"
+#include "simd_scan.hpp"
+
+namespace cfnum {
+
+//  Element types the codec stores: 32- and 64-bit integers.
+template <typename T>
+concept codec_type = std::same_as<T, std::int32_t> || std::same_as<T, std::uint32_t>
+                  || std::same_as<T, std::int64_t> || std::same_as<T, std::uint64_t>;
+
+//  Values per block: four lanes of 32 values, as in SIMD-BP128.
+inline constexpr std::size_t codec_block = 128;
+
+namespace detail {
+
+/*
+ *  Block format.  Value i of a block sits in lane i % 4, and each lane keeps
+ *  the difference to the value four places back (to the block's base for the
+ *  first four), so deltas are taken and undone with whole-vector subtracts and
+ *  adds.  Deltas are zigzag coded, so small negative ones stay small, and
+ *  packed at the block's bit width b: lane l's bits run through words
+ *  4k + l, 4 b words per block.  A block of 64-bit values whose deltas need
+ *  more than 32 bits is stored as is.
+ *
+ *  The format fixes the vector at four 32-bit lanes, so every ISA runs the
+ *  same kernels: AVX2 and AVX-512 machines get them VEX-encoded, and where
+ *  there is no SIMD GCC lowers the vectors to scalar code.
+ */
+using codec_word = std::uint32_t;
+using codec_row = typename simd::detail::vec<std::uint32_t, 16>::type;
+
+inline constexpr unsigned codec_raw = 64;     //  width of a block stored as is
+
+//  Four lanes of T's width, unsigned so the deltas wrap; and their signed twin.
+template <codec_type T>
+using codec_vec = typename simd::detail::vec<std::make_unsigned_t<T>, 4 * sizeof(T)>::type;
+template <codec_type T>
+using codec_svec = typename simd::detail::vec<std::make_signed_t<T>, 4 * sizeof(T)>::type;
+
+template <codec_type T>
+[[gnu::always_inline]] inline void zigzag_encode(codec_vec<T> & z_, codec_vec<T> const & d_) noexcept {
+  using X = codec_vec<T>;
+  using S = codec_svec<T>;
+  z_ = (d_ << 1) ^ X(S(d_) >> (8 * sizeof(T) - 1));
+}
+
+//  Adds the deltas of a row of zigzag codes to x.
+template <codec_type T>
+[[gnu::always_inline]] inline void add_zigzag(codec_vec<T> & x_, codec_row const & z_) noexcept {
+  using X = codec_vec<T>;
+  X const w_ = __builtin_convertvector(z_, X);
+  x_ += (w_ >> 1) ^ (X {} - (w_ & 1));
+}
+
+//  32 rows of b-bit values into 4 b words.
+template <unsigned B>
+[[gnu::always_inline]] inline void pack_rows(codec_row const * z_, codec_word * out) noexcept {
+  if constexpr (B == 32) {
+    std::memcpy(out, z_, 32 * sizeof(codec_row));
+  }
+  else if constexpr (B != 0) {
+    codec_row acc {};
+    unsigned used = 0;
+    std::size_t k_ = 0;
+#pragma GCC unroll 32
+    for (unsigned j_ = 0; j_ < 32; ++j_) {
+      acc |= z_[j_] << used;
+      used += B;
+      if (used >= 32) {
+        std::memcpy(out + 4 * k_++, &acc, sizeof(codec_row));
+        used -= 32;
+        acc = used > 0 ? z_[j_] >> (B - used) : codec_row {};
+      }
+    }
+  }
+}
+
+//  4 b words back into 32 rows, each handed to sink as it comes out.  The
+//  sink is worked on as a local copy, so its state stays in registers rather
+//  than being reloaded after every store through its output pointer.
+template <unsigned B, typename Sink>
+[[gnu::always_inline]] inline void unpack_rows(codec_word const * in, Sink & s0) noexcept {
+  Sink sink = s0;
+  if constexpr (B == 0) {
+    for (unsigned j_ = 0; j_ < 32; ++j_) {
+      sink(codec_row {});
+    }
+  }
+  else if constexpr (B == 32) {
+    codec_row w_;
+    for (unsigned j_ = 0; j_ < 32; ++j_) {
+      simd::detail::load(w_, in + 4 * j_);
+      sink(w_);
+    }
+  }
+  else {
+    codec_row const mask = codec_row {} + ((1U << B) - 1);
+    codec_row w_;
+    simd::detail::load(w_, in);
+    unsigned used = 0;
+    std::size_t k_ = 0;
+#pragma GCC unroll 32
+    for (unsigned j_ = 0; j_ < 32; ++j_) {
+      codec_row v_ = w_ >> used;
+      used += B;
+      if (used > 32) {
+        simd::detail::load(w_, in + 4 * ++k_);
+        used -= 32;
+        v_ |= w_ << (B - used);
+      }
+      else if (used == 32 && j_ != 31) {
+        simd::detail::load(w_, in + 4 * ++k_);
+        used = 0;
+      }
+      sink(v_ & mask);
+    }
+  }
+  s0 = sink;
+}
+
+template <unsigned B>
+void pack_generic(codec_row const * z_, codec_word * out) noexcept {
+  pack_rows<B>(z_, out);
+}
+
+template <unsigned B, typename Sink>
+void unpack_generic(codec_word const * in, Sink & sink) noexcept {
+  unpack_rows<B>(in, sink);
+}
+
+#if defined(CFNUM_SIMD_X86)
+template <unsigned B>
+[[gnu::target("avx2,fma")]] void pack_avx2(codec_row const * z_, codec_word * out) noexcept {
+  pack_rows<B>(z_, out);
+}
+
+template <unsigned B, typename Sink>
+[[gnu::target("avx2,fma")]] void unpack_avx2(codec_word const * in, Sink & sink) noexcept {
+  unpack_rows<B>(in, sink);
+}
+#endif
+
+//  One kernel per bit width, picked from a table.
+using pack_fn = void (*)(codec_row const *, codec_word *) noexcept;
+template <typename Sink>
+using unpack_fn = void (*)(codec_word const *, Sink &) noexcept;
+
+template <std::size_t... Bs>
+constexpr std::array<pack_fn, 33> pack_table(bool vex, std::index_sequence<Bs...>) noexcept {
+#if defined(CFNUM_SIMD_X86)
+  if (vex) {
+    return { &pack_avx2<Bs>... };
+  }
+#endif
+  (void) vex;
+  return { &pack_generic<Bs>... };
+}
+
+template <typename Sink, std::size_t... Bs>
+constexpr std::array<unpack_fn<Sink>, 33> unpack_table(bool vex, std::index_sequence<Bs...>) noexcept {
+#if defined(CFNUM_SIMD_X86)
+  if (vex) {
+    return { &unpack_avx2<Bs, Sink>... };
+  }
+#endif
+  (void) vex;
+  return { &unpack_generic<Bs, Sink>... };
+}
+
+inline bool codec_vex() noexcept {
+  switch (simd::active_isa()) {
+    case simd::isa::avx512:
+    case simd::isa::avx2:   return true;
+    default:                return false;
+  }
+}
+
+inline void pack_block(unsigned b_, codec_row const * z_, codec_word * out) noexcept {
+  static constexpr auto generic = pack_table(false, std::make_index_sequence<33> {});
+  static constexpr auto vex = pack_table(true, std::make_index_sequence<33> {});
+  (codec_vex() ? vex : generic)[b_](z_, out);
+}
+
+template <typename Sink>
+inline void unpack_block(unsigned b_, codec_word const * in, Sink & sink) noexcept {
+  static constexpr auto generic = unpack_table<Sink>(false, std::make_index_sequence<33> {});
+  static constexpr auto vex = unpack_table<Sink>(true, std::make_index_sequence<33> {});
+  (codec_vex() ? vex : generic)[b_](in, sink);
+}
+
+//  Sinks take the decoded values four at a time: put() the values themselves,
+//  operator() a row of zigzag deltas on top of the last four.
+template <codec_type T>
+struct decode_sink {
+  using X = codec_vec<T>;
+  X cur;
+  T * out;
+
+  [[gnu::always_inline]] void put(X const & x_) noexcept {
+    cur = x_;
+    std::memcpy(out, &cur, sizeof(X));
+    out += 4;
+  }
+  [[gnu::always_inline]] void operator()(codec_row const & z_) noexcept {
+    X x_ = cur;
+    add_zigzag<T>(x_, z_);
+    put(x_);
+  }
+};
+
+//  Sums in 64-bit lanes: exact for 32-bit values, wrapping for 64-bit ones.
+template <codec_type T>
+struct sum_sink {
+  using X = codec_vec<T>;
+  using A = typename simd::detail::vec<std::uint64_t, 32>::type;
+  using SA = typename simd::detail::vec<std::int64_t, 32>::type;
+  X cur;
+  A acc;
+
+  [[gnu::always_inline]] void put(X const & x_) noexcept {
+    cur = x_;
+    if constexpr (sizeof(T) == 4 && std::is_signed_v<T>) {
+      acc += A(__builtin_convertvector(codec_svec<T>(cur), SA));
+    }
+    else {
+      acc += __builtin_convertvector(cur, A);
+    }
+  }
+  [[gnu::always_inline]] void operator()(codec_row const & z_) noexcept {
+    X x_ = cur;
+    add_zigzag<T>(x_, z_);
+    put(x_);
+  }
+};
+
+//  Running totals of the values: each row scanned in-register on top of the
+//  carry, as in simd::inclusive_scan.
+template <codec_type T>
+struct scan_sink {
+  using X = codec_vec<T>;
+  X cur;
+  X carry;
+  T * out;
+
+  [[gnu::always_inline]] void put(X const & x_) noexcept {
+    cur = x_;
+    X v_ = x_;
+    simd::detail::log_step<1, 4, simd::detail::scan_add>(v_, X {});
+    v_ += carry;
+    std::memcpy(out, &v_, sizeof(X));
+    out += 4;
+    simd::detail::broadcast_last<4>(carry, v_, std::make_index_sequence<4> {});
+  }
+  [[gnu::always_inline]] void operator()(codec_row const & z_) noexcept {
+    X x_ = cur;
+    add_zigzag<T>(x_, z_);
+    put(x_);
+  }
+};
+
+//  Deltas of one full block from base, zigzag coded; returns the bit width
+//  they need (up to 64 for 64-bit values).
+template <codec_type T>
+[[gnu::always_inline]] inline unsigned delta_rows(T const * x_, T base, codec_vec<T> * z_) noexcept {
+  using X = codec_vec<T>;
+  X prev = X {} + static_cast<std::make_unsigned_t<T>>(base);
+  X any {};
+  X v_;
+  for (unsigned j_ = 0; j_ < 32; ++j_) {
+    simd::detail::load(v_, x_ + 4 * j_);
+    zigzag_encode<T>(z_[j_], v_ - prev);
+    prev = v_;
+    any |= z_[j_];
+  }
+  return static_cast<unsigned>(std::bit_width(any[0] | any[1] | any[2] | any[3]));
+}
+
+template <codec_type T>
+inline unsigned delta_rows_generic(T const * x_, T base, codec_vec<T> * z_) noexcept {
+  return delta_rows(x_, base, z_);
+}
+
+#if defined(CFNUM_SIMD_X86)
+template <codec_type T>
+[[gnu::target("avx2,fma")]] unsigned delta_rows_avx2(T const * x_, T base, codec_vec<T> * z_) noexcept {
+  return delta_rows(x_, base, z_);
+}
+#endif
+
+} /* namespace detail */
+
+/*
+ *  MARK: delta_packed
+ *
+ *  An integer array held as delta + zigzag + bit-packed blocks of codec_block
+ *  values (the SIMD-BP128 layout above).  Sorted ids and timestamps with small
+ *  gaps shrink to a few bits per value.  Each block records the value before
+ *  it and where its words start, so any block decodes on its own: operator[]
+ *  and lower_bound() touch one block, and sum() and inclusive_scan() run over
+ *  the packed words a row at a time without writing the decoded array out.
+ */
+template <codec_type T>
+class delta_packed {
+public:
+  using value_type = T;
+  using sum_type = std::conditional_t<sizeof(T) == 4, std::conditional_t<std::is_signed_v<T>, std::int64_t, std::uint64_t>, T>;
+  static constexpr std::size_t block_size = codec_block;
+
+  delta_packed() = default;
+
+  explicit delta_packed(std::span<T const> values) {
+    assign(values);
+  }
+
+  void assign(std::span<T const> values) {
+    size_ = values.size();
+    blocks_.clear();
+    words_.clear();
+    blocks_.reserve((size_ + codec_block - 1) / codec_block);
+    words_.reserve(values.size() / 2);
+    alignas(64) T tail[codec_block];
+    alignas(64) detail::codec_vec<T> z_[32];
+    alignas(64) detail::codec_row z32[32];
+    T base = size_ != 0 ? values[0] : T {};
+    for (std::size_t i_ = 0; i_ < size_; i_ += codec_block) {
+      T const * x_ = values.data() + i_;
+      std::size_t const m_ = std::min(codec_block, size_ - i_);
+      if (m_ < codec_block) {
+        //  The last block is padded with its last value.
+        std::copy_n(x_, m_, tail);
+        std::fill(tail + m_, tail + codec_block, x_[m_ - 1]);
+        x_ = tail;
+      }
+      unsigned b_ = detail::codec_vex() ? delta_rows_vex(x_, base, z_) : detail::delta_rows_generic(x_, base, z_);
+      std::size_t const at = words_.size();
+      if (b_ > 32) {
+        b_ = detail::codec_raw;
+        words_.resize(at + codec_block * sizeof(T) / sizeof(detail::codec_word));
+        std::memcpy(words_.data() + at, x_, codec_block * sizeof(T));
+      }
+      else {
+        for (unsigned j_ = 0; j_ < 32; ++j_) {
+          z32[j_] = __builtin_convertvector(z_[j_], detail::codec_row);
+        }
+        words_.resize(at + 4 * b_);
+        detail::pack_block(b_, z32, words_.data() + at);
+      }
+      blocks_.push_back({ base, (std::uint64_t(at) << 8) | b_ });
+      base = x_[codec_block - 1];
+    }
+    words_.shrink_to_fit();
+  }
+
+  std::size_t size() const noexcept { return size_; }
+  std::size_t block_count() const noexcept { return blocks_.size(); }
+  std::size_t compressed_bytes() const noexcept {
+    return words_.size() * sizeof(detail::codec_word) + blocks_.size() * sizeof(block_info);
+  }
+  double bits_per_value() const noexcept {
+    return size_ == 0 ? 0.0 : 8.0 * static_cast<double>(compressed_bytes()) / static_cast<double>(size_);
+  }
+  unsigned block_width(std::size_t b_) const noexcept { return static_cast<unsigned>(blocks_[b_].at & 0xFF); }
+
+  //  Values of block b into out (room for codec_block); returns how many.
+  std::size_t decode_block(std::size_t b_, T * out) const noexcept {
+    std::size_t const m_ = std::min(codec_block, size_ - b_ * codec_block);
+    if (m_ == codec_block) {
+      detail::decode_sink<T> s_ { {}, out };
+      run_block(b_, s_);
+    }
+    else {
+      alignas(64) T tmp[codec_block];
+      detail::decode_sink<T> s_ { {}, tmp };
+      run_block(b_, s_);
+      std::copy_n(tmp, m_, out);
+    }
+    return m_;
+  }
+
+  //  out.size() >= size().
+  void decode(std::span<T> out) const noexcept {
+    for (std::size_t b_ = 0; b_ < blocks_.size(); ++b_) {
+      decode_block(b_, out.data() + b_ * codec_block);
+    }
+  }
+
+  std::vector<T> decode() const {
+    std::vector<T> v_(size_);
+    decode(std::span<T>(v_));
+    return v_;
+  }
+
+  T operator[](std::size_t i_) const noexcept {
+    alignas(64) T tmp[codec_block];
+    decode_block(i_ / codec_block, tmp);
+    return tmp[i_ % codec_block];
+  }
+
+  sum_type sum() const noexcept {
+    using A = typename detail::sum_sink<T>::A;
+    detail::sum_sink<T> s_ { {}, A {} };
+    std::size_t const full = size_ / codec_block;
+    for (std::size_t b_ = 0; b_ < full; ++b_) {
+      run_block(b_, s_);
+    }
+    using W = std::make_unsigned_t<sum_type>;
+    W r_ = static_cast<W>(s_.acc[0] + s_.acc[1] + s_.acc[2] + s_.acc[3]);
+    if (full < blocks_.size()) {
+      alignas(64) T tmp[codec_block];
+      std::size_t const m_ = decode_block(full, tmp);
+      for (std::size_t i_ = 0; i_ < m_; ++i_) {
+        r_ += static_cast<W>(static_cast<sum_type>(tmp[i_]));
+      }
+    }
+    return static_cast<sum_type>(r_);
+  }
+
+  //  out[i] = init + x[0] + ... + x[i], wrapping in T; out.size() >= size().
+  void inclusive_scan(std::span<T> out, T init = T {}) const noexcept {
+    using X = detail::codec_vec<T>;
+    detail::scan_sink<T> s_ { {}, X {} + static_cast<std::make_unsigned_t<T>>(init), out.data() };
+    std::size_t const full = size_ / codec_block;
+    for (std::size_t b_ = 0; b_ < full; ++b_) {
+      run_block(b_, s_);
+    }
+    if (full < blocks_.size()) {
+      alignas(64) T tmp[codec_block];
+      std::size_t const m_ = decode_block(full, tmp);
+      T acc = static_cast<T>(s_.carry[0]);
+      for (std::size_t i_ = 0; i_ < m_; ++i_) {
+        acc = static_cast<T>(static_cast<std::make_unsigned_t<T>>(acc) + static_cast<std::make_unsigned_t<T>>(tmp[i_]));
+        out[full * codec_block + i_] = acc;
+      }
+    }
+  }
+
+  //  Index of the first value not less than v, for nondecreasing input: a
+  //  binary search over the block bases, then one block decoded.
+  std::size_t lower_bound(T v_) const noexcept {
+    if (blocks_.empty()) {
+      return 0;
+    }
+    auto const it_ = std::partition_point(blocks_.begin() + 1, blocks_.end(),
+                                          [v_](block_info const & h_) { return h_.base < v_; });
+    std::size_t const b_ = static_cast<std::size_t>(it_ - blocks_.begin()) - 1;
+    alignas(64) T tmp[codec_block];
+    std::size_t const m_ = decode_block(b_, tmp);
+    return b_ * codec_block + static_cast<std::size_t>(std::lower_bound(tmp, tmp + m_, v_) - tmp);
+  }
+
+private:
+  struct block_info {
+    T base;                     //  the value before the block (the first value for the first)
+    std::uint64_t at;           //  word offset << 8 | bit width
+  };
+
+  static unsigned delta_rows_vex(T const * x_, T base, detail::codec_vec<T> * z_) noexcept {
+#if defined(CFNUM_SIMD_X86)
+    return detail::delta_rows_avx2(x_, base, z_);
+#else
+    return detail::delta_rows_generic(x_, base, z_);
+#endif
+  }
+
+  template <typename Sink>
+  void run_block(std::size_t b_, Sink & s_) const noexcept {
+    block_info const & h_ = blocks_[b_];
+    unsigned const w_ = static_cast<unsigned>(h_.at & 0xFF);
+    detail::codec_word const * p_ = words_.data() + (h_.at >> 8);
+    s_.cur = detail::codec_vec<T> {} + static_cast<std::make_unsigned_t<T>>(h_.base);
+    if (w_ == detail::codec_raw) {
+      detail::codec_vec<T> x_;
+      for (std::size_t j_ = 0; j_ < 32; ++j_) {
+        simd::detail::load(x_, reinterpret_cast<T const *>(p_) + 4 * j_);
+        s_.put(x_);
+      }
+    }
+    else {
+      detail::unpack_block(w_, p_, s_);
+    }
+  }
+
+  std::size_t size_ = 0;
+  std::vector<block_info> blocks_;
+  std::vector<detail::codec_word> words_;
+};
+
+} /* namespace cfnum */
+
+#endif /* delta_codec_hpp */
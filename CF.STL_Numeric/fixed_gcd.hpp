@@ -0,0 +1,251 @@
+//
+//  fixed_gcd.hpp
+//  CF.STL_Numeric
+//
+//  MARK: - References.
+//  @see: Granlund & Montgomery, "Division by Invariant Integers using Multiplication"
+//  @see: Lemire, Kaser & Kurz, "Faster Remainder by Direct Computation" (fastmod)
+//  @see: https://libdivide.com
+//
+
+#ifndef fixed_gcd_hpp
+#define fixed_gcd_hpp
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <type_traits>
+
+#include "gcd_lcm.hpp"
+
+namespace cfnum {
+
+namespace detail {
+
+//  Unsigned type twice as wide, for the high half of a product.
+template <typename U> struct wide;
+template <> struct wide<std::uint32_t> { using type = std::uint64_t; };
+template <> struct wide<std::uint64_t> { using type = unsigned __int128; };
+
+template <typename U>
+using wide_t = typename wide<U>::type;
+
+//  Inverse of odd d modulo 2^W by Newton's iteration; each step doubles the
+//  number of correct low bits (d is its own inverse to 3 bits).
+template <std::unsigned_integral U>
+constexpr U odd_inverse(U d_) noexcept {
+  U x_ = d_;
+  for (int b_ = 3; b_ < std::numeric_limits<U>::digits; b_ *= 2) {
+    x_ *= U(2) - d_ * x_;
+  }
+  return x_;
+}
+
+//  x / d for d known to divide x, with no divide instruction.
+template <std::unsigned_integral U>
+constexpr U exact_divide(U x_, U d_) noexcept {
+  int const s_ = std::countr_zero(d_);
+  return U((x_ >> s_) * odd_inverse(U(d_ >> s_)));
+}
+
+} /* namespace detail */
+
+/*
+ *  MARK: fast_modulus
+ *
+ *  x % d by multiplication for a divisor fixed up front (Lemire's fastmod): with
+ *  M = ceil(2^2W / d), the low 2W bits of M * x hold the fraction x / d, and
+ *  multiplying that fraction back by d gives the remainder in the high bits.
+ *  Exact for every W-bit x and every d > 0.
+ */
+template <std::unsigned_integral U>
+class fast_modulus {
+public:
+  using wide_type = detail::wide_t<U>;
+
+  constexpr fast_modulus() = default;
+  constexpr explicit fast_modulus(U d) noexcept
+    : d_(d), m_(d == 0 ? wide_type(0) : wide_type(~wide_type(0) / d + 1)) {}
+
+  constexpr U divisor() const noexcept { return d_; }
+
+  constexpr U operator()(U x_) const noexcept {
+    constexpr int W = std::numeric_limits<U>::digits;
+    wide_type const frac = m_ * x_;                          //  wraps mod 2^2W by design
+    wide_type const lo = U(frac) * wide_type(d_);
+    wide_type const hi = (frac >> W) * wide_type(d_);
+    return U((hi + (lo >> W)) >> W);
+  }
+
+private:
+  U d_ = 0;
+  wide_type m_ = 0;
+};
+
+/*
+ *  MARK: fixed_gcd
+ *
+ *  gcd / lcm of one fixed operand k against many values, with the per-value work
+ *  done by multiplications only.
+ *
+ *  When k factors over small primes (always for |k| < 2^32; otherwise when what is
+ *  left after trial division up to 2^16 is below 2^32 and so prime) the object
+ *  keeps k = 2^t * p1^e1 * ... and, per odd prime, its inverse mod 2^W.  Then
+ *      x divisible by p  <=>  x * inv(p) (mod 2^W) <= (2^W - 1) / p
+ *  and the product is x / p when it is, so gcd(k, x) is built one prime power at a
+ *  time and x / gcd falls out along the way for the lcm.
+ *  Otherwise gcd(k, x) = gcd(k, x mod k) with the remainder from fast_modulus,
+ *  leaving a binary gcd on operands below |k|.
+ */
+template <gcd_type T>
+class fixed_gcd {
+public:
+  using value_type = T;
+  using unsigned_type = std::make_unsigned_t<T>;
+
+  struct prime_power {
+    unsigned_type prime;
+    unsigned_type inverse;          //  prime * inverse == 1 (mod 2^W)
+    unsigned_type limit;            //  x * inverse <= limit  <=>  prime divides x
+    unsigned exponent;
+  };
+
+  //  Trial division bound used by the constructor.
+  static constexpr unsigned_type trial_limit = 1U << 16;
+
+  explicit fixed_gcd(T k) noexcept : k_(magnitude(k)), mod_(magnitude(k)) {
+    factorize();
+  }
+
+  T operand() const noexcept { return static_cast<T>(k_); }
+  bool factored() const noexcept { return factored_; }
+  unsigned twos() const noexcept { return twos_; }
+  std::span<prime_power const> odd_factors() const noexcept { return { odd_.data(), count_ }; }
+
+  T gcd(T x_) const noexcept {
+    unsigned_type q_;
+    return static_cast<T>(gcd_and_cofactor(magnitude(x_), q_));
+  }
+
+  //  std::nullopt when the lcm does not fit in T.
+  std::optional<T> lcm(T x_) const noexcept {
+    unsigned_type q_;
+    unsigned_type const ux = magnitude(x_);
+    if (k_ == 0 || ux == 0) {
+      return T(0);
+    }
+    gcd_and_cofactor(ux, q_);
+    unsigned_type r_ = 0;
+    if (__builtin_mul_overflow(q_, k_, &r_) || r_ > static_cast<unsigned_type>(std::numeric_limits<T>::max())) {
+      return std::nullopt;
+    }
+    return static_cast<T>(r_);
+  }
+
+  //  out[i] = gcd(k, in[i]).  Without a factorization, the remainders are taken
+  //  first and the vector binary gcd finishes the job on operands below |k|.
+  void gcd(std::span<T const> in, std::span<T> out) const noexcept {
+    std::size_t const n_ = std::min(in.size(), out.size());
+    if (!factored_ && k_ != 0) {
+      for (std::size_t i_ = 0; i_ < n_; ++i_) {
+        out[i_] = static_cast<T>(mod_(magnitude(in[i_])));
+      }
+      cfnum::gcd(std::span<T const>(out.data(), n_), static_cast<T>(k_), out);
+      return;
+    }
+    for (std::size_t i_ = 0; i_ < n_; ++i_) {
+      out[i_] = gcd(in[i_]);
+    }
+  }
+
+  //  out[i] = lcm(k, in[i]), 0 where it overflows; returns the first overflowing
+  //  index, or the number of elements written when every result fits.
+  std::size_t lcm(std::span<T const> in, std::span<T> out) const noexcept {
+    std::size_t const n_ = std::min(in.size(), out.size());
+    std::size_t first = n_;
+    for (std::size_t i_ = 0; i_ < n_; ++i_) {
+      auto const l_ = lcm(in[i_]);
+      out[i_] = l_.value_or(T(0));
+      first = l_ ? first : std::min(first, i_);
+    }
+    return first;
+  }
+
+private:
+  //  Returns gcd(k, x) and sets q = x / gcd.
+  unsigned_type gcd_and_cofactor(unsigned_type x_, unsigned_type & q_) const noexcept {
+    if (x_ == 0 || k_ == 0) {
+      q_ = (x_ == 0) ? 0 : 1;
+      return x_ | k_;
+    }
+    if (!factored_) {
+      unsigned_type const g_ = binary_gcd_magnitude(k_, mod_(x_));
+      q_ = detail::exact_divide(x_, g_);
+      return g_;
+    }
+    unsigned const t_ = std::min<unsigned>(twos_, std::countr_zero(x_));
+    unsigned_type g_ = unsigned_type(1) << t_;
+    x_ >>= t_;
+    for (std::size_t f_ = 0; f_ < count_; ++f_) {
+      prime_power const & pp = odd_[f_];
+      for (unsigned e_ = 0; e_ < pp.exponent; ++e_) {
+        unsigned_type const y_ = x_ * pp.inverse;
+        if (y_ > pp.limit) {
+          break;
+        }
+        x_ = y_;
+        g_ *= pp.prime;
+      }
+    }
+    q_ = x_;
+    return g_;
+  }
+
+  void add_factor(unsigned_type p_, unsigned e_) noexcept {
+    odd_[count_++] = { p_, detail::odd_inverse(p_), unsigned_type(~unsigned_type(0)) / p_, e_, };
+  }
+
+  void factorize() noexcept {
+    if (k_ == 0) {
+      return;
+    }
+    unsigned_type r_ = k_;
+    twos_ = std::countr_zero(r_);
+    r_ >>= twos_;
+    for (unsigned_type p_ = 3; p_ <= trial_limit && p_ <= r_ / p_; p_ += 2) {
+      if (r_ % p_ == 0) {
+        unsigned e_ = 0;
+        do {
+          r_ /= p_;
+          ++e_;
+        } while (r_ % p_ == 0);
+        add_factor(p_, e_);
+      }
+    }
+    //  No factor up to trial_limit: below trial_limit^2 what is left is prime.
+    if (r_ > 1 && r_ / trial_limit >= trial_limit) {
+      count_ = 0;
+      return;
+    }
+    if (r_ > 1) {
+      add_factor(r_, 1);
+    }
+    factored_ = true;
+  }
+
+  unsigned_type k_;
+  fast_modulus<unsigned_type> mod_;
+  unsigned twos_ = 0;
+  std::array<prime_power, 16> odd_ {};      //  a 64-bit value has at most 15 distinct odd primes
+  std::size_t count_ = 0;
+  bool factored_ = false;
+};
+
+} /* namespace cfnum */
+
+#endif /* fixed_gcd_hpp */
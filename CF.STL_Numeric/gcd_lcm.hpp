@@ -0,0 +1,514 @@
+//
+//  gcd_lcm.hpp
+//  CF.STL_Numeric
+//
+//  MARK: - References.
+//  @see: https://en.cppreference.com/w/cpp/numeric/gcd
+//  @see: https://en.wikipedia.org/wiki/Binary_GCD_algorithm (Stein's algorithm)
+//  @see: https://lemire.me/blog/2013/12/26/fastest-way-to-compute-the-greatest-common-divisor/
+//
+
+#ifndef gcd_lcm_hpp
+#define gcd_lcm_hpp
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "thread_pool.hpp"
+#include "parallel_reduce.hpp"
+#include "simd_kernels.hpp"
+
+namespace cfnum {
+
+//  Element types with batched kernels.
+template <typename T>
+concept gcd_type = std::same_as<T, std::int32_t> || std::same_as<T, std::uint32_t>
+                || std::same_as<T, std::int64_t> || std::same_as<T, std::uint64_t>;
+
+//  Elements per chunk for the parallel paths; gcd_reduce() checks for an early
+//  exit once per gcd_block.
+inline constexpr std::size_t gcd_grain = 16'384;
+inline constexpr std::size_t gcd_block = 4'096;
+
+/*
+ *  MARK: binary_gcd()
+ *
+ *  Stein's algorithm: strip common factors of two with one ctz, then subtract and
+ *  shift.  No division, and the loop body is branch-free apart from the exit.
+ *  Like std::gcd the result is |gcd(a, b)|; gcd(T_MIN, 0) and gcd(T_MIN, T_MIN)
+ *  are not representable in a signed T and wrap.
+ */
+template <std::unsigned_integral U>
+constexpr U binary_gcd_magnitude(U u_, U v_) noexcept {
+  if (u_ == 0) {
+    return v_;
+  }
+  if (v_ == 0) {
+    return u_;
+  }
+  int const shift = std::countr_zero(U(u_ | v_));
+  u_ >>= std::countr_zero(u_);
+  do {
+    v_ >>= std::countr_zero(v_);
+    if (u_ > v_) {
+      std::swap(u_, v_);
+    }
+    v_ -= u_;
+  } while (v_ != 0);
+  return U(u_ << shift);
+}
+
+template <std::integral T>
+constexpr std::make_unsigned_t<T> magnitude(T x_) noexcept {
+  using U = std::make_unsigned_t<T>;
+  if constexpr (std::is_signed_v<T>) {
+    return x_ < 0 ? U(U(0) - U(x_)) : U(x_);
+  }
+  else {
+    return x_;
+  }
+}
+
+template <std::integral T>
+constexpr T binary_gcd(T a_, T b_) noexcept {
+  return static_cast<T>(binary_gcd_magnitude(magnitude(a_), magnitude(b_)));
+}
+
+/*
+ *  MARK: checked_lcm()
+ *
+ *  |a| / gcd * |b|, or std::nullopt when the result does not fit in T (std::lcm is
+ *  undefined there).  lcm(0, x) is 0.
+ */
+template <std::integral T>
+constexpr std::optional<T> checked_lcm(T a_, T b_) noexcept {
+  using U = std::make_unsigned_t<T>;
+  U const ua = magnitude(a_);
+  U const ub = magnitude(b_);
+  if (ua == 0 || ub == 0) {
+    return T(0);
+  }
+  U r_ = 0;
+  if (__builtin_mul_overflow(U(ua / binary_gcd_magnitude(ua, ub)), ub, &r_)
+      || r_ > static_cast<U>(std::numeric_limits<T>::max())) {
+    return std::nullopt;
+  }
+  return static_cast<T>(r_);
+}
+
+namespace detail {
+
+//  Lane-wise count of trailing zeros, as popcount((x & -x) - 1) done SWAR-style
+//  (there is no portable per-lane ctz).  Zero lanes yield the lane width.
+template <typename V, typename U>
+[[gnu::always_inline]] inline void ctz_lanes(V & c_, V const & x_) noexcept {
+  constexpr U m1 = U(~U(0)) / 3;
+  constexpr U m2 = U(~U(0)) / 15 * 3;
+  constexpr U m4 = U(~U(0)) / 255 * 15;
+  constexpr U h01 = U(~U(0)) / 255;
+  V t_ = (x_ & (V {} - x_)) - 1;
+  t_ = t_ - ((t_ >> 1) & m1);
+  t_ = (t_ & m2) + ((t_ >> 2) & m2);
+  t_ = (t_ + (t_ >> 4)) & m4;
+  c_ = (t_ * h01) >> (std::numeric_limits<U>::digits - 8);
+}
+
+template <typename V, std::size_t L>
+[[gnu::always_inline]] inline bool any_lane(V const & x_) noexcept {
+  auto acc = x_[0];
+  for (std::size_t l_ = 1; l_ < L; ++l_) {
+    acc |= x_[l_];
+  }
+  return acc != 0;
+}
+
+//  Stein's algorithm in every lane at once: u = gcd(u, v).  Lanes that finish
+//  early are masked off; the loop runs until the slowest lane is done.
+template <typename V, typename U, std::size_t L>
+[[gnu::always_inline]] inline void gcd_lanes(V & u_, V const & b_) noexcept {
+  V const zero {};
+  V const either_zero = (V)((u_ == zero) | (b_ == zero));
+  V const trivial = u_ | b_;                  //  gcd(x, 0) = gcd(0, x) = x
+  u_ = (u_ & ~either_zero) | (either_zero & 1);
+  V v_ = (b_ & ~either_zero) | (either_zero & 1);
+
+  V shift, tz;
+  ctz_lanes<V, U>(shift, u_ | v_);
+  ctz_lanes<V, U>(tz, u_);
+  u_ >>= tz;
+  while (any_lane<V, L>(v_)) {
+    V const active = (V)(v_ != zero);
+    ctz_lanes<V, U>(tz, v_);
+    v_ >>= (tz & active);
+    V const lt = (V)(u_ < v_);
+    V const lo = (u_ & lt) | (v_ & ~lt);
+    V const hi = (v_ & lt) | (u_ & ~lt);
+    u_ = (lo & active) | (u_ & ~active);
+    v_ = (hi - lo) & active;
+  }
+  u_ = ((u_ << shift) & ~either_zero) | (trivial & either_zero);
+}
+
+//  out[i] = gcd(a[i], b[i]), or gcd(a[i], b[0]) when ScalarB.
+template <std::size_t Bytes, bool Signed, bool ScalarB, typename U>
+[[gnu::always_inline]] inline void gcd_kernel(U const * a_, U const * b_, U * out, std::size_t n_) noexcept {
+  using V = typename simd::detail::vec<U, Bytes>::type;
+  constexpr std::size_t L = simd::detail::vec<U, Bytes>::lanes;
+  V x_, y_;
+  if constexpr (ScalarB) {
+    y_ = V {} + b_[0];
+    simd::detail::magnitude_lanes<Signed, V, U>(y_);
+  }
+  std::size_t i_ = 0;
+  for (; i_ + L <= n_; i_ += L) {
+    simd::detail::load(x_, a_ + i_);
+    simd::detail::magnitude_lanes<Signed, V, U>(x_);
+    if constexpr (!ScalarB) {
+      simd::detail::load(y_, b_ + i_);
+      simd::detail::magnitude_lanes<Signed, V, U>(y_);
+    }
+    gcd_lanes<V, U, L>(x_, y_);
+    std::memcpy(out + i_, &x_, sizeof(V));
+  }
+  for (; i_ < n_; ++i_) {
+    U x1 = a_[i_];
+    U y1 = ScalarB ? b_[0] : b_[i_];
+    if constexpr (Signed) {
+      x1 = magnitude(static_cast<std::make_signed_t<U>>(x1));
+      y1 = magnitude(static_cast<std::make_signed_t<U>>(y1));
+    }
+    out[i_] = binary_gcd_magnitude(x1, y1);
+  }
+}
+
+//  gcd of acc and every element: one running gcd per lane, each seeded with acc
+//  so the lanes never grow past it, folded at the end.
+template <std::size_t Bytes, bool Signed, typename U>
+[[gnu::always_inline]] inline U gcd_fold_kernel(U const * p_, std::size_t n_, U acc) noexcept {
+  using V = typename simd::detail::vec<U, Bytes>::type;
+  constexpr std::size_t L = simd::detail::vec<U, Bytes>::lanes;
+  V g_ = V {} + acc;
+  V x_;
+  std::size_t i_ = 0;
+  for (; i_ + L <= n_; i_ += L) {
+    simd::detail::load(x_, p_ + i_);
+    simd::detail::magnitude_lanes<Signed, V, U>(x_);
+    gcd_lanes<V, U, L>(g_, x_);
+  }
+  for (std::size_t l_ = 0; l_ < L; ++l_) {
+    acc = binary_gcd_magnitude(acc, U(g_[l_]));
+  }
+  for (; i_ < n_; ++i_) {
+    U x1 = p_[i_];
+    if constexpr (Signed) {
+      x1 = magnitude(static_cast<std::make_signed_t<U>>(x1));
+    }
+    acc = binary_gcd_magnitude(acc, x1);
+  }
+  return acc;
+}
+
+template <bool Signed, bool ScalarB, typename U>
+inline void gcd_scalar(U const * a_, U const * b_, U * out, std::size_t n_) noexcept {
+  for (std::size_t i_ = 0; i_ < n_; ++i_) {
+    U x1 = a_[i_];
+    U y1 = ScalarB ? b_[0] : b_[i_];
+    if constexpr (Signed) {
+      x1 = magnitude(static_cast<std::make_signed_t<U>>(x1));
+      y1 = magnitude(static_cast<std::make_signed_t<U>>(y1));
+    }
+    out[i_] = binary_gcd_magnitude(x1, y1);
+  }
+}
+
+template <bool Signed, typename U>
+inline U gcd_fold_scalar(U const * p_, std::size_t n_, U acc) noexcept {
+  for (std::size_t i_ = 0; i_ < n_; ++i_) {
+    U x1 = p_[i_];
+    if constexpr (Signed) {
+      x1 = magnitude(static_cast<std::make_signed_t<U>>(x1));
+    }
+    acc = binary_gcd_magnitude(acc, x1);
+  }
+  return acc;
+}
+
+#if defined(CFNUM_SIMD_X86)
+template <bool Signed, bool ScalarB, typename U>
+[[gnu::target("avx512f,avx512dq")]] void gcd_avx512(U const * a_, U const * b_, U * out, std::size_t n_) noexcept {
+  gcd_kernel<64, Signed, ScalarB>(a_, b_, out, n_);
+}
+
+template <bool Signed, bool ScalarB, typename U>
+[[gnu::target("avx2,fma")]] void gcd_avx2(U const * a_, U const * b_, U * out, std::size_t n_) noexcept {
+  gcd_kernel<32, Signed, ScalarB>(a_, b_, out, n_);
+}
+
+template <bool Signed, typename U>
+[[gnu::target("avx512f,avx512dq")]] U gcd_fold_avx512(U const * p_, std::size_t n_, U acc) noexcept {
+  return gcd_fold_kernel<64, Signed>(p_, n_, acc);
+}
+
+template <bool Signed, typename U>
+[[gnu::target("avx2,fma")]] U gcd_fold_avx2(U const * p_, std::size_t n_, U acc) noexcept {
+  return gcd_fold_kernel<32, Signed>(p_, n_, acc);
+}
+#endif
+
+template <bool ScalarB, typename T>
+inline void gcd_dispatch(T const * a_, T const * b_, T * out, std::size_t n_) noexcept {
+  using U = std::make_unsigned_t<T>;
+  constexpr bool S = std::is_signed_v<T>;
+  auto const * pa = reinterpret_cast<U const *>(a_);
+  auto const * pb = reinterpret_cast<U const *>(b_);
+  auto * po = reinterpret_cast<U *>(out);
+  switch (simd::active_isa()) {
+#if defined(CFNUM_SIMD_X86)
+    case simd::isa::avx512: gcd_avx512<S, ScalarB>(pa, pb, po, n_); break;
+    case simd::isa::avx2:   gcd_avx2<S, ScalarB>(pa, pb, po, n_); break;
+    case simd::isa::sse2:   gcd_kernel<16, S, ScalarB>(pa, pb, po, n_); break;
+#elif defined(CFNUM_SIMD_NEON)
+    case simd::isa::neon:   gcd_kernel<16, S, ScalarB>(pa, pb, po, n_); break;
+#endif
+    default:                gcd_scalar<S, ScalarB>(pa, pb, po, n_); break;
+  }
+}
+
+template <typename T>
+inline std::make_unsigned_t<T> gcd_fold(T const * p_, std::size_t n_, std::make_unsigned_t<T> acc) noexcept {
+  using U = std::make_unsigned_t<T>;
+  constexpr bool S = std::is_signed_v<T>;
+  auto const * pu = reinterpret_cast<U const *>(p_);
+  switch (simd::active_isa()) {
+#if defined(CFNUM_SIMD_X86)
+    case simd::isa::avx512: return gcd_fold_avx512<S>(pu, n_, acc);
+    case simd::isa::avx2:   return gcd_fold_avx2<S>(pu, n_, acc);
+    case simd::isa::sse2:   return gcd_fold_kernel<16, S>(pu, n_, acc);
+#elif defined(CFNUM_SIMD_NEON)
+    case simd::isa::neon:   return gcd_fold_kernel<16, S>(pu, n_, acc);
+#endif
+    default:                return gcd_fold_scalar<S>(pu, n_, acc);
+  }
+}
+
+//  Once the running gcd is small, Stein's subtract-and-shift needs ~log2(x / acc)
+//  steps per element while one remainder brings x straight down to acc's size.
+inline constexpr unsigned gcd_small_bits = 16;
+
+template <typename T>
+inline std::make_unsigned_t<T> gcd_fold_remainder(T const * p_, std::size_t n_, std::make_unsigned_t<T> acc) noexcept {
+  for (std::size_t i_ = 0; i_ < n_ && acc != 1; ++i_) {
+    acc = binary_gcd_magnitude(acc, std::make_unsigned_t<T>(magnitude(p_[i_]) % acc));
+  }
+  return acc;
+}
+
+//  Block-wise fold that stops as soon as the running gcd is 1 (or another
+//  thread has seen a 1, when stop is given).
+template <typename T>
+inline std::make_unsigned_t<T> gcd_fold_blocks(std::span<T const> s_, std::atomic<bool> * stop = nullptr) noexcept {
+  std::make_unsigned_t<T> acc = 0;
+  for (std::size_t lo = 0; lo < s_.size(); lo += gcd_block) {
+    if (stop != nullptr && stop->load(std::memory_order_relaxed)) {
+      return 1;
+    }
+    std::size_t const n_ = std::min(gcd_block, s_.size() - lo);
+    acc = (acc != 0 && std::bit_width(acc) <= gcd_small_bits) ? gcd_fold_remainder(s_.data() + lo, n_, acc)
+                                                              : gcd_fold(s_.data() + lo, n_, acc);
+    if (acc == 1) {
+      if (stop != nullptr) {
+        stop->store(true, std::memory_order_relaxed);
+      }
+      return 1;
+    }
+  }
+  return acc;
+}
+
+//  lcm from precomputed gcds (in out); returns the first index that overflowed.
+template <bool ScalarB, typename T>
+inline std::size_t lcm_from_gcd(T const * a_, T const * b_, T * out, std::size_t n_) noexcept {
+  using U = std::make_unsigned_t<T>;
+  std::size_t first = n_;
+  for (std::size_t i_ = 0; i_ < n_; ++i_) {
+    U const g_ = static_cast<U>(out[i_]);
+    U const ub = magnitude(ScalarB ? b_[0] : b_[i_]);
+    U r_ = 0;
+    if (g_ != 0 && (__builtin_mul_overflow(U(magnitude(a_[i_]) / g_), ub, &r_)
+                    || r_ > static_cast<U>(std::numeric_limits<T>::max()))) {
+      r_ = 0;
+      first = std::min(first, i_);
+    }
+    out[i_] = static_cast<T>(r_);
+  }
+  return first;
+}
+
+} /* namespace detail */
+
+/*
+ *  MARK: gcd()
+ *
+ *  Batched gcd, CPUID-dispatched to the vector kernel:
+ *    gcd(a, b, out)    out[i] = gcd(a[i], b[i])
+ *    gcd(a, k, out)    out[i] = gcd(a[i], k)
+ *  Results are non-negative as with std::gcd; out may alias a or b.
+ *  Only min(a.size(), b.size(), out.size()) elements are written.
+ */
+template <gcd_type T>
+void gcd(std::span<T const> a_, std::span<T const> b_, std::span<T> out) noexcept {
+  std::size_t const n_ = std::min({ a_.size(), b_.size(), out.size(), });
+  detail::gcd_dispatch<false>(a_.data(), b_.data(), out.data(), n_);
+}
+
+template <gcd_type T>
+void gcd(std::span<T const> a_, std::type_identity_t<T> k_, std::span<T> out) noexcept {
+  detail::gcd_dispatch<true>(a_.data(), &k_, out.data(), std::min(a_.size(), out.size()));
+}
+
+/*
+ *  MARK: gcd_reduce()
+ *
+ *  gcd of the whole array (0 for an empty one).  Returns as soon as the running
+ *  gcd reaches 1, which for typical data happens within the first block.
+ */
+template <gcd_type T>
+T gcd_reduce(std::span<T const> s_) noexcept {
+  return static_cast<T>(detail::gcd_fold_blocks(s_));
+}
+
+/*
+ *  MARK: lcm()
+ *
+ *  Batched lcm with overflow detection.  Entries whose lcm does not fit in T are
+ *  written as 0; the return value is the index of the first such entry, or the
+ *  number of elements processed when every result fits.
+ */
+template <gcd_type T>
+std::size_t lcm(std::span<T const> a_, std::span<T const> b_, std::span<T> out) noexcept {
+  std::size_t const n_ = std::min({ a_.size(), b_.size(), out.size(), });
+  if (out.data() == a_.data() || out.data() == b_.data()) {
+    std::size_t first = n_;
+    for (std::size_t i_ = 0; i_ < n_; ++i_) {
+      auto const l_ = checked_lcm(a_[i_], b_[i_]);
+      out[i_] = l_.value_or(T(0));
+      first = l_ ? first : std::min(first, i_);
+    }
+    return first;
+  }
+  detail::gcd_dispatch<false>(a_.data(), b_.data(), out.data(), n_);
+  return detail::lcm_from_gcd<false>(a_.data(), b_.data(), out.data(), n_);
+}
+
+template <gcd_type T>
+std::size_t lcm(std::span<T const> a_, std::type_identity_t<T> k_, std::span<T> out) noexcept {
+  std::size_t const n_ = std::min(a_.size(), out.size());
+  if (out.data() == a_.data()) {
+    std::size_t first = n_;
+    for (std::size_t i_ = 0; i_ < n_; ++i_) {
+      auto const l_ = checked_lcm(a_[i_], k_);
+      out[i_] = l_.value_or(T(0));
+      first = l_ ? first : std::min(first, i_);
+    }
+    return first;
+  }
+  detail::gcd_dispatch<true>(a_.data(), &k_, out.data(), n_);
+  return detail::lcm_from_gcd<true>(a_.data(), &k_, out.data(), n_);
+}
+
+//  lcm of the whole array (1 for an empty one); std::nullopt on overflow.
+template <gcd_type T>
+std::optional<T> lcm_reduce(std::span<T const> s_) noexcept {
+  T acc = 1;
+  for (auto x_ : s_) {
+    auto const l_ = checked_lcm(acc, x_);
+    if (!l_) {
+      return std::nullopt;
+    }
+    acc = *l_;
+    if (acc == 0) {
+      break;
+    }
+  }
+  return acc;
+}
+
+/*
+ *  MARK: parallel_gcd(), parallel_gcd_reduce()
+ *
+ *  The same kernels over chunks of the input on the pool.  The reduction shares an
+ *  early-exit flag: once any chunk's gcd is 1 the others stop at their next block.
+ */
+template <gcd_type T>
+void parallel_gcd(thread_pool & pool, std::span<T const> a_, std::span<T const> b_, std::span<T> out,
+                  std::size_t grain = gcd_grain) {
+  std::size_t const n_ = std::min({ a_.size(), b_.size(), out.size(), });
+  std::size_t const chunks = detail::chunk_count(n_, pool.size(), grain);
+  pool.parallel_for(chunks, [&](std::size_t c_) {
+    std::size_t const lo = n_ * c_ / chunks;
+    std::size_t const hi = n_ * (c_ + 1) / chunks;
+    detail::gcd_dispatch<false>(a_.data() + lo, b_.data() + lo, out.data() + lo, hi - lo);
+  });
+}
+
+template <gcd_type T>
+void parallel_gcd(thread_pool & pool, std::span<T const> a_, std::type_identity_t<T> k_, std::span<T> out,
+                  std::size_t grain = gcd_grain) {
+  std::size_t const n_ = std::min(a_.size(), out.size());
+  std::size_t const chunks = detail::chunk_count(n_, pool.size(), grain);
+  pool.parallel_for(chunks, [&](std::size_t c_) {
+    std::size_t const lo = n_ * c_ / chunks;
+    std::size_t const hi = n_ * (c_ + 1) / chunks;
+    detail::gcd_dispatch<true>(a_.data() + lo, &k_, out.data() + lo, hi - lo);
+  });
+}
+
+template <gcd_type T>
+T parallel_gcd_reduce(thread_pool & pool, std::span<T const> s_, std::size_t grain = gcd_grain) {
+  using U = std::make_unsigned_t<T>;
+  std::size_t const chunks = detail::chunk_count(s_.size(), pool.size(), grain);
+  if (chunks == 1) {
+    return gcd_reduce(s_);
+  }
+  std::atomic<bool> stop { false };
+  std::vector<detail::padded<U>> partial(chunks);
+  pool.parallel_for(chunks, [&](std::size_t c_) {
+    std::size_t const lo = s_.size() * c_ / chunks;
+    std::size_t const hi = s_.size() * (c_ + 1) / chunks;
+    partial[c_].value = detail::gcd_fold_blocks(s_.subspan(lo, hi - lo), &stop);
+  });
+  if (stop.load()) {
+    return T(1);
+  }
+  U acc = 0;
+  for (auto const & p_ : partial) {
+    acc = binary_gcd_magnitude(acc, p_.value);
+  }
+  return static_cast<T>(acc);
+}
+
+//  Convenience overloads running on default_pool().
+template <gcd_type T>
+void parallel_gcd(std::span<T const> a_, std::span<T const> b_, std::span<T> out) {
+  parallel_gcd(default_pool(), a_, b_, out);
+}
+
+template <gcd_type T>
+T parallel_gcd_reduce(std::span<T const> s_) {
+  return parallel_gcd_reduce(default_pool(), s_);
+}
+
+} /* namespace cfnum */
+
+#endif /* gcd_lcm_hpp */
@@ -0,0 +1,276 @@
+//
+//  index_fill.hpp
+//  CF.STL_Numeric
+//
+//  MARK: - References.
+//  @see: https://en.cppreference.com/w/cpp/algorithm/iota
+//  @see: https://en.cppreference.com/w/cpp/algorithm/generate
+//  @see: https://gcc.gnu.org/onlinedocs/gcc/x86-Built-in-Functions.html (movntdq: non-temporal stores)
+//
+
+#ifndef index_fill_hpp
+#define index_fill_hpp
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <numeric>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#include "thread_pool.hpp"
+#include "parallel_reduce.hpp"
+#include "simd_kernels.hpp"
+
+namespace cfnum {
+
+//  A fill only writes, so chunks need to be larger than a reduction's before a
+//  thread pays for its hand-off.
+inline constexpr std::size_t fill_grain = 65'536;
+
+//  Fills of more than this many bytes bypass the cache (non-temporal stores):
+//  they would evict it anyway, and a normal store first reads every line it
+//  writes, which costs a third of the bandwidth.
+inline constexpr std::size_t stream_bytes = std::size_t(32) << 20;
+
+namespace simd::detail {
+
+//  Store of one vector, non-temporal when Stream is set (p then aligned to Bytes).
+template <std::size_t Bytes, bool Stream, typename V, typename U>
+[[gnu::always_inline]] inline void store(U * p_, V const & v_) noexcept {
+#if defined(CFNUM_SIMD_X86)
+  if constexpr (Stream) {
+    using Q = typename vec<long long, Bytes>::type;
+    if constexpr (Bytes == 64) {
+      __builtin_ia32_movntdq512(reinterpret_cast<Q *>(p_), Q(v_));
+    }
+    else if constexpr (Bytes == 32) {
+      __builtin_ia32_movntdq256(reinterpret_cast<Q *>(p_), Q(v_));
+    }
+    else {
+      __builtin_ia32_movntdq(reinterpret_cast<Q *>(p_), Q(v_));
+    }
+    return;
+  }
+#endif
+  std::memcpy(p_, &v_, sizeof(V));
+}
+
+//  v, v + 1, ... into p[0, n); returns the value after the last.  Four vectors
+//  in flight, each stepped by 4 L per iteration, so no lane waits on another.
+//  Streaming fills first store singly up to a vector boundary and fence at the
+//  end, so the data is visible to whichever thread reads it next.
+template <std::size_t Bytes, bool Stream, typename U>
+[[gnu::always_inline]] inline U iota_kernel(U * p_, std::size_t n_, U v_) noexcept {
+  using V = typename vec<U, Bytes>::type;
+  constexpr std::size_t L = vec<U, Bytes>::lanes;
+  std::size_t i_ = 0;
+  if constexpr (Stream) {
+    for (; i_ < n_ && reinterpret_cast<std::uintptr_t>(p_ + i_) % Bytes != 0; ++i_) {
+      p_[i_] = v_;
+      v_ += U(1);
+    }
+  }
+  V x0 = V {} + v_;
+  for (std::size_t l_ = 0; l_ < L; ++l_) {
+    x0[l_] += U(l_);
+  }
+  V const d1 = V {} + U(L);
+  V const d4 = V {} + U(4 * L);
+  V x1 = x0 + d1;
+  V x2 = x1 + d1;
+  V x3 = x2 + d1;
+  for (; i_ + 4 * L <= n_; i_ += 4 * L) {
+    store<Bytes, Stream>(p_ + i_, x0);
+    store<Bytes, Stream>(p_ + i_ + L, x1);
+    store<Bytes, Stream>(p_ + i_ + 2 * L, x2);
+    store<Bytes, Stream>(p_ + i_ + 3 * L, x3);
+    x0 += d4;
+    x1 += d4;
+    x2 += d4;
+    x3 += d4;
+  }
+  for (; i_ + L <= n_; i_ += L) {
+    store<Bytes, Stream>(p_ + i_, x0);
+    x0 += d1;
+  }
+  v_ = x0[0];
+  for (; i_ < n_; ++i_) {
+    p_[i_] = v_;
+    v_ += U(1);
+  }
+#if defined(CFNUM_SIMD_X86)
+  if constexpr (Stream) {
+    __builtin_ia32_sfence();
+  }
+#endif
+  return v_;
+}
+
+template <typename U>
+inline U iota_scalar(U * p_, std::size_t n_, U v_) noexcept {
+  for (std::size_t i_ = 0; i_ < n_; ++i_) {
+    p_[i_] = v_;
+    v_ += U(1);
+  }
+  return v_;
+}
+
+#if defined(CFNUM_SIMD_X86)
+template <bool Stream, typename U>
+[[gnu::target("avx512f,avx512dq")]] U iota_avx512(U * p_, std::size_t n_, U v_) noexcept {
+  return iota_kernel<64, Stream>(p_, n_, v_);
+}
+
+template <bool Stream, typename U>
+[[gnu::target("avx2,fma")]] U iota_avx2(U * p_, std::size_t n_, U v_) noexcept {
+  return iota_kernel<32, Stream>(p_, n_, v_);
+}
+#endif
+
+template <bool Stream, typename U>
+inline U iota_dispatch(U * p_, std::size_t n_, U v_) noexcept {
+  switch (active_isa()) {
+#if defined(CFNUM_SIMD_X86)
+    case isa::avx512: return iota_avx512<Stream>(p_, n_, v_);
+    case isa::avx2:   return iota_avx2<Stream>(p_, n_, v_);
+    case isa::sse2:   return iota_kernel<16, Stream>(p_, n_, v_);
+#elif defined(CFNUM_SIMD_NEON)
+    case isa::neon:   return iota_kernel<16, false>(p_, n_, v_);
+#endif
+    default:          return iota_scalar(p_, n_, v_);
+  }
+}
+
+//  stream_ is decided by the caller from the size of the whole fill, so every
+//  chunk of a parallel one takes the same path.
+template <kernel_type T>
+inline T iota_span(std::span<T> s_, T value, bool stream_) noexcept {
+  using U = lane_t<T>;
+  U * const p_ = reinterpret_cast<U *>(s_.data());
+  U const v_ = static_cast<U>(value);
+  return static_cast<T>(stream_ ? iota_dispatch<true>(p_, s_.size(), v_)
+                                : iota_dispatch<false>(p_, s_.size(), v_));
+}
+
+} /* namespace simd::detail */
+
+namespace simd {
+
+/*
+ *  MARK: simd::iota()
+ *
+ *  std::iota over a span: s[i] = value + i, a vector of consecutive values
+ *  stored per step.  Integers wrap like the unsigned type; floating point
+ *  matches std::iota as long as every value is an exact integer in T.  Returns
+ *  the value after the last, so consecutive spans can continue the sequence.
+ */
+template <kernel_type T>
+T iota(std::span<T> s_, T value) noexcept {
+  return detail::iota_span(s_, value, s_.size_bytes() > stream_bytes);
+}
+
+} /* namespace simd */
+
+/*
+ *  MARK: parallel_iota()
+ *
+ *  Chunks filled on the pool, each starting from value + its offset, so the
+ *  result is exactly that of std::iota.  Contiguous kernel_type ranges take
+ *  the simd kernel; any other random-access range works for a value type with
+ *  value + n (integers, floating point, random-access iterators).
+ */
+template <simd::kernel_type T>
+void parallel_iota(thread_pool & pool, std::span<T> s_, T value, std::size_t grain = fill_grain) {
+  bool const stream_ = s_.size_bytes() > stream_bytes;
+  std::size_t const chunks = detail::chunk_count(s_.size(), pool.size(), grain);
+  if (chunks == 1) {
+    simd::detail::iota_span(s_, value, stream_);
+    return;
+  }
+  pool.parallel_for(chunks, [&](std::size_t c_) {
+    std::size_t const lo = s_.size() * c_ / chunks;
+    std::size_t const hi = s_.size() * (c_ + 1) / chunks;
+    using U = simd::detail::lane_t<T>;
+    T const v_ = static_cast<T>(static_cast<U>(static_cast<U>(value) + static_cast<U>(lo)));
+    simd::detail::iota_span(s_.subspan(lo, hi - lo), v_, stream_);
+  });
+}
+
+template <std::random_access_iterator RandomIt, typename T>
+  requires requires(T v_, std::iter_difference_t<RandomIt> d_) { *std::declval<RandomIt>() = v_ + d_; }
+void parallel_iota(thread_pool & pool, RandomIt first, RandomIt last, T value, std::size_t grain = fill_grain) {
+  using V = std::iter_value_t<RandomIt>;
+  if constexpr (std::contiguous_iterator<RandomIt> && simd::kernel_type<V> && std::is_convertible_v<T, V>) {
+    parallel_iota(pool, std::span<V>(std::to_address(first), static_cast<std::size_t>(last - first)),
+                  static_cast<V>(value), grain);
+  }
+  else {
+    using D = std::iter_difference_t<RandomIt>;
+    std::size_t const n_ = static_cast<std::size_t>(last - first);
+    std::size_t const chunks = detail::chunk_count(n_, pool.size(), grain);
+    pool.parallel_for(chunks, [&](std::size_t c_) {
+      std::size_t const lo = n_ * c_ / chunks;
+      std::size_t const hi = n_ * (c_ + 1) / chunks;
+      std::iota(first + D(lo), first + D(hi), value + D(lo));
+    });
+  }
+}
+
+template <simd::kernel_type T>
+void parallel_iota(std::span<T> s_, T value) {
+  parallel_iota(default_pool(), s_, value);
+}
+
+template <std::random_access_iterator RandomIt, typename T>
+void parallel_iota(RandomIt first, RandomIt last, T value) {
+  parallel_iota(default_pool(), first, last, value);
+}
+
+/*
+ *  MARK: parallel_generate(), parallel_tabulate()
+ *
+ *  std::generate with a generator per chunk rather than one shared by every
+ *  thread: make(offset) returns the generator for the chunk starting at that
+ *  offset (a counter started there, a random engine seeded or skipped ahead by
+ *  it), and it is called in order across the chunk.  As long as what make
+ *  returns depends only on the offset, the result is the same on any pool.
+ *  parallel_tabulate is the common case, s[i] = fn(i).
+ */
+template <std::random_access_iterator RandomIt, typename Make>
+void parallel_generate(thread_pool & pool, RandomIt first, RandomIt last, Make make,
+                       std::size_t grain = fill_grain) {
+  using D = std::iter_difference_t<RandomIt>;
+  std::size_t const n_ = static_cast<std::size_t>(last - first);
+  std::size_t const chunks = detail::chunk_count(n_, pool.size(), grain);
+  pool.parallel_for(chunks, [&](std::size_t c_) {
+    std::size_t const lo = n_ * c_ / chunks;
+    std::size_t const hi = n_ * (c_ + 1) / chunks;
+    std::generate(first + D(lo), first + D(hi), make(lo));
+  });
+}
+
+template <std::random_access_iterator RandomIt, typename Fn>
+void parallel_tabulate(thread_pool & pool, RandomIt first, RandomIt last, Fn fn,
+                       std::size_t grain = fill_grain) {
+  parallel_generate(pool, first, last, [&fn](std::size_t lo) {
+    return [&fn, i_ = lo]() mutable { return fn(i_++); };
+  }, grain);
+}
+
+template <std::random_access_iterator RandomIt, typename Make>
+void parallel_generate(RandomIt first, RandomIt last, Make make) {
+  parallel_generate(default_pool(), first, last, make);
+}
+
+template <std::random_access_iterator RandomIt, typename Fn>
+void parallel_tabulate(RandomIt first, RandomIt last, Fn fn) {
+  parallel_tabulate(default_pool(), first, last, fn);
+}
+
+} /* namespace cfnum */
+
+#endif /* index_fill_hpp */
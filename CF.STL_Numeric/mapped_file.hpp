@@ -0,0 +1,158 @@
+//
+//  mapped_file.hpp
+//  CF.STL_Numeric
+//
+//  MARK: - References.
+//  @see: https://pubs.opengroup.org/onlinepubs/9699919799/functions/mmap.html
+//  @see: https://man7.org/linux/man-pages/man2/madvise.2.html
+//
+
+#ifndef mapped_file_hpp
+#define mapped_file_hpp
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace cfnum {
+
+/*
+ *  MARK: mapped_file
+ *
+ *  RAII wrapper round a whole-file mmap.  Like std::ifstream, a failed open
+ *  leaves an object that tests false rather than throwing.
+ *    read_only   maps an existing file PROT_READ
+ *    read_write  creates/truncates the file to `size` bytes and maps it shared
+ */
+class mapped_file {
+public:
+  enum class mode { read_only, read_write, };
+
+  //  Access-pattern hints passed through to madvise().
+  enum class advice { normal, sequential, random, will_need, dont_need, huge_pages, };
+
+  mapped_file() = default;
+
+  explicit mapped_file(std::string const & path, mode m_ = mode::read_only, std::size_t size = 0) {
+    open(path, m_, size);
+  }
+
+  mapped_file(mapped_file const &) = delete;
+  mapped_file & operator=(mapped_file const &) = delete;
+
+  mapped_file(mapped_file && other) noexcept
+    : data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)),
+      writable_(other.writable_),
+      open_(std::exchange(other.open_, false)) {}
+
+  mapped_file & operator=(mapped_file && other) noexcept {
+    if (this != &other) {
+      close();
+      data_ = std::exchange(other.data_, nullptr);
+      size_ = std::exchange(other.size_, 0);
+      writable_ = other.writable_;
+      open_ = std::exchange(other.open_, false);
+    }
+    return *this;
+  }
+
+  ~mapped_file() { close(); }
+
+  bool open(std::string const & path, mode m_ = mode::read_only, std::size_t size = 0) {
+    close();
+    writable_ = (m_ == mode::read_write);
+    int const fd = writable_ ? ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644)
+                             : ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      return false;
+    }
+    if (writable_) {
+      if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        ::close(fd);
+        return false;
+      }
+    }
+    else {
+      struct stat st;
+      if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+      }
+      size = static_cast<std::size_t>(st.st_size);
+    }
+    if (size != 0) {
+      void * p_ = ::mmap(nullptr, size, writable_ ? PROT_READ | PROT_WRITE : PROT_READ,
+                         MAP_SHARED, fd, 0);
+      if (p_ == MAP_FAILED) {
+        ::close(fd);
+        return false;
+      }
+      data_ = static_cast<std::byte *>(p_);
+    }
+    size_ = size;
+    open_ = true;
+    ::close(fd);            //  the mapping keeps the file referenced
+    return true;
+  }
+
+  void close() noexcept {
+    if (data_ != nullptr) {
+      ::munmap(data_, size_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+    open_ = false;
+  }
+
+  //  Flush dirty pages of a read_write mapping to the file.
+  bool sync() noexcept {
+    return data_ == nullptr || ::msync(data_, size_, MS_SYNC) == 0;
+  }
+
+  //  Apply a hint to [offset, offset + length); the range is widened to whole pages.
+  void advise(advice a_, std::size_t offset = 0, std::size_t length = std::size_t(-1)) const noexcept {
+    if (data_ == nullptr || offset >= size_) {
+      return;
+    }
+    std::size_t const page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    std::size_t const lo = offset / page * page;
+    std::size_t const hi = length > size_ - offset ? size_ : offset + length;
+    int flag = MADV_NORMAL;
+    switch (a_) {
+      case advice::sequential: flag = MADV_SEQUENTIAL; break;
+      case advice::random:     flag = MADV_RANDOM; break;
+      case advice::will_need:  flag = MADV_WILLNEED; break;
+      case advice::dont_need:  flag = MADV_DONTNEED; break;
+#if defined(MADV_HUGEPAGE)
+      case advice::huge_pages: flag = MADV_HUGEPAGE; break;
+#endif
+      default:                 break;
+    }
+    ::madvise(data_ + lo, hi - lo, flag);
+  }
+
+  explicit operator bool() const noexcept { return open_; }
+  bool is_open() const noexcept { return static_cast<bool>(*this); }
+
+  std::byte const * data() const noexcept { return data_; }
+  std::byte * mutable_data() noexcept { return writable_ ? data_ : nullptr; }
+  std::size_t size() const noexcept { return size_; }
+  std::span<std::byte const> bytes() const noexcept { return { data_, size_ }; }
+
+private:
+  std::byte * data_ = nullptr;
+  std::size_t size_ = 0;
+  bool writable_ = false;
+  bool open_ = false;
+};
+
+} /* namespace cfnum */
+
+#endif /* mapped_file_hpp */
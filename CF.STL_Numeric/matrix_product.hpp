@@ -0,0 +1,620 @@
+//
+//  matrix_product.hpp
+//  CF.STL_Numeric
+//
+//  MARK: - References.
+//  @see: https://netlib.org/blas/#_level_2 (gemv), https://netlib.org/blas/#_level_3 (gemm)
+//  @see: Goto & van de Geijn, "Anatomy of High-Performance Matrix Multiplication" (2008)
+//  @see: Van Zee & van de Geijn, "BLIS: A Framework for Rapidly Instantiating BLAS Functionality" (2015)
+//
+
+#ifndef matrix_product_hpp
+#define matrix_product_hpp
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "thread_pool.hpp"
+#include "parallel_reduce.hpp"
+#include "simd_kernels.hpp"
+
+namespace cfnum {
+
+/*
+ *  MARK: matrix_span
+ *
+ *  A non-owning rows x cols view with a stride per dimension, element (i, j)
+ *  at data[i row_stride + j col_stride].  Row-major storage has col_stride 1,
+ *  column-major row_stride 1, and transposed() swaps the two, so A^T costs
+ *  nothing.  T is const for read-only operands.
+ */
+template <typename T>
+struct matrix_span {
+  T * data;
+  std::size_t rows;
+  std::size_t cols;
+  std::size_t row_stride;
+  std::size_t col_stride;
+
+  T & operator()(std::size_t i_, std::size_t j_) const noexcept {
+    return data[i_ * row_stride + j_ * col_stride];
+  }
+
+  matrix_span transposed() const noexcept {
+    return { data, cols, rows, col_stride, row_stride };
+  }
+
+  matrix_span block(std::size_t i_, std::size_t j_, std::size_t rows_, std::size_t cols_) const noexcept {
+    return { data + i_ * row_stride + j_ * col_stride, rows_, cols_, row_stride, col_stride };
+  }
+
+  operator matrix_span<T const>() const noexcept requires (!std::is_const_v<T>) {
+    return { data, rows, cols, row_stride, col_stride };
+  }
+};
+
+//  ld is the distance between rows (row_major) or columns (col_major), at
+//  least cols or rows respectively; a block of a larger matrix keeps the
+//  larger matrix's.
+template <typename T>
+matrix_span<T> row_major(T * data, std::size_t rows, std::size_t cols, std::size_t ld = 0) noexcept {
+  return { data, rows, cols, ld == 0 ? cols : ld, 1 };
+}
+
+template <typename T>
+matrix_span<T> col_major(T * data, std::size_t rows, std::size_t cols, std::size_t ld = 0) noexcept {
+  return { data, rows, cols, 1, ld == 0 ? rows : ld };
+}
+
+//  Cache blocking, in elements.  A gemv takes x gemv_kc columns at a time, so
+//  the part of x every row reads stays in L1; column-major A updates y in
+//  gemv_mb-row slices for the same reason.  A gemm packs gemm_kc x gemm_nc
+//  blocks of B (the micro-panel each tile walks stays in L1) and gemm_mc x
+//  gemm_kc blocks of A (resident in L2 while every B micro-panel passes it).
+inline constexpr std::size_t gemv_kc = 4'096;
+inline constexpr std::size_t gemv_mb = 1'024;
+inline constexpr std::size_t gemm_kc = 256;
+inline constexpr std::size_t gemm_mc = 96;
+inline constexpr std::size_t gemm_nc = 2'048;
+
+//  Register tile of a gemm: gemm_mr rows of C by two vectors, twelve
+//  accumulators, all of C's tile in registers across the whole k loop.
+inline constexpr std::size_t gemm_mr = 6;
+
+namespace detail {
+
+template <typename T>
+inline matrix_span<T const> as_const(matrix_span<T> m_) noexcept {
+  return { m_.data, m_.rows, m_.cols, m_.row_stride, m_.col_stride };
+}
+
+/*
+ *  y[r, r + rows) = A x for row-major A, x read in [0, cols).  Four rows
+ *  share every vector of x loaded, two accumulators each to cover the FMA
+ *  latency; rows left over take dot_kernel.  First overwrites y, otherwise
+ *  the products are added to it (the later column blocks).
+ */
+template <std::size_t Bytes, typename U>
+[[gnu::always_inline]] inline void gemv_rows_kernel(U const * a_, std::size_t lda, std::size_t rows,
+                                                    std::size_t cols, U const * x_, U * y_, bool first) noexcept {
+  using V = typename simd::detail::vec<U, Bytes>::type;
+  constexpr std::size_t L = simd::detail::vec<U, Bytes>::lanes;
+  std::size_t r_ = 0;
+  for (; r_ + 4 <= rows; r_ += 4) {
+    U const * a0 = a_ + r_ * lda;
+    U const * a1 = a0 + lda;
+    U const * a2 = a1 + lda;
+    U const * a3 = a2 + lda;
+    V s0 {}, s1 {}, s2 {}, s3 {}, t0 {}, t1 {}, t2 {}, t3 {};
+    V x0, x1, v0, v1, v2, v3, w0, w1, w2, w3;
+    std::size_t j_ = 0;
+    for (; j_ + 2 * L <= cols; j_ += 2 * L) {
+      simd::detail::load(x0, x_ + j_);
+      simd::detail::load(x1, x_ + j_ + L);
+      simd::detail::load(v0, a0 + j_);
+      simd::detail::load(v1, a1 + j_);
+      simd::detail::load(v2, a2 + j_);
+      simd::detail::load(v3, a3 + j_);
+      simd::detail::load(w0, a0 + j_ + L);
+      simd::detail::load(w1, a1 + j_ + L);
+      simd::detail::load(w2, a2 + j_ + L);
+      simd::detail::load(w3, a3 + j_ + L);
+      s0 += v0 * x0;
+      s1 += v1 * x0;
+      s2 += v2 * x0;
+      s3 += v3 * x0;
+      t0 += w0 * x1;
+      t1 += w1 * x1;
+      t2 += w2 * x1;
+      t3 += w3 * x1;
+    }
+    s0 += t0;
+    s1 += t1;
+    s2 += t2;
+    s3 += t3;
+    U u0 {}, u1 {}, u2 {}, u3 {};
+    for (std::size_t l_ = 0; l_ < L; ++l_) {
+      u0 += s0[l_];
+      u1 += s1[l_];
+      u2 += s2[l_];
+      u3 += s3[l_];
+    }
+    for (; j_ < cols; ++j_) {
+      u0 += a0[j_] * x_[j_];
+      u1 += a1[j_] * x_[j_];
+      u2 += a2[j_] * x_[j_];
+      u3 += a3[j_] * x_[j_];
+    }
+    y_[r_]     = first ? u0 : y_[r_] + u0;
+    y_[r_ + 1] = first ? u1 : y_[r_ + 1] + u1;
+    y_[r_ + 2] = first ? u2 : y_[r_ + 2] + u2;
+    y_[r_ + 3] = first ? u3 : y_[r_ + 3] + u3;
+  }
+  for (; r_ < rows; ++r_) {
+    U const u_ = simd::detail::dot_kernel<Bytes>(a_ + r_ * lda, x_, cols);
+    y_[r_] = first ? u_ : y_[r_] + u_;
+  }
+}
+
+//  y[0, rows) = A x for column-major A: y updated by four columns at a time
+//  (one load and store of y per four multiply-adds), in gemv_mb-row slices.
+template <std::size_t Bytes, typename U>
+[[gnu::always_inline]] inline void gemv_cols_kernel(U const * a_, std::size_t lda, std::size_t rows,
+                                                    std::size_t cols, U const * x_, U * y_) noexcept {
+  using V = typename simd::detail::vec<U, Bytes>::type;
+  constexpr std::size_t L = simd::detail::vec<U, Bytes>::lanes;
+  for (std::size_t i0 = 0; i0 < rows; i0 += gemv_mb) {
+    std::size_t const mb = std::min(gemv_mb, rows - i0);
+    U * y0 = y_ + i0;
+    std::fill(y0, y0 + mb, U {});
+    V y_v, c0, c1, c2, c3;
+    std::size_t j_ = 0;
+    for (; j_ + 4 <= cols; j_ += 4) {
+      U const * p0 = a_ + j_ * lda + i0;
+      U const * p1 = p0 + lda;
+      U const * p2 = p1 + lda;
+      U const * p3 = p2 + lda;
+      V const x0 = V {} + x_[j_];
+      V const x1 = V {} + x_[j_ + 1];
+      V const x2 = V {} + x_[j_ + 2];
+      V const x3 = V {} + x_[j_ + 3];
+      std::size_t i_ = 0;
+      for (; i_ + L <= mb; i_ += L) {
+        simd::detail::load(y_v, y0 + i_);
+        simd::detail::load(c0, p0 + i_);
+        simd::detail::load(c1, p1 + i_);
+        simd::detail::load(c2, p2 + i_);
+        simd::detail::load(c3, p3 + i_);
+        y_v += (c0 * x0 + c1 * x1) + (c2 * x2 + c3 * x3);
+        std::memcpy(y0 + i_, &y_v, sizeof(V));
+      }
+      for (; i_ < mb; ++i_) {
+        y0[i_] += (p0[i_] * x_[j_] + p1[i_] * x_[j_ + 1]) + (p2[i_] * x_[j_ + 2] + p3[i_] * x_[j_ + 3]);
+      }
+    }
+    for (; j_ < cols; ++j_) {
+      U const * p0 = a_ + j_ * lda + i0;
+      for (std::size_t i_ = 0; i_ < mb; ++i_) {
+        y0[i_] += p0[i_] * x_[j_];
+      }
+    }
+  }
+}
+
+/*
+ *  The gemm micro-kernel: C's gemm_mr x 2L tile += the product of a packed
+ *  A micro-panel (kc columns of gemm_mr) and a packed B micro-panel (kc rows
+ *  of 2L).  Per k, two loads of B, gemm_mr broadcasts of A and 2 gemm_mr
+ *  multiply-adds into the accumulators.  The tile goes to t, row by row.
+ */
+template <std::size_t Bytes, typename U>
+[[gnu::always_inline]] inline void gemm_micro_kernel(std::size_t kc, U const * ap, U const * bp, U * t_) noexcept {
+  using V = typename simd::detail::vec<U, Bytes>::type;
+  constexpr std::size_t L = simd::detail::vec<U, Bytes>::lanes;
+  constexpr std::size_t MR = gemm_mr;
+  V c0[MR], c1[MR];
+#pragma GCC unroll 8
+  for (std::size_t r_ = 0; r_ < MR; ++r_) {
+    c0[r_] = V {};
+    c1[r_] = V {};
+  }
+  //  The broadcasts are written x - 0, the identity for every x: V {} + x is
+  //  not (-0 + 0 is +0), so it would keep an add per broadcast, on the ports
+  //  the multiply-adds need.
+  V b0, b1;
+  for (std::size_t k_ = 0; k_ < kc; ++k_) {
+    simd::detail::load(b0, bp + k_ * 2 * L);
+    simd::detail::load(b1, bp + k_ * 2 * L + L);
+#pragma GCC unroll 8
+    for (std::size_t r_ = 0; r_ < MR; ++r_) {
+      V const a_ = ap[k_ * MR + r_] - V {};
+      c0[r_] += a_ * b0;
+      c1[r_] += a_ * b1;
+    }
+  }
+#pragma GCC unroll 8
+  for (std::size_t r_ = 0; r_ < MR; ++r_) {
+    std::memcpy(t_ + r_ * 2 * L, &c0[r_], sizeof(V));
+    std::memcpy(t_ + r_ * 2 * L + L, &c1[r_], sizeof(V));
+  }
+}
+
+template <typename U>
+inline void gemv_rows_scalar(U const * a_, std::size_t lda, std::size_t rows, std::size_t cols,
+                             U const * x_, U * y_, bool first) noexcept {
+  for (std::size_t r_ = 0; r_ < rows; ++r_) {
+    U const u_ = simd::detail::dot_scalar(a_ + r_ * lda, x_, cols);
+    y_[r_] = first ? u_ : y_[r_] + u_;
+  }
+}
+
+template <typename U>
+inline void gemv_cols_scalar(U const * a_, std::size_t lda, std::size_t rows, std::size_t cols,
+                             U const * x_, U * y_) noexcept {
+  std::fill(y_, y_ + rows, U {});
+  for (std::size_t j_ = 0; j_ < cols; ++j_) {
+    for (std::size_t i_ = 0; i_ < rows; ++i_) {
+      y_[i_] += a_[j_ * lda + i_] * x_[j_];
+    }
+  }
+}
+
+//  Scalar tiles are gemm_mr x 4.
+inline constexpr std::size_t gemm_nr_scalar = 4;
+
+template <typename U>
+inline void gemm_micro_scalar(std::size_t kc, U const * ap, U const * bp, U * t_) noexcept {
+  constexpr std::size_t MR = gemm_mr;
+  constexpr std::size_t NR = gemm_nr_scalar;
+  U c_[MR][NR] {};
+  for (std::size_t k_ = 0; k_ < kc; ++k_) {
+    for (std::size_t r_ = 0; r_ < MR; ++r_) {
+      for (std::size_t j_ = 0; j_ < NR; ++j_) {
+        c_[r_][j_] += ap[k_ * MR + r_] * bp[k_ * NR + j_];
+      }
+    }
+  }
+  std::memcpy(t_, c_, sizeof(c_));
+}
+
+#if defined(CFNUM_SIMD_X86)
+template <typename U>
+[[gnu::target("avx512f,avx512dq")]] void gemv_rows_avx512(U const * a_, std::size_t lda, std::size_t rows,
+                                                          std::size_t cols, U const * x_, U * y_,
+                                                          bool first) noexcept {
+  gemv_rows_kernel<64>(a_, lda, rows, cols, x_, y_, first);
+}
+
+template <typename U>
+[[gnu::target("avx2,fma")]] void gemv_rows_avx2(U const * a_, std::size_t lda, std::size_t rows,
+                                                std::size_t cols, U const * x_, U * y_, bool first) noexcept {
+  gemv_rows_kernel<32>(a_, lda, rows, cols, x_, y_, first);
+}
+
+template <typename U>
+[[gnu::target("avx512f,avx512dq")]] void gemv_cols_avx512(U const * a_, std::size_t lda, std::size_t rows,
+                                                          std::size_t cols, U const * x_, U * y_) noexcept {
+  gemv_cols_kernel<64>(a_, lda, rows, cols, x_, y_);
+}
+
+template <typename U>
+[[gnu::target("avx2,fma")]] void gemv_cols_avx2(U const * a_, std::size_t lda, std::size_t rows,
+                                                std::size_t cols, U const * x_, U * y_) noexcept {
+  gemv_cols_kernel<32>(a_, lda, rows, cols, x_, y_);
+}
+
+template <typename U>
+[[gnu::target("avx512f,avx512dq")]] void gemm_micro_avx512(std::size_t kc, U const * ap, U const * bp,
+                                                           U * t_) noexcept {
+  gemm_micro_kernel<64>(kc, ap, bp, t_);
+}
+
+template <typename U>
+[[gnu::target("avx2,fma")]] void gemm_micro_avx2(std::size_t kc, U const * ap, U const * bp, U * t_) noexcept {
+  gemm_micro_kernel<32>(kc, ap, bp, t_);
+}
+#endif
+
+template <typename U>
+inline void gemv_rows(U const * a_, std::size_t lda, std::size_t rows, std::size_t cols,
+                      U const * x_, U * y_, bool first) noexcept {
+  switch (simd::active_isa()) {
+#if defined(CFNUM_SIMD_X86)
+    case simd::isa::avx512: gemv_rows_avx512(a_, lda, rows, cols, x_, y_, first); break;
+    case simd::isa::avx2:   gemv_rows_avx2(a_, lda, rows, cols, x_, y_, first); break;
+    case simd::isa::sse2:   gemv_rows_kernel<16>(a_, lda, rows, cols, x_, y_, first); break;
+#elif defined(CFNUM_SIMD_NEON)
+    case simd::isa::neon:   gemv_rows_kernel<16>(a_, lda, rows, cols, x_, y_, first); break;
+#endif
+    default:                gemv_rows_scalar(a_, lda, rows, cols, x_, y_, first); break;
+  }
+}
+
+template <typename U>
+inline void gemv_cols(U const * a_, std::size_t lda, std::size_t rows, std::size_t cols,
+                      U const * x_, U * y_) noexcept {
+  switch (simd::active_isa()) {
+#if defined(CFNUM_SIMD_X86)
+    case simd::isa::avx512: gemv_cols_avx512(a_, lda, rows, cols, x_, y_); break;
+    case simd::isa::avx2:   gemv_cols_avx2(a_, lda, rows, cols, x_, y_); break;
+    case simd::isa::sse2:   gemv_cols_kernel<16>(a_, lda, rows, cols, x_, y_); break;
+#elif defined(CFNUM_SIMD_NEON)
+    case simd::isa::neon:   gemv_cols_kernel<16>(a_, lda, rows, cols, x_, y_); break;
+#endif
+    default:                gemv_cols_scalar(a_, lda, rows, cols, x_, y_); break;
+  }
+}
+
+//  y = A x for rows [r0, r1) of A, whatever its layout: the kernels for
+//  contiguous rows or columns, a strided loop for anything else.
+template <typename U>
+inline void gemv_panel(matrix_span<U const> a_, U const * x_, U * y_, std::size_t r0, std::size_t r1) noexcept {
+  std::size_t const rows = r1 - r0;
+  if (a_.col_stride == 1) {
+    for (std::size_t j0 = 0; j0 < a_.cols || j0 == 0; j0 += gemv_kc) {
+      std::size_t const kb = std::min(gemv_kc, a_.cols - j0);
+      gemv_rows(a_.data + r0 * a_.row_stride + j0, a_.row_stride, rows, kb, x_ + j0, y_ + r0, j0 == 0);
+    }
+  }
+  else if (a_.row_stride == 1) {
+    gemv_cols(a_.data + r0, a_.col_stride, rows, a_.cols, x_, y_ + r0);
+  }
+  else {
+    for (std::size_t i_ = r0; i_ < r1; ++i_) {
+      U s_ {};
+      for (std::size_t j_ = 0; j_ < a_.cols; ++j_) {
+        s_ += a_(i_, j_) * x_[j_];
+      }
+      y_[i_] = s_;
+    }
+  }
+}
+
+//  A block of A into gemm_mr-row micro-panels, k-major inside each, and a block
+//  of B into NR-column micro-panels, zero-padded at the edges so the
+//  micro-kernel never branches on a partial tile.
+template <typename U>
+inline void pack_a(matrix_span<U const> a_, std::size_t i0, std::size_t mb, std::size_t p0, std::size_t kb,
+                   U * ap) noexcept {
+  constexpr std::size_t MR = gemm_mr;
+  for (std::size_t ip = 0; ip < mb; ip += MR) {
+    std::size_t const mr = std::min(MR, mb - ip);
+    for (std::size_t k_ = 0; k_ < kb; ++k_) {
+      for (std::size_t r_ = 0; r_ < MR; ++r_) {
+        ap[k_ * MR + r_] = r_ < mr ? a_(i0 + ip + r_, p0 + k_) : U {};
+      }
+    }
+    ap += kb * MR;
+  }
+}
+
+template <std::size_t NR, typename U>
+inline void pack_b(matrix_span<U const> b_, std::size_t p0, std::size_t kb, std::size_t j0, std::size_t nb,
+                   U * bp) noexcept {
+  for (std::size_t jp = 0; jp < nb; jp += NR) {
+    std::size_t const nr = std::min(NR, nb - jp);
+    for (std::size_t k_ = 0; k_ < kb; ++k_) {
+      U const * row = &b_(p0 + k_, j0 + jp);
+      if (nr == NR && b_.col_stride == 1) {
+        std::memcpy(bp + k_ * NR, row, NR * sizeof(U));
+      }
+      else {
+        for (std::size_t j_ = 0; j_ < NR; ++j_) {
+          bp[k_ * NR + j_] = j_ < nr ? row[j_ * b_.col_stride] : U {};
+        }
+      }
+    }
+    bp += kb * NR;
+  }
+}
+
+//  The valid mr x nr corner of a tile into C, added to it after the first
+//  k block.
+template <std::size_t NR, typename U>
+inline void store_tile(matrix_span<U> c_, std::size_t i0, std::size_t j0, std::size_t mr, std::size_t nr,
+                       U const * t_, bool first) noexcept {
+  for (std::size_t r_ = 0; r_ < mr; ++r_) {
+    U * row = &c_(i0 + r_, j0);
+    U const * tr = t_ + r_ * NR;
+    if (c_.col_stride == 1) {
+      for (std::size_t j_ = 0; j_ < nr; ++j_) {
+        row[j_] = first ? tr[j_] : row[j_] + tr[j_];
+      }
+    }
+    else {
+      for (std::size_t j_ = 0; j_ < nr; ++j_) {
+        row[j_ * c_.col_stride] = first ? tr[j_] : row[j_ * c_.col_stride] + tr[j_];
+      }
+    }
+  }
+}
+
+/*
+ *  C = A B, blocked as in Goto's algorithm: for each gemm_nc-column block of B
+ *  and gemm_kc-deep slice of it, B's block is packed once, then every
+ *  gemm_mc-row block of A is packed and swept by the micro-kernel, B's
+ *  micro-panels outermost so each is reused from L1 by every A micro-panel.
+ *  The rows of C are split into panels of whole micro-tiles across the pool,
+ *  each packing its own A blocks; the packed B block is shared.
+ */
+template <std::size_t NR, typename U, typename Micro>
+void gemm_blocked(thread_pool * pool, matrix_span<U const> a_, matrix_span<U const> b_, matrix_span<U> c_,
+                  Micro micro) {
+  constexpr std::size_t MR = gemm_mr;
+  std::size_t const m_ = c_.rows;
+  std::size_t const n_ = c_.cols;
+  std::size_t const k_ = a_.cols;
+  if (m_ == 0 || n_ == 0) {
+    return;
+  }
+  if (k_ == 0) {
+    for (std::size_t i_ = 0; i_ < m_; ++i_) {
+      for (std::size_t j_ = 0; j_ < n_; ++j_) {
+        c_(i_, j_) = U {};
+      }
+    }
+    return;
+  }
+  //  A reduction grain of elements per k step is the least work worth a thread.
+  std::size_t const tiles = (m_ + MR - 1) / MR;
+  std::size_t const chunks = pool == nullptr ? 1
+                           : std::min(tiles, chunk_count(m_ * n_ * k_, pool->size(), reduce_grain * gemm_kc));
+  std::size_t const mc_pad = (gemm_mc + MR - 1) / MR * MR;
+  std::size_t const nc_pad = (std::min(gemm_nc, n_) + NR - 1) / NR * NR;
+  std::vector<U> bp(std::min(gemm_kc, k_) * nc_pad);
+  std::vector<U> ap(chunks * mc_pad * std::min(gemm_kc, k_));
+
+  for (std::size_t j0 = 0; j0 < n_; j0 += gemm_nc) {
+    std::size_t const nb = std::min(gemm_nc, n_ - j0);
+    for (std::size_t p0 = 0; p0 < k_; p0 += gemm_kc) {
+      std::size_t const kb = std::min(gemm_kc, k_ - p0);
+      pack_b<NR>(b_, p0, kb, j0, nb, bp.data());
+      auto panel = [&](std::size_t c0) {
+        std::size_t const lo = tiles * c0 / chunks * MR;
+        std::size_t const hi = std::min(m_, tiles * (c0 + 1) / chunks * MR);
+        U * apc = ap.data() + c0 * mc_pad * std::min(gemm_kc, k_);
+        alignas(64) U t_[MR * NR];
+        for (std::size_t i0 = lo; i0 < hi; i0 += gemm_mc) {
+          std::size_t const mb = std::min(gemm_mc, hi - i0);
+          pack_a(a_, i0, mb, p0, kb, apc);
+          for (std::size_t jp = 0; jp < nb; jp += NR) {
+            for (std::size_t ip = 0; ip < mb; ip += MR) {
+              micro(kb, apc + ip * kb, bp.data() + jp * kb, t_);
+              store_tile<NR>(c_, i0 + ip, j0 + jp, std::min(MR, mb - ip), std::min(NR, nb - jp), t_, p0 == 0);
+            }
+          }
+        }
+      };
+      if (chunks == 1) {
+        panel(0);
+      }
+      else {
+        pool->parallel_for(chunks, panel);
+      }
+    }
+  }
+}
+
+template <typename U>
+void gemm_dispatch(thread_pool * pool, matrix_span<U const> a_, matrix_span<U const> b_, matrix_span<U> c_) {
+  switch (simd::active_isa()) {
+#if defined(CFNUM_SIMD_X86)
+    case simd::isa::avx512:
+      gemm_blocked<2 * simd::detail::vec<U, 64>::lanes>(pool, a_, b_, c_, gemm_micro_avx512<U>);
+      break;
+    case simd::isa::avx2:
+      gemm_blocked<2 * simd::detail::vec<U, 32>::lanes>(pool, a_, b_, c_, gemm_micro_avx2<U>);
+      break;
+    case simd::isa::sse2:
+      gemm_blocked<2 * simd::detail::vec<U, 16>::lanes>(pool, a_, b_, c_, gemm_micro_kernel<16, U>);
+      break;
+#elif defined(CFNUM_SIMD_NEON)
+    case simd::isa::neon:
+      gemm_blocked<2 * simd::detail::vec<U, 16>::lanes>(pool, a_, b_, c_, gemm_micro_kernel<16, U>);
+      break;
+#endif
+    default:
+      gemm_blocked<gemm_nr_scalar>(pool, a_, b_, c_, gemm_micro_scalar<U>);
+      break;
+  }
+}
+
+template <typename T>
+inline matrix_span<simd::detail::lane_t<T> const> as_lanes(matrix_span<T const> m_) noexcept {
+  return { reinterpret_cast<simd::detail::lane_t<T> const *>(m_.data), m_.rows, m_.cols, m_.row_stride,
+           m_.col_stride };
+}
+
+template <typename T>
+inline matrix_span<simd::detail::lane_t<T>> as_lanes(matrix_span<T> m_) noexcept
+  requires (!std::is_const_v<T>) {
+  return { reinterpret_cast<simd::detail::lane_t<T> *>(m_.data), m_.rows, m_.cols, m_.row_stride, m_.col_stride };
+}
+
+} /* namespace detail */
+
+/*
+ *  MARK: gemv(), parallel_gemv()
+ *
+ *  y = A x, with x of A.cols elements and y of A.rows.  Row-major A is a batch
+ *  of dot products, four rows at a time against each block of x (the rows
+ *  left over go through simd::dot's kernel); column-major A is a sum of
+ *  columns scaled by x, four at a time into a slice of y.  The parallel
+ *  version gives each thread a panel of rows.  Like simd::dot, the order of
+ *  floating-point additions is unspecified and integers wrap.
+ */
+template <typename TA, typename T = std::remove_const_t<TA>>
+  requires simd::kernel_type<T>
+void gemv(matrix_span<TA> a_, std::type_identity_t<std::span<T const>> x_,
+          std::type_identity_t<std::span<T>> y_) noexcept {
+  using U = simd::detail::lane_t<T>;
+  detail::gemv_panel(detail::as_lanes(detail::as_const(a_)), reinterpret_cast<U const *>(x_.data()),
+                     reinterpret_cast<U *>(y_.data()), 0, a_.rows);
+}
+
+template <typename TA, typename T = std::remove_const_t<TA>>
+  requires simd::kernel_type<T>
+void parallel_gemv(thread_pool & pool, matrix_span<TA> a_, std::type_identity_t<std::span<T const>> x_,
+                   std::type_identity_t<std::span<T>> y_, std::size_t grain = reduce_grain) {
+  using U = simd::detail::lane_t<T>;
+  auto const a0 = detail::as_lanes(detail::as_const(a_));
+  auto const * px = reinterpret_cast<U const *>(x_.data());
+  auto * py = reinterpret_cast<U *>(y_.data());
+  std::size_t const panels = (a_.rows + 3) / 4;
+  std::size_t const chunks = std::min(panels, detail::chunk_count(a_.rows * a_.cols, pool.size(), grain));
+  if (chunks <= 1) {
+    detail::gemv_panel(a0, px, py, 0, a_.rows);
+    return;
+  }
+  pool.parallel_for(chunks, [&](std::size_t c_) {
+    std::size_t const lo = panels * c_ / chunks * 4;
+    std::size_t const hi = std::min(a_.rows, panels * (c_ + 1) / chunks * 4);
+    detail::gemv_panel(a0, px, py, lo, hi);
+  });
+}
+
+/*
+ *  MARK: gemm(), parallel_gemm()
+ *
+ *  C = A B for A m x k, B k x n and C m x n, any of them row-major,
+ *  column-major or transposed (packing copies each block into the order the
+ *  micro-kernel reads).  C must not overlap A or B.  The parallel version
+ *  splits the rows of C into panels across the pool.
+ */
+template <typename TA, typename TB, typename T = std::remove_const_t<TA>>
+  requires simd::kernel_type<T> && std::same_as<std::remove_const_t<TB>, T>
+void gemm(matrix_span<TA> a_, matrix_span<TB> b_, std::type_identity_t<matrix_span<T>> c_) {
+  detail::gemm_dispatch(nullptr, detail::as_lanes(detail::as_const(a_)), detail::as_lanes(detail::as_const(b_)),
+                        detail::as_lanes(c_));
+}
+
+template <typename TA, typename TB, typename T = std::remove_const_t<TA>>
+  requires simd::kernel_type<T> && std::same_as<std::remove_const_t<TB>, T>
+void parallel_gemm(thread_pool & pool, matrix_span<TA> a_, matrix_span<TB> b_,
+                   std::type_identity_t<matrix_span<T>> c_) {
+  detail::gemm_dispatch(&pool, detail::as_lanes(detail::as_const(a_)), detail::as_lanes(detail::as_const(b_)),
+                        detail::as_lanes(c_));
+}
+
+//  Convenience overloads running on default_pool().
+template <typename TA, typename T = std::remove_const_t<TA>>
+  requires simd::kernel_type<T>
+void parallel_gemv(matrix_span<TA> a_, std::type_identity_t<std::span<T const>> x_,
+                   std::type_identity_t<std::span<T>> y_) {
+  parallel_gemv(default_pool(), a_, x_, y_);
+}
+
+template <typename TA, typename TB, typename T = std::remove_const_t<TA>>
+  requires simd::kernel_type<T> && std::same_as<std::remove_const_t<TB>, T>
+void parallel_gemm(matrix_span<TA> a_, matrix_span<TB> b_, std::type_identity_t<matrix_span<T>> c_) {
+  parallel_gemm(default_pool(), a_, b_, c_);
+}
+
+} /* namespace cfnum */
+
+#endif /* matrix_product_hpp */
@@ -0,0 +1,723 @@
+//
+//  mixed_precision.hpp
+//  CF.STL_Numeric
+//
+//  MARK: - References.
+//  @see: https://en.wikipedia.org/wiki/Bfloat16_floating-point_format
+//  @see: https://en.wikipedia.org/wiki/Half-precision_floating-point_format
+//  @see: https://en.cppreference.com/w/cpp/language/list_initialization#Narrowing_conversions
+//  @see: https://gcc.gnu.org/onlinedocs/gcc/Vector-Extensions.html (__builtin_convertvector)
+//  @see: https://fgiesen.wordpress.com/2012/03/28/half-to-float-done-quic/
+//
+
+#ifndef mixed_precision_hpp
+#define mixed_precision_hpp
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "thread_pool.hpp"
+#include "parallel_reduce.hpp"
+#include "parallel_scan.hpp"
+#include "simd_kernels.hpp"
+#include "simd_scan.hpp"
+
+namespace cfnum {
+
+/*
+ *  MARK: bf16, fp16
+ *
+ *  16-bit storage formats; arithmetic on them happens in float.  Widening to
+ *  float is exact and implicit, narrowing from float rounds to nearest-even and
+ *  has to be spelled out.  bf16 is the top half of a float (8-bit exponent, 7
+ *  mantissa bits); fp16 is IEEE binary16 (5-bit exponent, 10 mantissa bits,
+ *  largest finite value 65504).
+ */
+struct bf16 {
+  std::uint16_t bits;
+
+  bf16() noexcept = default;
+
+  explicit constexpr bf16(float f_) noexcept : bits(narrow(f_)) {}
+
+  constexpr operator float() const noexcept {
+    return std::bit_cast<float>(static_cast<std::uint32_t>(bits) << 16);
+  }
+
+  static constexpr std::uint16_t narrow(float f_) noexcept {
+    std::uint32_t const u_ = std::bit_cast<std::uint32_t>(f_);
+    if ((u_ & 0x7fff'ffffu) > 0x7f80'0000u) {
+      return static_cast<std::uint16_t>((u_ >> 16) | 0x40u);
+    }
+    return static_cast<std::uint16_t>((u_ + 0x7fffu + ((u_ >> 16) & 1u)) >> 16);
+  }
+};
+
+struct fp16 {
+  std::uint16_t bits;
+
+  fp16() noexcept = default;
+
+  explicit constexpr fp16(float f_) noexcept : bits(narrow(f_)) {}
+
+  //  The exponent and mantissa shifted into float position read as a float
+  //  2^112 too small, subnormals included; scaling back leaves infinities and
+  //  NaNs at 2^16 and above, where the exponent is filled in.
+  constexpr operator float() const noexcept {
+    std::uint32_t const h_ = bits;
+    float const f_ = std::bit_cast<float>((h_ & 0x7fffu) << 13) * 0x1p112f;
+    std::uint32_t u_ = std::bit_cast<std::uint32_t>(f_);
+    if (f_ >= 65536.0f) {
+      u_ |= 0x7f80'0000u;
+    }
+    return std::bit_cast<float>(u_ | ((h_ & 0x8000u) << 16));
+  }
+
+  static constexpr std::uint16_t narrow(float f_) noexcept {
+    std::uint32_t u_ = std::bit_cast<std::uint32_t>(f_);
+    std::uint32_t const sign = (u_ >> 16) & 0x8000u;
+    u_ &= 0x7fff'ffffu;
+    std::uint32_t o_;
+    if (u_ >= (127u + 16u) << 23) {
+      o_ = u_ > 0x7f80'0000u ? 0x7e00u : 0x7c00u;
+    }
+    else if (u_ < (127u - 14u) << 23) {
+      //  Subnormal or zero: adding 0.5 lines the 10 mantissa bits up at the
+      //  bottom of the float, and the addition itself rounds to nearest-even.
+      constexpr std::uint32_t magic = (127u - 1u) << 23;
+      o_ = std::bit_cast<std::uint32_t>(std::bit_cast<float>(u_) + std::bit_cast<float>(magic)) - magic;
+    }
+    else {
+      o_ = (u_ + (static_cast<std::uint32_t>(15 - 127) << 23) + 0xfffu + ((u_ >> 13) & 1u)) >> 13;
+    }
+    return static_cast<std::uint16_t>(o_ | sign);
+  }
+};
+
+/*
+ *  MARK: accumulator, accumulator_t, non_narrowing
+ *
+ *  The type a sum of T is carried in: float in double, integers narrower than
+ *  64 bits in 64 bits of the same signedness, bf16 and fp16 in float, anything
+ *  else in itself.  Specialise accumulator to opt a type in or out.
+ *
+ *  non_narrowing<From, To> is the rule of brace initialisation: it rejects
+ *  floating to integer, double to float, integer to floating and any integer
+ *  conversion that can lose values.
+ */
+template <typename T>
+struct accumulator { using type = T; };
+
+template <>
+struct accumulator<float> { using type = double; };
+
+template <std::signed_integral T>
+  requires (sizeof(T) < sizeof(std::int64_t))
+struct accumulator<T> { using type = std::int64_t; };
+
+template <std::unsigned_integral T>
+  requires (sizeof(T) < sizeof(std::uint64_t) && !std::same_as<T, bool>)
+struct accumulator<T> { using type = std::uint64_t; };
+
+template <>
+struct accumulator<bf16> { using type = float; };
+
+template <>
+struct accumulator<fp16> { using type = float; };
+
+template <typename T>
+using accumulator_t = typename accumulator<std::remove_cvref_t<T>>::type;
+
+template <typename From, typename To>
+concept non_narrowing = requires(From && x_) { To { std::forward<From>(x_) }; };
+
+namespace simd {
+
+//  Element types with widening kernels, each summed in its accumulator_t.
+template <typename T>
+concept widening_type = std::same_as<T, float> || std::same_as<T, std::int32_t>
+                     || std::same_as<T, bf16> || std::same_as<T, fp16>;
+
+namespace detail {
+
+/*
+ *  Load L stored elements and widen them into a vector of accumulator lanes.
+ *  float and int32_t convert with vcvtps2pd and vpmovsxdq; bf16 is a zero
+ *  extend and a shift; fp16 is the integer and multiply sequence of
+ *  fp16::operator float, so it needs neither F16C nor AVX512-FP16.  Integer
+ *  sums stay in unsigned lanes, as everywhere else, so they wrap.
+ */
+template <typename S>
+struct widen;
+
+//  GCC splits 8-byte vectors into scalars, so at 16 bytes the narrow half is
+//  loaded into the low half of a full register and widened from there:
+//  cvtps2pd, and interleaving with the sign or with zero for the integers.
+template <std::size_t Bytes, typename W, typename S>
+[[gnu::always_inline]] inline void load_low(W & w_, S const * p_) noexcept {
+  static_assert(Bytes == 16);
+  std::uint64_t q_;
+  std::memcpy(&q_, p_, sizeof(q_));
+  w_ = (W) typename vec<std::uint64_t, 16>::type { q_, 0 };
+}
+
+template <>
+struct widen<float> {
+  using lane = double;
+  template <std::size_t Bytes, typename V>
+  [[gnu::always_inline]] static void load(V & v_, float const * p_) noexcept {
+#if defined(CFNUM_SIMD_X86)
+    if constexpr (Bytes == 16) {
+      typename vec<float, 16>::type w_;
+      load_low<Bytes>(w_, p_);
+      v_ = __builtin_ia32_cvtps2pd(w_);
+    }
+    else
+#endif
+    {
+      typename vec<float, Bytes / 2>::type s_;
+      simd::detail::load(s_, p_);
+      v_ = __builtin_convertvector(s_, V);
+    }
+  }
+  static lane scalar(float x_) noexcept { return x_; }
+};
+
+template <>
+struct widen<std::int32_t> {
+  using lane = std::uint64_t;
+  template <std::size_t Bytes, typename V>
+  [[gnu::always_inline]] static void load(V & v_, std::int32_t const * p_) noexcept {
+    if constexpr (Bytes == 16) {
+      typename vec<std::int32_t, 16>::type w_;
+      load_low<Bytes>(w_, p_);
+      v_ = (V) __builtin_shufflevector(w_, w_ >> 31, 0, 4, 1, 5);
+    }
+    else {
+      typename vec<std::int32_t, Bytes / 2>::type s_;
+      simd::detail::load(s_, p_);
+      v_ = (V) __builtin_convertvector(s_, typename vec<std::int64_t, Bytes>::type);
+    }
+  }
+  static lane scalar(std::int32_t x_) noexcept { return static_cast<lane>(static_cast<std::int64_t>(x_)); }
+};
+
+//  bf16 and fp16 bits zero-extended into 32-bit lanes.
+template <std::size_t Bytes, typename W>
+[[gnu::always_inline]] inline void load_u16(W & h_, std::uint16_t const * p_) noexcept {
+  if constexpr (Bytes == 16) {
+    typename vec<std::uint16_t, 16>::type w_;
+    load_low<Bytes>(w_, p_);
+    h_ = (W) __builtin_shufflevector(w_, decltype(w_) {}, 0, 8, 1, 9, 2, 10, 3, 11);
+  }
+  else {
+    typename vec<std::uint16_t, Bytes / 2>::type s_;
+    simd::detail::load(s_, p_);
+    h_ = __builtin_convertvector(s_, W);
+  }
+}
+
+template <>
+struct widen<bf16> {
+  using lane = float;
+  template <std::size_t Bytes, typename V>
+  [[gnu::always_inline]] static void load(V & v_, bf16 const * p_) noexcept {
+    typename vec<std::uint32_t, Bytes>::type h_;
+    load_u16<Bytes>(h_, &p_->bits);
+    v_ = (V) (h_ << 16);
+  }
+  static lane scalar(bf16 x_) noexcept { return x_; }
+};
+
+template <>
+struct widen<fp16> {
+  using lane = float;
+  template <std::size_t Bytes, typename V>
+  [[gnu::always_inline]] static void load(V & v_, fp16 const * p_) noexcept {
+    using W = typename vec<std::uint32_t, Bytes>::type;
+    W h_;
+    load_u16<Bytes>(h_, &p_->bits);
+    v_ = (V) ((h_ & 0x7fffu) << 13) * 0x1p112f;
+    W const special = (W) (v_ >= 65536.0f) & 0x7f80'0000u;
+    v_ = (V) ((W) v_ | special | ((h_ & 0x8000u) << 16));
+  }
+  static lane scalar(fp16 x_) noexcept { return x_; }
+};
+
+template <std::size_t Bytes, typename S>
+[[gnu::always_inline]] inline typename widen<S>::lane widening_sum_kernel(S const * p_, std::size_t n_) noexcept {
+  using A = typename widen<S>::lane;
+  using V = typename vec<A, Bytes>::type;
+  constexpr std::size_t L = vec<A, Bytes>::lanes;
+  V a0 {}, a1 {}, a2 {}, a3 {};
+  V x0, x1, x2, x3;
+  std::size_t i_ = 0;
+  for (; i_ + 4 * L <= n_; i_ += 4 * L) {
+    widen<S>::template load<Bytes>(x0, p_ + i_);
+    widen<S>::template load<Bytes>(x1, p_ + i_ + L);
+    widen<S>::template load<Bytes>(x2, p_ + i_ + 2 * L);
+    widen<S>::template load<Bytes>(x3, p_ + i_ + 3 * L);
+    a0 += x0;
+    a1 += x1;
+    a2 += x2;
+    a3 += x3;
+  }
+  for (; i_ + L <= n_; i_ += L) {
+    widen<S>::template load<Bytes>(x0, p_ + i_);
+    a0 += x0;
+  }
+  a0 = (a0 + a1) + (a2 + a3);
+  A r_ {};
+  for (std::size_t l_ = 0; l_ < L; ++l_) {
+    r_ += a0[l_];
+  }
+  for (; i_ < n_; ++i_) {
+    r_ += widen<S>::scalar(p_[i_]);
+  }
+  return r_;
+}
+
+template <std::size_t Bytes, typename S>
+[[gnu::always_inline]] inline typename widen<S>::lane widening_dot_kernel(S const * a_, S const * b_,
+                                                                          std::size_t n_) noexcept {
+  using A = typename widen<S>::lane;
+  using V = typename vec<A, Bytes>::type;
+  constexpr std::size_t L = vec<A, Bytes>::lanes;
+  V a0 {}, a1 {}, a2 {}, a3 {};
+  V x0, x1, x2, x3, y0, y1, y2, y3;
+  std::size_t i_ = 0;
+  for (; i_ + 4 * L <= n_; i_ += 4 * L) {
+    widen<S>::template load<Bytes>(x0, a_ + i_);
+    widen<S>::template load<Bytes>(x1, a_ + i_ + L);
+    widen<S>::template load<Bytes>(x2, a_ + i_ + 2 * L);
+    widen<S>::template load<Bytes>(x3, a_ + i_ + 3 * L);
+    widen<S>::template load<Bytes>(y0, b_ + i_);
+    widen<S>::template load<Bytes>(y1, b_ + i_ + L);
+    widen<S>::template load<Bytes>(y2, b_ + i_ + 2 * L);
+    widen<S>::template load<Bytes>(y3, b_ + i_ + 3 * L);
+    a0 += x0 * y0;
+    a1 += x1 * y1;
+    a2 += x2 * y2;
+    a3 += x3 * y3;
+  }
+  for (; i_ + L <= n_; i_ += L) {
+    widen<S>::template load<Bytes>(x0, a_ + i_);
+    widen<S>::template load<Bytes>(y0, b_ + i_);
+    a0 += x0 * y0;
+  }
+  a0 = (a0 + a1) + (a2 + a3);
+  A r_ {};
+  for (std::size_t l_ = 0; l_ < L; ++l_) {
+    r_ += a0[l_];
+  }
+  for (; i_ < n_; ++i_) {
+    r_ += widen<S>::scalar(a_[i_]) * widen<S>::scalar(b_[i_]);
+  }
+  return r_;
+}
+
+//  The scan_kernel loop of simd_scan.hpp with a widening load in front.
+template <std::size_t Bytes, typename S>
+[[gnu::always_inline]] inline typename widen<S>::lane widening_scan_kernel(S const * in, typename widen<S>::lane * out,
+                                                                           std::size_t n_,
+                                                                           typename widen<S>::lane carry) noexcept {
+  using A = typename widen<S>::lane;
+  using V = typename vec<A, Bytes>::type;
+  constexpr std::size_t L = vec<A, Bytes>::lanes;
+  V const fill {};
+  V carry_v = carry - V {};
+  V v_;
+  std::size_t i_ = 0;
+  for (; i_ + L <= n_; i_ += L) {
+    widen<S>::template load<Bytes>(v_, in + i_);
+    log_step<1, L, scan_add>(v_, fill);
+    v_ += carry_v;
+    std::memcpy(out + i_, &v_, sizeof(V));
+    broadcast_last<L>(carry_v, v_, std::make_index_sequence<L> {});
+  }
+  carry = carry_v[0];
+  for (; i_ < n_; ++i_) {
+    carry += widen<S>::scalar(in[i_]);
+    out[i_] = carry;
+  }
+  return carry;
+}
+
+template <typename S>
+inline typename widen<S>::lane widening_sum_scalar(S const * p_, std::size_t n_) noexcept {
+  using A = typename widen<S>::lane;
+  A a0 {}, a1 {}, a2 {}, a3 {};
+  std::size_t i_ = 0;
+  for (; i_ + 4 <= n_; i_ += 4) {
+    a0 += widen<S>::scalar(p_[i_]);
+    a1 += widen<S>::scalar(p_[i_ + 1]);
+    a2 += widen<S>::scalar(p_[i_ + 2]);
+    a3 += widen<S>::scalar(p_[i_ + 3]);
+  }
+  for (; i_ < n_; ++i_) {
+    a0 += widen<S>::scalar(p_[i_]);
+  }
+  return (a0 + a1) + (a2 + a3);
+}
+
+template <typename S>
+inline typename widen<S>::lane widening_dot_scalar(S const * a_, S const * b_, std::size_t n_) noexcept {
+  using A = typename widen<S>::lane;
+  A a0 {}, a1 {}, a2 {}, a3 {};
+  std::size_t i_ = 0;
+  for (; i_ + 4 <= n_; i_ += 4) {
+    a0 += widen<S>::scalar(a_[i_]) * widen<S>::scalar(b_[i_]);
+    a1 += widen<S>::scalar(a_[i_ + 1]) * widen<S>::scalar(b_[i_ + 1]);
+    a2 += widen<S>::scalar(a_[i_ + 2]) * widen<S>::scalar(b_[i_ + 2]);
+    a3 += widen<S>::scalar(a_[i_ + 3]) * widen<S>::scalar(b_[i_ + 3]);
+  }
+  for (; i_ < n_; ++i_) {
+    a0 += widen<S>::scalar(a_[i_]) * widen<S>::scalar(b_[i_]);
+  }
+  return (a0 + a1) + (a2 + a3);
+}
+
+template <typename S>
+inline typename widen<S>::lane widening_scan_scalar(S const * in, typename widen<S>::lane * out, std::size_t n_,
+                                                    typename widen<S>::lane carry) noexcept {
+  for (std::size_t i_ = 0; i_ < n_; ++i_) {
+    carry += widen<S>::scalar(in[i_]);
+    out[i_] = carry;
+  }
+  return carry;
+}
+
+#if defined(CFNUM_SIMD_X86)
+template <typename S>
+[[gnu::target("avx512f,avx512dq")]] typename widen<S>::lane widening_sum_avx512(S const * p_, std::size_t n_) noexcept {
+  return widening_sum_kernel<64>(p_, n_);
+}
+
+template <typename S>
+[[gnu::target("avx2,fma")]] typename widen<S>::lane widening_sum_avx2(S const * p_, std::size_t n_) noexcept {
+  return widening_sum_kernel<32>(p_, n_);
+}
+
+template <typename S>
+[[gnu::target("avx512f,avx512dq")]] typename widen<S>::lane widening_dot_avx512(S const * a_, S const * b_,
+                                                                                std::size_t n_) noexcept {
+  return widening_dot_kernel<64>(a_, b_, n_);
+}
+
+template <typename S>
+[[gnu::target("avx2,fma")]] typename widen<S>::lane widening_dot_avx2(S const * a_, S const * b_,
+                                                                      std::size_t n_) noexcept {
+  return widening_dot_kernel<32>(a_, b_, n_);
+}
+
+template <typename S>
+[[gnu::target("avx512f,avx512dq")]] typename widen<S>::lane widening_scan_avx512(S const * in,
+                                                                                 typename widen<S>::lane * out,
+                                                                                 std::size_t n_,
+                                                                                 typename widen<S>::lane carry) noexcept {
+  return widening_scan_kernel<64>(in, out, n_, carry);
+}
+
+template <typename S>
+[[gnu::target("avx2,fma")]] typename widen<S>::lane widening_scan_avx2(S const * in, typename widen<S>::lane * out,
+                                                                       std::size_t n_,
+                                                                       typename widen<S>::lane carry) noexcept {
+  return widening_scan_kernel<32>(in, out, n_, carry);
+}
+#endif
+
+} /* namespace detail */
+
+/*
+ *  MARK: widening_sum(), widening_dot(), widening_inclusive_scan()
+ *
+ *  simd::sum, dot and inclusive_scan with every element widened to its
+ *  accumulator_t as it is loaded: float sums carry double rounding error,
+ *  int32_t sums cannot overflow below 2^32 elements, and bf16 / fp16 data is
+ *  read at half the bytes of float.  Summation order is unspecified, as for
+ *  simd::sum.  The scan writes accumulator_t values; out may not alias in.
+ */
+template <widening_type T>
+inline accumulator_t<T> widening_sum(std::span<T const> s_) noexcept {
+  using R = accumulator_t<T>;
+  T const * p_ = s_.data();
+  std::size_t const n_ = s_.size();
+  switch (active_isa()) {
+#if defined(CFNUM_SIMD_X86)
+    case isa::avx512: return static_cast<R>(detail::widening_sum_avx512(p_, n_));
+    case isa::avx2:   return static_cast<R>(detail::widening_sum_avx2(p_, n_));
+    case isa::sse2:   return static_cast<R>(detail::widening_sum_kernel<16>(p_, n_));
+#elif defined(CFNUM_SIMD_NEON)
+    case isa::neon:   return static_cast<R>(detail::widening_sum_kernel<16>(p_, n_));
+#endif
+    default:          return static_cast<R>(detail::widening_sum_scalar(p_, n_));
+  }
+}
+
+template <widening_type T>
+inline accumulator_t<T> widening_dot(std::span<T const> a_, std::span<T const> b_) noexcept {
+  using R = accumulator_t<T>;
+  T const * pa = a_.data();
+  T const * pb = b_.data();
+  std::size_t const n_ = a_.size() < b_.size() ? a_.size() : b_.size();
+  switch (active_isa()) {
+#if defined(CFNUM_SIMD_X86)
+    case isa::avx512: return static_cast<R>(detail::widening_dot_avx512(pa, pb, n_));
+    case isa::avx2:   return static_cast<R>(detail::widening_dot_avx2(pa, pb, n_));
+    case isa::sse2:   return static_cast<R>(detail::widening_dot_kernel<16>(pa, pb, n_));
+#elif defined(CFNUM_SIMD_NEON)
+    case isa::neon:   return static_cast<R>(detail::widening_dot_kernel<16>(pa, pb, n_));
+#endif
+    default:          return static_cast<R>(detail::widening_dot_scalar(pa, pb, n_));
+  }
+}
+
+template <widening_type T>
+inline accumulator_t<T> widening_inclusive_scan(std::span<T const> in, std::span<accumulator_t<T>> out,
+                                                accumulator_t<T> carry = {}) noexcept {
+  using A = typename detail::widen<T>::lane;
+  T const * pi = in.data();
+  auto * po = reinterpret_cast<A *>(out.data());
+  auto const c_ = static_cast<A>(carry);
+  using R = accumulator_t<T>;
+  switch (active_isa()) {
+#if defined(CFNUM_SIMD_X86)
+    case isa::avx512: return static_cast<R>(detail::widening_scan_avx512(pi, po, in.size(), c_));
+    case isa::avx2:   return static_cast<R>(detail::widening_scan_avx2(pi, po, in.size(), c_));
+    case isa::sse2:   return static_cast<R>(detail::widening_scan_kernel<16>(pi, po, in.size(), c_));
+#elif defined(CFNUM_SIMD_NEON)
+    case isa::neon:   return static_cast<R>(detail::widening_scan_kernel<16>(pi, po, in.size(), c_));
+#endif
+    default:          return static_cast<R>(detail::widening_scan_scalar(pi, po, in.size(), c_));
+  }
+}
+
+} /* namespace simd */
+
+/*
+ *  MARK: parallel_widening_sum(), parallel_widening_dot(), parallel_widening_inclusive_scan()
+ *
+ *  The chunking of parallel_sum and parallel_simd_inclusive_scan over the
+ *  widening kernels; partial results are combined in the accumulator type.
+ */
+template <simd::widening_type T>
+accumulator_t<T> parallel_widening_sum(thread_pool & pool, std::span<T const> s_,
+                                       std::size_t grain = reduce_grain) {
+  using R = accumulator_t<T>;
+  std::size_t const chunks = detail::chunk_count(s_.size(), pool.size(), grain);
+  if (chunks == 1) {
+    return simd::widening_sum(s_);
+  }
+  std::vector<detail::padded<R>> partial(chunks);
+  pool.parallel_for(chunks, [&](std::size_t c_) {
+    std::size_t const lo = s_.size() * c_ / chunks;
+    std::size_t const hi = s_.size() * (c_ + 1) / chunks;
+    partial[c_].value = simd::widening_sum(s_.subspan(lo, hi - lo));
+  });
+  R result {};
+  for (auto const & p_ : partial) {
+    result += p_.value;
+  }
+  return result;
+}
+
+template <simd::widening_type T>
+accumulator_t<T> parallel_widening_dot(thread_pool & pool, std::span<T const> a_, std::span<T const> b_,
+                                       std::size_t grain = reduce_grain) {
+  using R = accumulator_t<T>;
+  std::size_t const n = std::min(a_.size(), b_.size());
+  std::size_t const chunks = detail::chunk_count(n, pool.size(), grain);
+  if (chunks == 1) {
+    return simd::widening_dot(a_, b_);
+  }
+  std::vector<detail::padded<R>> partial(chunks);
+  pool.parallel_for(chunks, [&](std::size_t c_) {
+    std::size_t const lo = n * c_ / chunks;
+    std::size_t const hi = n * (c_ + 1) / chunks;
+    partial[c_].value = simd::widening_dot(a_.subspan(lo, hi - lo), b_.subspan(lo, hi - lo));
+  });
+  R result {};
+  for (auto const & p_ : partial) {
+    result += p_.value;
+  }
+  return result;
+}
+
+template <simd::widening_type T>
+void parallel_widening_inclusive_scan(thread_pool & pool, std::span<T const> in, std::span<accumulator_t<T>> out,
+                                      accumulator_t<T> init = {}, std::size_t grain = scan_grain) {
+  using R = accumulator_t<T>;
+  std::size_t const n = in.size();
+  std::size_t const chunks = detail::chunk_count(n, pool.size(), grain);
+  if (chunks == 1) {
+    simd::widening_inclusive_scan(in, out, init);
+    return;
+  }
+
+  auto bound = [n, chunks](std::size_t c_) { return n * c_ / chunks; };
+  std::vector<R> carry(chunks);
+  carry[0] = init;
+  pool.parallel_for(chunks - 1, [&](std::size_t c_) {
+    carry[c_ + 1] = simd::widening_sum(in.subspan(bound(c_), bound(c_ + 1) - bound(c_)));
+  });
+  for (std::size_t c_ = 1; c_ < chunks; ++c_) {
+    carry[c_] += carry[c_ - 1];
+  }
+  pool.parallel_for(chunks, [&](std::size_t c_) {
+    std::size_t const lo = bound(c_);
+    std::size_t const len = bound(c_ + 1) - lo;
+    simd::widening_inclusive_scan(in.subspan(lo, len), out.subspan(lo, len), carry[c_]);
+  });
+}
+
+template <simd::widening_type T>
+accumulator_t<T> parallel_widening_sum(std::span<T const> s_) {
+  return parallel_widening_sum(default_pool(), s_);
+}
+
+template <simd::widening_type T>
+accumulator_t<T> parallel_widening_dot(std::span<T const> a_, std::span<T const> b_) {
+  return parallel_widening_dot(default_pool(), a_, b_);
+}
+
+template <simd::widening_type T>
+void parallel_widening_inclusive_scan(std::span<T const> in, std::span<accumulator_t<T>> out,
+                                      accumulator_t<T> init = {}) {
+  parallel_widening_inclusive_scan(default_pool(), in, out, init);
+}
+
+namespace detail {
+
+//  init op element, and the element itself, must both fit the accumulator.
+template <typename T, typename Op, typename X>
+inline constexpr bool accumulates_into = non_narrowing<X, T> && non_narrowing<std::invoke_result_t<Op &, T, X>, T>;
+
+//  A contiguous run of widening_type elements summed into its own accumulator.
+template <typename It, typename T, typename Op>
+inline constexpr bool widening_fast_path = std::contiguous_iterator<It>
+  && simd::widening_type<std::iter_value_t<It>> && std::same_as<T, accumulator_t<std::iter_value_t<It>>>
+  && (std::same_as<Op, std::plus<>> || std::same_as<Op, std::plus<T>>);
+
+template <typename It>
+auto as_span(It first, It last) noexcept {
+  return std::span<std::iter_value_t<It> const>(std::to_address(first), static_cast<std::size_t>(last - first));
+}
+
+} /* namespace detail */
+
+/*
+ *  MARK: reduce(), transform_reduce(), inclusive_scan(), exclusive_scan()
+ *
+ *  The std algorithms with the accumulator type checked at compile time.
+ *  std::reduce(first, last, 0, op) over doubles carries its result in int and
+ *  truncates every partial sum; here an init, element or operation result that
+ *  narrows into the accumulator is a static_assert.  The forms without init
+ *  start from accumulator_t of the element type instead of the element type,
+ *  and contiguous float, int32_t, bf16 and fp16 sums go to the widening kernels.
+ *  Call them qualified: unqualified calls also find the std versions by ADL.
+ */
+template <typename InputIt, typename T, typename BinaryOp = std::plus<>>
+T reduce(InputIt first, InputIt last, T init, BinaryOp op = {}) {
+  static_assert(detail::accumulates_into<T, BinaryOp, std::iter_reference_t<InputIt>>,
+                "cfnum::reduce: the elements or op(init, element) narrow into the type of init; "
+                "seed it with cfnum::accumulator_t<element type> {}");
+  if constexpr (detail::widening_fast_path<InputIt, T, BinaryOp>) {
+    return init + simd::widening_sum(detail::as_span(first, last));
+  }
+  else {
+    return std::reduce(first, last, init, op);
+  }
+}
+
+template <typename InputIt>
+accumulator_t<std::iter_value_t<InputIt>> reduce(InputIt first, InputIt last) {
+  return cfnum::reduce(first, last, accumulator_t<std::iter_value_t<InputIt>> {});
+}
+
+template <typename InputIt, typename T, typename BinaryOp, typename UnaryOp>
+T transform_reduce(InputIt first, InputIt last, T init, BinaryOp reduce_op, UnaryOp transform_op) {
+  static_assert(detail::accumulates_into<T, BinaryOp, std::invoke_result_t<UnaryOp &, std::iter_reference_t<InputIt>>>,
+                "cfnum::transform_reduce: transform_op(element) or reduce_op(init, ...) narrows into the type "
+                "of init; seed it with cfnum::accumulator_t<transformed type> {}");
+  return std::transform_reduce(first, last, init, reduce_op, transform_op);
+}
+
+template <typename InputIt1, typename InputIt2, typename T>
+T transform_reduce(InputIt1 first1, InputIt1 last1, InputIt2 first2, T init) {
+  using P = decltype(*first1 * *first2);
+  static_assert(detail::accumulates_into<T, std::plus<>, P>,
+                "cfnum::transform_reduce: the products narrow into the type of init; "
+                "seed it with cfnum::accumulator_t<element type> {}");
+  if constexpr (detail::widening_fast_path<InputIt1, T, std::plus<>> && std::contiguous_iterator<InputIt2>
+                && std::same_as<std::iter_value_t<InputIt1>, std::iter_value_t<InputIt2>>) {
+    auto const a_ = detail::as_span(first1, last1);
+    return init + simd::widening_dot(a_, detail::as_span(first2, first2 + (last1 - first1)));
+  }
+  else {
+    return std::transform_reduce(first1, last1, first2, init);
+  }
+}
+
+template <typename InputIt, typename OutIt, typename BinaryOp, typename T>
+OutIt inclusive_scan(InputIt first, InputIt last, OutIt d_first, BinaryOp op, T init) {
+  static_assert(detail::accumulates_into<T, BinaryOp, std::iter_reference_t<InputIt>>,
+                "cfnum::inclusive_scan: the elements or op(init, element) narrow into the type of init");
+  if constexpr (std::indirectly_readable<OutIt>) {
+    static_assert(non_narrowing<T, std::iter_value_t<OutIt>>,
+                  "cfnum::inclusive_scan: the output elements are narrower than the accumulator");
+  }
+  if constexpr (detail::widening_fast_path<InputIt, T, BinaryOp> && std::contiguous_iterator<OutIt>
+                && std::same_as<std::iter_value_t<OutIt>, T>) {
+    auto const in = detail::as_span(first, last);
+    simd::widening_inclusive_scan(in, std::span<T>(std::to_address(d_first), in.size()), init);
+    return d_first + (last - first);
+  }
+  else {
+    return std::inclusive_scan(first, last, d_first, op, init);
+  }
+}
+
+template <typename InputIt, typename OutIt, typename BinaryOp = std::plus<>>
+OutIt inclusive_scan(InputIt first, InputIt last, OutIt d_first, BinaryOp op = {}) {
+  using A = accumulator_t<std::iter_value_t<InputIt>>;
+  if constexpr (detail::widening_fast_path<InputIt, A, BinaryOp>) {
+    return cfnum::inclusive_scan(first, last, d_first, op, A {});
+  }
+  else {
+    //  Seeded with the first element, not A {}, since A {} need not be op's identity.
+    if (first == last) {
+      return d_first;
+    }
+    A const seed = *first;
+    *d_first = seed;
+    ++d_first;
+    return cfnum::inclusive_scan(std::next(first), last, d_first, op, seed);
+  }
+}
+
+template <typename InputIt, typename OutIt, typename T, typename BinaryOp = std::plus<>>
+OutIt exclusive_scan(InputIt first, InputIt last, OutIt d_first, T init, BinaryOp op = {}) {
+  static_assert(detail::accumulates_into<T, BinaryOp, std::iter_reference_t<InputIt>>,
+                "cfnum::exclusive_scan: the elements or op(init, element) narrow into the type of init");
+  if constexpr (std::indirectly_readable<OutIt>) {
+    static_assert(non_narrowing<T, std::iter_value_t<OutIt>>,
+                  "cfnum::exclusive_scan: the output elements are narrower than the accumulator");
+  }
+  return std::exclusive_scan(first, last, d_first, init, op);
+}
+
+} /* namespace cfnum */
+
+#endif /* mixed_precision_hpp */
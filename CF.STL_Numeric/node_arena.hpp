@@ -0,0 +1,131 @@
+//
+//  node_arena.hpp
+//  CF.STL_Numeric
+//
+//  MARK: - References.
+//  @see: https://en.cppreference.com/w/cpp/memory/monotonic_buffer_resource
+//  @see: https://en.cppreference.com/w/cpp/memory/unsynchronized_pool_resource
+//  @see: https://en.cppreference.com/w/cpp/memory/polymorphic_allocator
+//
+
+#ifndef node_arena_hpp
+#define node_arena_hpp
+
+#include <cstddef>
+#include <memory_resource>
+
+namespace cfnum {
+
+/*
+ *  MARK: counting_resource
+ *
+ *  Passes every request through to upstream and counts it, so the allocations a
+ *  container makes can be measured whichever resource sits underneath.
+ */
+class counting_resource : public std::pmr::memory_resource {
+public:
+  explicit counting_resource(std::pmr::memory_resource * upstream = std::pmr::get_default_resource()) noexcept
+    : upstream_(upstream) {}
+
+  std::size_t allocations() const noexcept { return allocations_; }
+  std::size_t deallocations() const noexcept { return deallocations_; }
+  std::size_t bytes() const noexcept { return bytes_; }
+
+  void reset() noexcept {
+    allocations_ = 0;
+    deallocations_ = 0;
+    bytes_ = 0;
+  }
+
+private:
+  void * do_allocate(std::size_t bytes, std::size_t alignment) override {
+    ++allocations_;
+    bytes_ += bytes;
+    return upstream_->allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void * p_, std::size_t bytes, std::size_t alignment) override {
+    ++deallocations_;
+    upstream_->deallocate(p_, bytes, alignment);
+  }
+
+  bool do_is_equal(std::pmr::memory_resource const & other) const noexcept override {
+    return this == &other;
+  }
+
+  std::pmr::memory_resource * upstream_;
+  std::size_t allocations_ = 0;
+  std::size_t deallocations_ = 0;
+  std::size_t bytes_ = 0;
+};
+
+/*
+ *  MARK: node_arena
+ *
+ *  Nodes carved one after another from large slabs (a monotonic_buffer_resource
+ *  whose slabs grow geometrically from initial_bytes), so a container filled in
+ *  traversal order is laid out in traversal order.  resource() hands out the
+ *  slabs directly and never reuses memory until release(); pool() puts an
+ *  unsynchronized_pool_resource in front of them for containers that erase and
+ *  insert, so freed nodes are recycled.  Neither is thread safe: one arena per
+ *  thread.
+ */
+class node_arena {
+public:
+  explicit node_arena(std::size_t initial_bytes = 64 * 1024,
+                      std::pmr::memory_resource * upstream = std::pmr::get_default_resource())
+    : slabs_(initial_bytes, upstream), pool_(&slabs_) {}
+
+  node_arena(node_arena const &) = delete;
+  node_arena & operator=(node_arena const &) = delete;
+
+  std::pmr::memory_resource * resource() noexcept { return &slabs_; }
+  std::pmr::memory_resource * pool() noexcept { return &pool_; }
+
+  //  Every container using the arena must be gone first.
+  void release() {
+    pool_.release();
+    slabs_.release();
+  }
+
+private:
+  std::pmr::monotonic_buffer_resource slabs_;
+  std::pmr::unsynchronized_pool_resource pool_;
+};
+
+/*
+ *  MARK: relayout()
+ *
+ *  A copy of a node-based pmr container whose nodes are allocated from r_ in
+ *  traversal order: after churn (inserts at either end, random-order keys) the
+ *  original's nodes follow allocation order instead, and a walk over them jumps
+ *  around memory.  Ordered containers are rebuilt from their already sorted
+ *  elements, which takes linear time.
+ */
+template <typename Container>
+Container relayout(Container const & c_, std::pmr::memory_resource * r_) {
+  return Container(c_.begin(), c_.end(), typename Container::allocator_type(r_));
+}
+
+/*
+ *  MARK: node_resource(), set_node_resource()
+ *
+ *  The resource the demos build their node containers from: the default resource
+ *  unless main() installs an arena (--arena).
+ */
+inline std::pmr::memory_resource *& node_resource_ref() noexcept {
+  static std::pmr::memory_resource * r_ = std::pmr::get_default_resource();
+  return r_;
+}
+
+inline std::pmr::memory_resource * node_resource() noexcept {
+  return node_resource_ref();
+}
+
+inline void set_node_resource(std::pmr::memory_resource * r_) noexcept {
+  node_resource_ref() = r_;
+}
+
+} /* namespace cfnum */
+
+#endif /* node_arena_hpp */
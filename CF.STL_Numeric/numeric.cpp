@@ -29,6 +29,39 @@
 #include <cstdint>
 #include <climits>
 #include <cinttypes>
+#include <cstdlib>
+#include <string_view>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <memory_resource>
+
+#include "thread_pool.hpp"
+#include "parallel_reduce.hpp"
+#include "simd_kernels.hpp"
+#include "benchmark.hpp"
+#include "summation.hpp"
+#include "parallel_scan.hpp"
+#include "simd_scan.hpp"
+#include "streaming.hpp"
+#include "column_file.hpp"
+#include "gcd_lcm.hpp"
+#include "fixed_gcd.hpp"
+#include "sequences.hpp"
+#include "bignum.hpp"
+#include "checked_numeric.hpp"
+#include "string_join.hpp"
+#include "compaction.hpp"
+#include "statistics.hpp"
+#include "block_adapter.hpp"
+#include "node_arena.hpp"
+#include "index_fill.hpp"
+#include "recurrence.hpp"
+#include "delta_codec.hpp"
+#include "sparse_dot.hpp"
+#include "matrix_product.hpp"
+#include "mixed_precision.hpp"
+#include "segmented_scan.hpp"
 
 using namespace std::literals::string_literals;
 
@@ -44,6 +77,12 @@ void fn_transform_exclusive_scan_transform_inclusive_scan(void);
 void fn_gcd(void);
 void fn_lcm(void);
 void fn_midpoint(void);
+void fn_simd_kernels(void);
+void fn_summation(void);
+void fn_streaming(void);
+void fn_column_file(void);
+void fn_bignum(void);
+void fn_benchmarks(void);
 
 /*
  *  MARK: main()
@@ -52,6 +91,30 @@ int main(int argc, const char * argv[]) {
   std::cout << "CF.STL_Numeric"s << std::endl;
   std::cout << "C++ version: " << __cplusplus << std::endl;
 
+  //  --threads=N caps the worker count used by the cfnum parallel algorithms.
+  //  --json=FILE / --csv=FILE save every benchmark recorded during the run.
+  //  --arena builds the demos' node containers from a cfnum::node_arena.
+  std::string json_path;
+  std::string csv_path;
+  cfnum::node_arena arena;
+  for (int a_ = 1; a_ < argc; ++a_) {
+    std::string_view arg { argv[a_] };
+    if (arg.starts_with("--threads="s)) {
+      cfnum::set_default_concurrency(std::strtoul(argv[a_] + "--threads="s.size(), nullptr, 10));
+    }
+    else if (arg.starts_with("--json="s)) {
+      json_path = arg.substr("--json="s.size());
+    }
+    else if (arg.starts_with("--csv="s)) {
+      csv_path = arg.substr("--csv="s.size());
+    }
+    else if (arg == "--arena"s) {
+      cfnum::set_node_resource(arena.pool());
+    }
+  }
+  std::cout << "Threads: " << cfnum::default_concurrency() << std::endl;
+  std::cout << "Node containers: " << (cfnum::node_resource() == arena.pool() ? "node_arena"s : "default resource"s) << std::endl;
+
   fn_iota();
   fn_accumulate();
   fn_reduce();
@@ -64,6 +127,22 @@ int main(int argc, const char * argv[]) {
   fn_gcd();
   fn_lcm();
   fn_midpoint();
+  fn_simd_kernels();
+  fn_summation();
+  fn_streaming();
+  fn_column_file();
+  fn_bignum();
+  fn_benchmarks();
+
+  auto report = [](std::string const & path, bool ok_) {
+    std::cout << (ok_ ? "Benchmark results written to "s : "Unable to write "s) << path << std::endl;
+  };
+  if (!json_path.empty()) {
+    report(json_path, cfnum::bench::results().write_json_file(json_path));
+  }
+  if (!csv_path.empty()) {
+    report(csv_path, cfnum::bench::results().write_csv_file(csv_path));
+  }
 
   return 0;
 }
@@ -78,10 +157,10 @@ void fn_iota(void) {
     << '\n'
     << std::endl;
 
-  std::list<int> lst(10);
+  std::pmr::list<int> lst(10, cfnum::node_resource());
   std::iota(lst.begin(), lst.end(), -4);
 
-  std::vector<std::list<int>::iterator> vec(lst.size());
+  std::vector<std::pmr::list<int>::iterator> vec(lst.size());
   std::iota(vec.begin(), vec.end(), lst.begin());
 
   std::shuffle(vec.begin(), vec.end(), std::mt19937{std::random_device{}()});
@@ -98,6 +177,91 @@ void fn_iota(void) {
   }
   std::cout << std::endl;
 
+  //  --------------------------------------------------------------------------------
+  //  Index arrays in parallel: every chunk starts from its own offset instead of
+  //  sharing one counter (see index_fill.hpp)
+  {
+    std::vector<int64_t> idx(16);
+    cfnum::parallel_iota(std::span<int64_t>(idx), int64_t(-4));
+    std::cout << "cfnum::parallel_iota from -4: "s;
+    for (auto n_ : idx) {
+      std::cout << n_ << ' ';
+    }
+    std::cout << std::endl;
+
+    //  Odd numbers: the generator for the chunk at offset lo starts at 2 lo + 1
+    cfnum::parallel_generate(idx.begin(), idx.end(), [](size_t lo) {
+      return [n_ = int64_t(2 * lo + 1)]() mutable { auto const v_ = n_; n_ += 2; return v_; };
+    });
+    std::cout << "cfnum::parallel_generate odd numbers: "s;
+    for (auto n_ : idx) {
+      std::cout << n_ << ' ';
+    }
+    std::cout << std::endl;
+
+    cfnum::parallel_tabulate(idx.begin(), idx.end(), [](size_t i_) { return int64_t(i_ * i_); });
+    std::cout << "cfnum::parallel_tabulate squares: "s;
+    for (auto n_ : idx) {
+      std::cout << n_ << ' ';
+    }
+    std::cout << std::endl;
+  }
+
+  //  --------------------------------------------------------------------------------
+  //  Filling 256 MB index arrays: std::iota and a counting std::generate against
+  //  the vector kernel (which streams past the cache at this size) and the pool
+  {
+    auto run_type = [&]<typename T>(std::string const & type_, size_t n_elem, T first_) {
+      std::vector<T> expect(n_elem);
+      std::vector<T> vt(n_elem);
+      cfnum::bench::options const opts {
+        .warmup = 1, .samples = 5, .min_sample_ms = 0.0,
+        .elements = n_elem, .bytes = n_elem * sizeof(T),
+      };
+      auto const ri = cfnum::bench::run("fn_iota/std::iota "s + type_, opts, [&] {
+        std::iota(expect.begin(), expect.end(), first_);
+        cfnum::bench::do_not_optimize(expect.data());
+      });
+      auto const rg = cfnum::bench::run("fn_iota/std::generate "s + type_, opts, [&] {
+        std::generate(vt.begin(), vt.end(), [n_ = first_]() mutable { return n_++; });
+        cfnum::bench::do_not_optimize(vt.data());
+      });
+      bool const ok_g = vt == expect;
+      std::fill(vt.begin(), vt.end(), T(0));
+      auto const rs = cfnum::bench::run("fn_iota/cfnum::simd::iota "s + type_, opts, [&] {
+        cfnum::simd::iota(std::span<T>(vt), first_);
+        cfnum::bench::do_not_optimize(vt.data());
+      });
+      bool const ok_s = vt == expect;
+      std::fill(vt.begin(), vt.end(), T(0));
+      auto const rp = cfnum::bench::run("fn_iota/cfnum::parallel_iota "s + type_, opts, [&] {
+        cfnum::parallel_iota(std::span<T>(vt), first_);
+        cfnum::bench::do_not_optimize(vt.data());
+      });
+      bool const ok_p = vt == expect;
+      std::fill(vt.begin(), vt.end(), T(0));
+      auto const rn = cfnum::bench::run("fn_iota/cfnum::parallel_generate "s + type_, opts, [&] {
+        cfnum::parallel_generate(vt.begin(), vt.end(), [first_](size_t lo) {
+          return [n_ = T(first_ + T(lo))]() mutable { return n_++; };
+        });
+        cfnum::bench::do_not_optimize(vt.data());
+      });
+      bool const ok_n = vt == expect;
+
+      std::cout << '\n' << "Filling "s << n_elem << ' ' << type_ << " ("s << n_elem * sizeof(T) / 1'000'000 << " MB):"s << '\n';
+      for (auto const & [r_, ok_] : { std::pair { &ri, true }, std::pair { &rg, ok_g }, std::pair { &rs, ok_s },
+                                      std::pair { &rp, ok_p }, std::pair { &rn, ok_n } }) {
+        std::cout << std::setw(40) << r_->name.substr(r_->name.find('/') + 1)
+                  << std::setw(10) << std::setprecision(3) << r_->median_ms() << " ms"s
+                  << std::setw(10) << std::setprecision(3) << ri.median_ns / r_->median_ns << "x"s
+                  << std::setw(10) << std::setprecision(3) << r_->bytes_per_s() * 1e-9 << " GB/s"s
+                  << (ok_ ? "  ok"s : "  MISMATCH"s) << std::setprecision(6) << '\n';
+      }
+    };
+    run_type("int32_t"s, size_t(1) << 26, int32_t(1));
+    run_type("int64_t"s, size_t(1) << 25, int64_t(1));
+  }
+
   std::cout << std::endl;
 
   return;
@@ -115,39 +279,49 @@ void fn_accumulate(void) {
 
   std::vector<int> vec{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, };
 
-  int sum = std::accumulate(vec.begin(), vec.end(), 0);
+  //  Sum, mean, min, max and variance in one pass (see statistics.hpp)
+  auto const stats = cfnum::describe(vec);
+  auto const sum = stats.sum;
 
   int product = std::accumulate(vec.begin(), vec.end(), 1, std::multiplies<int>());
 
-  auto dash_fold = [](std::string a_, int b_) {
-    return std::move(a_) + '-' + std::to_string(b_);
-  };
-
-  std::string as = std::accumulate(std::next(vec.begin()), vec.end(),
-                                   std::to_string(vec[0]), // start with first element
-                                   dash_fold);
+  //  One sizing pass, one allocation, std::to_chars in place (see string_join.hpp);
+  //  the std::accumulate fold it replaces is timed below.
+  std::string as = cfnum::join(vec, "-");
 
-  // Right fold using reverse iterators
-  std::string rs = std::accumulate(std::next(vec.rbegin()), vec.rend(),
-                                   std::to_string(vec.back()), // start with last element
-                                   dash_fold);
+  // Right fold: the elements last to first
+  std::string rs = cfnum::join_right(vec, "-");
 
   std::cout << "sum: "s << sum << '\n'
+            << "mean: "s << stats.mean << ", min: "s << stats.min << ", max: "s << stats.max
+            << ", variance: "s << stats.variance() << '\n'
             << "product: "s << product << '\n'
             << "dash-separated string: "s << as << '\n'
             << "dash-separated string (right-folded): "s << rs << '\n';
 
-  auto avg = static_cast<double>(std::accumulate(vec.begin(), vec.end(), 0)) / vec.size();
-  std::cout << "average: "s << avg << std::endl;
-  for (auto e_ = vec.begin(); e_ != vec.end();) {
-    double cv = *e_;
-    if (cv < avg) {
-      vec.erase(e_);
-    }
-    else {
-      ++e_;
-    }
+  //  --------------------------------------------------------------------------------
+  //  The product of 1 .. n as an int overflows at 13!: where the checked fold stops,
+  //  what the saturating fold clamps to, and how far the widening fold climbs
+  {
+    std::vector<int> factors(40);
+    std::iota(factors.begin(), factors.end(), 1);
+    auto const c_ = cfnum::checked_accumulate(factors.cbegin(), factors.cbegin() + 20, 1, cfnum::checked_multiplies());
+    auto const s_ = cfnum::saturating_accumulate(factors.cbegin(), factors.cbegin() + 20, 1, cfnum::checked_multiplies());
+    auto const w_ = cfnum::widening_accumulate(factors.cbegin(), factors.cbegin() + 20, 1, cfnum::checked_multiplies());
+    auto const x_ = cfnum::widening_accumulate(factors.cbegin(), factors.cend(), 1, cfnum::checked_multiplies());
+    std::cout << "checked product of 1..20: overflow at index "s << c_.index
+              << " (factor "s << factors[c_.index] << "), last fitting value "s << c_.value << '\n'
+              << "saturating product of 1..20: "s << s_.value << ", first clamped at index "s << s_.index << '\n'
+              << "widening product of 1..20: "s << cfnum::to_string(w_.value)
+              << " in "s << w_.bits << " bits (widened at index "s << w_.widened_at << ")"s << '\n'
+              << "widening product of 1..40: "s << (x_ ? "fits"s : "overflows __int128"s)
+              << " at index "s << x_.index << ", 33! = "s << cfnum::to_string(x_.value) << '\n';
   }
+
+  //  One stable compaction against the mean already in stats: erasing element by
+  //  element moved the tail on every erase, O(n^2) (timed below)
+  auto const removed = cfnum::erase_below(vec, stats.mean);
+  std::cout << "average: "s << stats.mean << " ("s << removed << " below it removed)"s << std::endl;
 #ifdef AS_USE_COPY_
   std::copy(vec.begin(), vec.end(), std::ostream_iterator<int>(std::cout, " "));
   std::cout << '\n';
@@ -156,6 +330,252 @@ void fn_accumulate(void) {
   std::cout << '\n';
 #endif
 
+  std::cout << '\n';
+
+  //  --------------------------------------------------------------------------------
+  //  Dash-separated text of 1M ints: the std::accumulate string fold (a std::to_string
+  //  temporary and an append per element) against cfnum::join
+  {
+    size_t constexpr n_elem = 1'000'000;
+    std::vector<int> vi(n_elem);
+    std::mt19937 gen { 1414 };
+    std::generate(vi.begin(), vi.end(), [&] { return static_cast<int>(gen() % 2'000'000) - 1'000'000; });
+    cfnum::bench::options const opts {
+      .warmup = 1, .samples = 7, .min_sample_ms = 0.0,
+      .elements = n_elem, .bytes = 0,
+    };
+
+    auto dash_fold = [](std::string a_, int b_) {
+      return std::move(a_) + '-' + std::to_string(b_);
+    };
+
+    std::string al, ar, jl, jr, jb;
+    auto const r_al = cfnum::bench::run("fn_accumulate/std::accumulate dash_fold"s, opts, [&] {
+      al = std::accumulate(std::next(vi.begin()), vi.end(), std::to_string(vi[0]), dash_fold);
+      cfnum::bench::do_not_optimize(al.data());
+    });
+    auto const r_ar = cfnum::bench::run("fn_accumulate/std::accumulate dash_fold (right)"s, opts, [&] {
+      ar = std::accumulate(std::next(vi.rbegin()), vi.rend(), std::to_string(vi.back()), dash_fold);
+      cfnum::bench::do_not_optimize(ar.data());
+    });
+    auto const r_jl = cfnum::bench::run("fn_accumulate/cfnum::join"s, opts, [&] {
+      jl = cfnum::join(vi, "-");
+      cfnum::bench::do_not_optimize(jl.data());
+    });
+    auto const r_jr = cfnum::bench::run("fn_accumulate/cfnum::join_right"s, opts, [&] {
+      jr = cfnum::join_right(vi, "-");
+      cfnum::bench::do_not_optimize(jr.data());
+    });
+    //  The buffer survives between calls, so after the first no allocation at all.
+    auto const r_jb = cfnum::bench::run("fn_accumulate/cfnum::join_to (reused buffer)"s, opts, [&] {
+      jb.clear();
+      cfnum::join_to(jb, vi.cbegin(), vi.cend(), "-");
+      cfnum::bench::do_not_optimize(jb.data());
+    });
+
+    std::cout << "Joining "s << n_elem << " ints ("s << jl.size() << " characters):"s << '\n';
+    auto row = [&](auto const & r_, bool ok_) {
+      std::cout << std::setw(36) << r_.name.substr(r_.name.find('/') + 1)
+                << std::setw(10) << std::setprecision(3) << r_.median_ms() << " ms"s
+                << std::setw(10) << std::setprecision(3) << r_al.median_ns / r_.median_ns << "x"s
+                << (ok_ ? "  ok"s : "  MISMATCH"s) << std::setprecision(6) << '\n';
+    };
+    row(r_al, true);
+    row(r_ar, true);
+    row(r_jl, jl == al);
+    row(r_jr, jr == ar);
+    row(r_jb, jb == al);
+  }
+
+  //  --------------------------------------------------------------------------------
+  //  Cost of trusting a fold over 16M ints: std::accumulate alone, std::accumulate
+  //  behind the 64-bit validation pass it used to need, and the checked folds
+  {
+    size_t constexpr n_elem = 16'000'000;
+    std::vector<int32_t> vi(n_elem);
+    std::mt19937 gen { 1313 };
+    std::generate(vi.begin(), vi.end(), [&] { return static_cast<int32_t>(gen() % 2'001) - 1'000; });
+    cfnum::bench::options const opts {
+      .warmup = 1, .samples = 7, .min_sample_ms = 0.0,
+      .elements = n_elem, .bytes = n_elem * sizeof(int32_t),
+    };
+    auto row = [](auto const & r_, double base_ns, bool ok_) {
+      std::cout << std::setw(36) << r_.name.substr(r_.name.find('/') + 1)
+                << std::setw(10) << std::setprecision(3) << r_.median_ms() << " ms"s
+                << std::setw(10) << std::setprecision(2) << base_ns / r_.median_ns << "x"s
+                << (ok_ ? "  ok"s : "  MISMATCH"s) << std::setprecision(6) << '\n';
+    };
+
+    int32_t const expect = std::accumulate(vi.cbegin(), vi.cend(), int32_t(0));
+    int32_t got = 0;
+    auto const ru = cfnum::bench::run("fn_accumulate/std::accumulate"s, opts, [&] {
+      got = std::accumulate(vi.cbegin(), vi.cend(), int32_t(0));
+      cfnum::bench::do_not_optimize(got);
+    });
+    auto const rv = cfnum::bench::run("fn_accumulate/validate + std::accumulate"s, opts, [&] {
+      int64_t s_ = 0;
+      bool fits = true;
+      for (auto const x_ : vi) {
+        s_ += x_;
+        fits &= s_ >= INT32_MIN && s_ <= INT32_MAX;
+      }
+      got = fits ? std::accumulate(vi.cbegin(), vi.cend(), int32_t(0)) : 0;
+      cfnum::bench::do_not_optimize(got);
+    });
+    cfnum::fold_result<int32_t> rc_ {};
+    auto const rc = cfnum::bench::run("fn_accumulate/cfnum::checked_accumulate"s, opts, [&] {
+      rc_ = cfnum::checked_accumulate(vi.cbegin(), vi.cend(), int32_t(0));
+      cfnum::bench::do_not_optimize(rc_);
+    });
+    cfnum::fold_result<int32_t> rs_ {};
+    auto const rs = cfnum::bench::run("fn_accumulate/cfnum::saturating_accumulate"s, opts, [&] {
+      rs_ = cfnum::saturating_accumulate(vi.cbegin(), vi.cend(), int32_t(0));
+      cfnum::bench::do_not_optimize(rs_);
+    });
+    cfnum::widening_result<int32_t> rw_ {};
+    auto const rw = cfnum::bench::run("fn_accumulate/cfnum::widening_accumulate"s, opts, [&] {
+      rw_ = cfnum::widening_accumulate(vi.cbegin(), vi.cend(), int32_t(0));
+      cfnum::bench::do_not_optimize(rw_);
+    });
+    std::cout << "Overflow-checked sums over "s << n_elem << " int32_t:"s << '\n';
+    row(ru, ru.median_ns, true);
+    row(rv, ru.median_ns, got == expect);
+    row(rc, ru.median_ns, rc_ && rc_.value == expect);
+    row(rs, ru.median_ns, rs_ && rs_.value == expect);
+    row(rw, ru.median_ns, rw_ && rw_.value == expect && rw_.bits == 32);
+  }
+
+  //  --------------------------------------------------------------------------------
+  //  Drop-below-the-mean on growing vectors: erasing in the loop (with the returned
+  //  iterator) is quadratic, std::erase_if and cfnum::erase_below_mean are linear.
+  //  Every call first restores the input, so the copy is in all of the times.
+  {
+    std::cout << '\n' << "Erase below the mean (median ms per call):"s << '\n'
+              << std::setw(10) << "n"s
+              << std::setw(12) << "erase loop"s
+              << std::setw(14) << "std::erase_if"s
+              << std::setw(12) << "cfnum"s
+              << std::setw(12) << "parallel"s
+              << std::setw(10) << "speedup"s << '\n';
+    std::mt19937 gen { 1515 };
+    for (size_t const n_elem : { 1ul << 10, 1ul << 12, 1ul << 14, 1ul << 16, 1ul << 20, 1ul << 24 }) {
+      std::vector<int> src(n_elem);
+      std::generate(src.begin(), src.end(), [&] { return static_cast<int>(gen() % 2'001) - 1'000; });
+      std::vector<int> work, expect;
+      cfnum::bench::options const opts {
+        .warmup = 1, .samples = n_elem > (1ul << 16) ? 5ul : 9ul, .min_sample_ms = 0.0,
+        .elements = n_elem, .bytes = n_elem * sizeof(int),
+      };
+
+      double loop_ms = 0.0;
+      bool ok_ = true;
+      if (n_elem <= (1ul << 16)) {
+        auto const r_ = cfnum::bench::run("fn_accumulate/erase loop n="s + std::to_string(n_elem), opts, [&] {
+          work = src;
+          double const avg_ = static_cast<double>(std::accumulate(work.begin(), work.end(), 0ll)) / work.size();
+          for (auto e_ = work.begin(); e_ != work.end();) {
+            e_ = *e_ < avg_ ? work.erase(e_) : std::next(e_);
+          }
+          cfnum::bench::do_not_optimize(work.data());
+        });
+        loop_ms = r_.median_ms();
+        expect = work;
+      }
+      auto const re = cfnum::bench::run("fn_accumulate/std::erase_if n="s + std::to_string(n_elem), opts, [&] {
+        work = src;
+        double const avg_ = static_cast<double>(std::accumulate(work.begin(), work.end(), 0ll)) / work.size();
+        std::erase_if(work, [avg_](int x_) { return x_ < avg_; });
+        cfnum::bench::do_not_optimize(work.data());
+      });
+      ok_ &= expect.empty() || work == expect;
+      expect = work;
+      auto const rc = cfnum::bench::run("fn_accumulate/cfnum::erase_below_mean n="s + std::to_string(n_elem), opts, [&] {
+        work = src;
+        cfnum::erase_below_mean(work);
+        cfnum::bench::do_not_optimize(work.data());
+      });
+      ok_ &= work == expect;
+      auto const rp = cfnum::bench::run("fn_accumulate/cfnum::parallel_erase_below_mean n="s + std::to_string(n_elem), opts, [&] {
+        work = src;
+        cfnum::parallel_erase_below_mean(work);
+        cfnum::bench::do_not_optimize(work.data());
+      });
+      ok_ &= work == expect;
+
+      std::cout << std::setw(10) << n_elem << std::setprecision(3);
+      if (loop_ms > 0.0) {
+        std::cout << std::setw(12) << loop_ms;
+      }
+      else {
+        std::cout << std::setw(12) << "-"s;
+      }
+      std::cout << std::setw(14) << re.median_ms()
+                << std::setw(12) << rc.median_ms()
+                << std::setw(12) << rp.median_ms()
+                << std::setw(9) << std::fixed << std::setprecision(1)
+                << (loop_ms > 0.0 ? loop_ms : re.median_ms()) / rc.median_ms() << "x"s
+                << (ok_ ? ""s : "  (mismatch)"s) << std::defaultfloat << std::setprecision(6) << '\n';
+    }
+    std::cout << "(speedup of cfnum over the erase loop, or over std::erase_if where the loop is not run)"s << '\n';
+  }
+
+  //  --------------------------------------------------------------------------------
+  //  Summary statistics of big arrays: the three walks it used to take (sum,
+  //  minmax_element, squared deviations) against the one of cfnum::describe
+  {
+    auto run_type = [&]<typename T>(std::string const & type_, size_t n_elem, T spread) {
+      std::vector<T> vt(n_elem);
+      std::mt19937 gen { 1616 };
+      std::generate(vt.begin(), vt.end(), [&] { return static_cast<T>(gen() % 1'000'001) / spread; });
+      cfnum::bench::options const opts {
+        .warmup = 1, .samples = 7, .min_sample_ms = 0.0,
+        .elements = n_elem, .bytes = n_elem * sizeof(T),
+      };
+      using S = typename cfnum::statistics<T>::sum_type;
+
+      double mean_ = 0.0, var_ = 0.0;
+      T lo_ {}, hi_ {};
+      auto const r3 = cfnum::bench::run("fn_accumulate/three passes "s + type_, opts, [&] {
+        S const s_ = std::accumulate(vt.cbegin(), vt.cend(), S {});
+        auto const [mn, mx] = std::minmax_element(vt.cbegin(), vt.cend());
+        mean_ = static_cast<double>(s_) / static_cast<double>(n_elem);
+        double const m2 = std::accumulate(vt.cbegin(), vt.cend(), 0.0, [mean_](double a_, T x_) {
+          return a_ + (static_cast<double>(x_) - mean_) * (static_cast<double>(x_) - mean_);
+        });
+        var_ = m2 / static_cast<double>(n_elem);
+        lo_ = *mn;
+        hi_ = *mx;
+        cfnum::bench::do_not_optimize(var_);
+      });
+      cfnum::statistics<T> sd, sp;
+      auto const rd = cfnum::bench::run("fn_accumulate/cfnum::describe "s + type_, opts, [&] {
+        sd = cfnum::describe(vt);
+        cfnum::bench::do_not_optimize(sd);
+      });
+      auto const rp = cfnum::bench::run("fn_accumulate/cfnum::parallel_describe "s + type_, opts, [&] {
+        sp = cfnum::parallel_describe(std::span<T const>(vt));
+        cfnum::bench::do_not_optimize(sp);
+      });
+
+      auto same = [&](cfnum::statistics<T> const & st_) {
+        return st_.count == n_elem && st_.min == lo_ && st_.max == hi_
+            && std::abs(st_.mean - mean_) <= 1e-12 * std::abs(mean_)
+            && std::abs(st_.variance() - var_) <= 1e-9 * var_;
+      };
+      std::cout << "Statistics of "s << n_elem << ' ' << type_ << " ("s << n_elem * sizeof(T) / 1'000'000 << " MB):"s << '\n';
+      for (auto const & [r_, ok_] : { std::pair { &r3, true }, std::pair { &rd, same(sd) }, std::pair { &rp, same(sp) } }) {
+        std::cout << std::setw(40) << r_->name.substr(r_->name.find('/') + 1)
+                  << std::setw(10) << std::setprecision(3) << r_->median_ms() << " ms"s
+                  << std::setw(10) << std::setprecision(3) << r3.median_ns / r_->median_ns << "x"s
+                  << std::setw(10) << std::setprecision(3) << r_->bytes_per_s() * 1e-9 << " GB/s"s
+                  << (ok_ ? "  ok"s : "  MISMATCH"s) << std::setprecision(6) << '\n';
+      }
+    };
+    std::cout << '\n';
+    run_type("double"s, 8'000'000, 1'000.0);
+    run_type("int32_t"s, 16'000'000, int32_t(1));
+  }
+
   std::cout << std::endl;
 
   return;
@@ -173,68 +593,240 @@ void fn_reduce(void) {
 
   const std::vector<double> vec(10'000'007, 0.5);
 
-  {
-    const auto t1 = std::chrono::high_resolution_clock::now();
-
-    const double result = std::accumulate(vec.cbegin(), vec.cend(), 0.0);
-
-    const auto t2 = std::chrono::high_resolution_clock::now();
-    const std::chrono::duration<double, std::milli> ms = t2 - t1;
-    std::cout << std::fixed << "std::accumulate result "s << result
-              << " took "s << ms.count() << " ms"s
+  //  Every timing below is warmed up first (the initial pass pays for first-touching
+  //  the 80 MB vector) and reported as min / median / p99 over repeated samples.
+  cfnum::bench::options const opts {
+    .warmup = 2, .samples = 11, .min_sample_ms = 0.0,
+    .elements = vec.size(), .bytes = vec.size() * sizeof(double),
+  };
+  auto report = [](auto const & label, double result, cfnum::bench::result const & r_) {
+    std::cout << std::fixed << label << " result "s << result
+              << " took "s << r_.median_ms() << " ms"s
+              << " (min "s << r_.min_ns * 1e-6 << ", p99 "s << r_.p99_ns * 1e-6 << ")"s
               << std::endl;
-  }
+  };
 
-#if defined(_LIBCPP_HAS_PARALLEL_ALGORITHMS)
   {
-    const auto t1 = std::chrono::high_resolution_clock::now();
-
-    const double result = std::reduce(std::execution::par, v.cbegin(), v.cend());
+    double result = 0.0;
+    auto const r_ = cfnum::bench::run("fn_reduce/std::accumulate"s, opts, [&] {
+      result = std::accumulate(vec.cbegin(), vec.cend(), 0.0);
+      cfnum::bench::do_not_optimize(result);
+    });
+    report("std::accumulate"s, result, r_);
+  }
 
-    const auto t2 = std::chrono::high_resolution_clock::now();
-    const std::chrono::duration<double, std::milli> ms = t2 - t1;
-    std::cout << "std::reduce result "s
-              << result << " took "s << ms.count() << " ms"s
-              << std::endl;
+//  libstdc++ routes std::execution::par through TBB, so it is opt-in there (link with -ltbb).
+#if defined(_LIBCPP_HAS_PARALLEL_ALGORITHMS) || defined(AS_USE_EXECUTION_PAR_)
+  {
+    double result = 0.0;
+    auto const r_ = cfnum::bench::run("fn_reduce/std::reduce(par)"s, opts, [&] {
+      result = std::reduce(std::execution::par, vec.cbegin(), vec.cend());
+      cfnum::bench::do_not_optimize(result);
+    });
+    report("std::reduce"s, result, r_);
   }
 #else
   {
-    const auto t1 = std::chrono::high_resolution_clock::now();
+    double result = 0.0;
+    auto const r_ = cfnum::bench::run("fn_reduce/std::reduce"s, opts, [&] {
+      result = std::reduce(vec.cbegin(), vec.cend());
+      cfnum::bench::do_not_optimize(result);
+    });
+    report("std::reduce"s, result, r_);
+  }
+#endif
 
-    const double result = std::reduce(vec.cbegin(), vec.cend());
+  {
+    double result = 0.0;
+    auto const r_ = cfnum::bench::run("fn_reduce/std::reduce init"s, opts, [&] {
+      result = std::reduce(vec.cbegin(), vec.cend(), 777.7);
+      cfnum::bench::do_not_optimize(result);
+    });
+    report("std::reduce"s, result, r_);
+  }
 
-    const auto t2 = std::chrono::high_resolution_clock::now();
-    const std::chrono::duration<double, std::milli> ms = t2 - t1;
-    std::cout << "std::reduce result "s
-              << result << " took "s << ms.count() << " ms"s
-              << std::endl;
+  //  The type of init is the accumulator: an int 0 here would carry the sum in
+  //  int and truncate every partial result.  cfnum::reduce refuses to compile it.
+  {
+    double result = 0.0;
+    auto const r_ = cfnum::bench::run("fn_reduce/std::reduce lambda"s, opts, [&] {
+      result = std::reduce(vec.cbegin(), vec.cend(), 0.0, [](auto n1, auto n2) {
+        return n1 + n2 * 11.5;
+      });
+      cfnum::bench::do_not_optimize(result);
+    });
+    report("std::reduce"s, result, r_);
   }
-#endif
 
   {
-    const auto t1 = std::chrono::high_resolution_clock::now();
+    double result = 0.0;
+    auto const r_ = cfnum::bench::run("fn_reduce/cfnum::parallel_reduce"s, opts, [&] {
+      result = cfnum::parallel_reduce(vec.cbegin(), vec.cend(), 0.0);
+      cfnum::bench::do_not_optimize(result);
+    });
+    report("cfnum::parallel_reduce"s, result, r_);
+  }
 
-    const double result = std::reduce(vec.cbegin(), vec.cend(), 777.7);
+  //  --------------------------------------------------------------------------------
+  //  Explicit SIMD sum, one row per instruction set this CPU supports
+  {
+    std::cout << '\n' << "cfnum::simd::sum by instruction set:"s << '\n';
+    cfnum::bench::print_header();
+    auto const best = cfnum::simd::detect_isa();
+    for (auto i_ : { cfnum::simd::isa::scalar, cfnum::simd::isa::neon, cfnum::simd::isa::sse2,
+                     cfnum::simd::isa::avx2, cfnum::simd::isa::avx512, }) {
+      if (!cfnum::simd::supports(i_)) {
+        continue;
+      }
+      cfnum::simd::force_isa(i_);
+      cfnum::bench::print(cfnum::bench::run("fn_reduce/cfnum::simd::sum "s + cfnum::simd::isa_name(i_),
+                                            opts, [&] {
+        cfnum::bench::do_not_optimize(cfnum::simd::sum(vec));
+      }));
+    }
+    cfnum::simd::force_isa(best);
+  }
 
-    const auto t2 = std::chrono::high_resolution_clock::now();
-    const std::chrono::duration<double, std::milli> ms = t2 - t1;
-    std::cout << "std::reduce result "s
-              << result << " took "s << ms.count() << " ms"s
-              << std::endl;
+  //  --------------------------------------------------------------------------------
+  //  Speedup of cfnum::parallel_reduce from 1 to N threads
+  {
+    std::cout << '\n' << "cfnum::parallel_reduce scaling:"s << '\n'
+              << std::setw(8) << "threads"s
+              << std::setw(12) << "median ms"s
+              << std::setw(10) << "speedup"s << '\n';
+    double base_ms = 0.0;
+    for (size_t t_ = 1; t_ <= cfnum::default_concurrency(); ++t_) {
+      cfnum::thread_pool pool(t_);
+      double result = 0.0;
+      auto const r_ = cfnum::bench::run("fn_reduce/cfnum::parallel_reduce threads="s + std::to_string(t_),
+                                        opts, [&] {
+        result = cfnum::parallel_reduce(pool, vec.cbegin(), vec.cend(), 0.0);
+        cfnum::bench::do_not_optimize(result);
+      });
+      if (t_ == 1) {
+        base_ms = r_.median_ms();
+      }
+      std::cout << std::setw(8) << t_
+                << std::setw(12) << std::setprecision(3) << r_.median_ms()
+                << std::setw(10) << std::setprecision(2) << base_ms / r_.median_ms()
+                << (result == 0.5 * vec.size() ? ""s : "  (mismatch)"s) << '\n';
+    }
+    std::cout << std::setprecision(6);
   }
 
+  //  --------------------------------------------------------------------------------
+  //  Accumulator types: float summed in float and in double, int32_t in int64_t,
+  //  and the same values stored as bf16 / fp16 and summed in float.  Errors are
+  //  relative to a long double sum of the values as stored
   {
-    const auto t1 = std::chrono::high_resolution_clock::now();
+    std::size_t const n = 8'000'000;
+    std::mt19937 gen { 24 };
+    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+    std::vector<float> vf(n);
+    std::generate(vf.begin(), vf.end(), [&] { return dist(gen); });
+    std::vector<std::int32_t> vi(n);
+    //  Below 2^28, so the int32_t total overflows but no two elements do: libstdc++'s
+    //  std::reduce adds elements in pairs before they meet init, so an int64_t init
+    //  alone does not protect values near 2^31.  cfnum::reduce widens each element.
+    std::generate(vi.begin(), vi.end(), [&] { return static_cast<std::int32_t>(gen() >> 4); });
+    std::vector<cfnum::bf16> vb(n);
+    std::vector<cfnum::fp16> vh(n);
+    std::transform(vf.cbegin(), vf.cend(), vb.begin(), [](float x_) { return cfnum::bf16(x_); });
+    std::transform(vf.cbegin(), vf.cend(), vh.begin(), [](float x_) { return cfnum::fp16(x_); });
+    auto exact = [](auto const & v_) {
+      long double s_ = 0.0L;
+      for (auto x_ : v_) {
+        s_ += static_cast<float>(x_);
+      }
+      return s_;
+    };
+    long double const ef = exact(vf);
+    long double const eb = exact(vb);
+    long double const eh = exact(vh);
+    std::int64_t const ei = std::accumulate(vi.cbegin(), vi.cend(), std::int64_t(0));
+
+    cfnum::bench::options const o_ { .warmup = 1, .samples = 9, .min_sample_ms = 1.0, };
+    std::cout << '\n' << "Accumulator types, "s << n << " elements ("s
+              << cfnum::simd::isa_name(cfnum::simd::active_isa()) << ", "s
+              << cfnum::default_concurrency() << " threads):"s << '\n';
+    auto row = [&](cfnum::bench::result const & r_, cfnum::bench::result const & base, std::size_t bytes,
+                   std::string const & check) {
+      std::cout << std::setw(40) << r_.name.substr(r_.name.find('/') + 1)
+                << std::setw(10) << std::setprecision(3) << r_.median_ms() << " ms"s
+                << std::setw(10) << std::setprecision(3) << base.median_ns / r_.median_ns << "x"s
+                << std::setw(10) << std::setprecision(3) << double(bytes) / r_.median_ns << " GB/s"s
+                << "  "s << check << std::setprecision(6) << '\n';
+    };
+    auto error = [](long double sum_, long double exact_) {
+      std::ostringstream os;
+      os << "rel. error "s << std::scientific << std::setprecision(1)
+         << static_cast<double>(std::abs((sum_ - exact_) / exact_));
+      return os.str();
+    };
 
-    const double result = std::reduce(vec.cbegin(), vec.cend(), 0, [](auto n1, auto n2) {
-      return n1 + n2 * 11.5;
+    float sf = 0.0f;
+    double sd = 0.0;
+    double sw = 0.0;
+    double sp = 0.0;
+    float sb = 0.0f;
+    float sh = 0.0f;
+    auto const rf = cfnum::bench::run("fn_reduce/std::reduce float, float init"s, o_, [&] {
+      sf = std::reduce(vf.cbegin(), vf.cend(), 0.0f);
+      cfnum::bench::do_not_optimize(sf);
     });
-
-    const auto t2 = std::chrono::high_resolution_clock::now();
-    const std::chrono::duration<double, std::milli> ms = t2 - t1;
-    std::cout << "std::reduce result "s
-              << result << " took "s << ms.count() << " ms"s
-              << std::endl;
+    auto const rd = cfnum::bench::run("fn_reduce/std::reduce float, double init"s, o_, [&] {
+      sd = std::reduce(vf.cbegin(), vf.cend(), 0.0);
+      cfnum::bench::do_not_optimize(sd);
+    });
+    auto const rw = cfnum::bench::run("fn_reduce/cfnum::reduce float"s, o_, [&] {
+      sw = cfnum::reduce(vf.cbegin(), vf.cend());
+      cfnum::bench::do_not_optimize(sw);
+    });
+    auto const rp = cfnum::bench::run("fn_reduce/parallel_widening_sum float"s, o_, [&] {
+      sp = cfnum::parallel_widening_sum(std::span<float const>(vf));
+      cfnum::bench::do_not_optimize(sp);
+    });
+    auto const rb = cfnum::bench::run("fn_reduce/widening_sum bf16"s, o_, [&] {
+      sb = cfnum::simd::widening_sum(std::span<cfnum::bf16 const>(vb));
+      cfnum::bench::do_not_optimize(sb);
+    });
+    auto const rh = cfnum::bench::run("fn_reduce/widening_sum fp16"s, o_, [&] {
+      sh = cfnum::simd::widening_sum(std::span<cfnum::fp16 const>(vh));
+      cfnum::bench::do_not_optimize(sh);
+    });
+    row(rf, rf, n * sizeof(float), error(sf, ef));
+    row(rd, rf, n * sizeof(float), error(sd, ef));
+    row(rw, rf, n * sizeof(float), error(sw, ef));
+    row(rp, rf, n * sizeof(float), error(sp, ef));
+    row(rb, rf, n * sizeof(cfnum::bf16), error(sb, eb));
+    row(rh, rf, n * sizeof(cfnum::fp16), error(sh, eh));
+
+    std::int64_t si = 0;
+    std::int64_t sq = 0;
+    auto const ri = cfnum::bench::run("fn_reduce/std::reduce int32_t, int64_t init"s, o_, [&] {
+      si = std::reduce(vi.cbegin(), vi.cend(), std::int64_t(0));
+      cfnum::bench::do_not_optimize(si);
+    });
+    auto const rq = cfnum::bench::run("fn_reduce/cfnum::reduce int32_t"s, o_, [&] {
+      sq = cfnum::reduce(vi.cbegin(), vi.cend());
+      cfnum::bench::do_not_optimize(sq);
+    });
+    row(ri, ri, n * sizeof(std::int32_t), si == ei ? "ok"s : "MISMATCH"s);
+    row(rq, ri, n * sizeof(std::int32_t), sq == ei ? "ok"s : "MISMATCH"s);
+
+    //  Running totals: the int64_t prefix sums of int32_t data, widened on the fly.
+    std::vector<std::int64_t> expect(n);
+    std::vector<std::int64_t> out(n);
+    auto const rs = cfnum::bench::run("fn_reduce/std::inclusive_scan int32_t -> int64_t"s, o_, [&] {
+      std::inclusive_scan(vi.cbegin(), vi.cend(), expect.begin(), std::plus<>(), std::int64_t(0));
+      cfnum::bench::do_not_optimize(expect.data());
+    });
+    auto const rc = cfnum::bench::run("fn_reduce/cfnum::inclusive_scan int32_t"s, o_, [&] {
+      cfnum::inclusive_scan(vi.cbegin(), vi.cend(), out.begin());
+      cfnum::bench::do_not_optimize(out.data());
+    });
+    row(rs, rs, n * (sizeof(std::int32_t) + sizeof(std::int64_t)), "ok"s);
+    row(rc, rs, n * (sizeof(std::int32_t) + sizeof(std::int64_t)), out == expect ? "ok"s : "MISMATCH"s);
   }
 
   std::cout << std::endl;
@@ -275,6 +867,12 @@ void fn_transform_reduce(void) {
   }
 #endif
 
+  {
+    double result = cfnum::simd::dot(xvalues, yvalues);
+    std::cout << "cfnum::simd::dot ("s << cfnum::simd::isa_name(cfnum::simd::active_isa())
+              << ") result "s << result << '\n';
+  }
+
   auto cx = 0;
   auto constexpr cx_max = 25;
   auto pl = [& cx](auto const n) {
@@ -282,20 +880,23 @@ void fn_transform_reduce(void) {
   };
 
   {
-    std::list<int> lstx { 0, 1, 2, 3, 4, };
-    std::list<int> lsty { 5, 4, 2, 3, 1, };
+    std::pmr::list<int> lstx({ 0, 1, 2, 3, 4, }, cfnum::node_resource());
+    std::pmr::list<int> lsty({ 5, 4, 2, 3, 1, }, cfnum::node_resource());
 
+    //  Sums (and the rest of the summary) from one Welford pass per list
     std::cout << "std::list lstx:"s << '\n';
-    auto sumx = std::accumulate(lstx.begin(), lstx.end(), 0);
+    auto const sx = cfnum::describe(lstx);
     cx = 0;
     std::for_each(lstx.begin(), lstx.end(), pl);
-    std::cout << '\n' << "std::accumulate sum "s << sumx << '\n';
+    std::cout << '\n' << "sum "s << sx.sum << ", mean "s << sx.mean
+              << ", min "s << sx.min << ", max "s << sx.max << ", variance "s << sx.variance() << '\n';
 
     std::cout << "std::list lsty:"s << '\n';
-    auto sumy = std::accumulate(lsty.begin(), lsty.end(), 0);
+    auto const sy = cfnum::describe(lsty);
     cx = 0;
     std::for_each(lsty.begin(), lsty.end(), pl);
-    std::cout << '\n' << "std::accumulate sum "s << sumy << '\n';
+    std::cout << '\n' << "sum "s << sy.sum << ", mean "s << sy.mean
+              << ", min "s << sy.min << ", max "s << sy.max << ", variance "s << sy.variance() << '\n';
 
     auto result = std::transform_reduce(lstx.begin(), lstx.end(), lsty.begin(), 0);
     std::cout << "std::transform_reduce lstx lsty "s << result << '\n';
@@ -323,8 +924,8 @@ void fn_transform_reduce(void) {
     auto vtr = std::transform_reduce(vecx.begin(), vecx.end(), vecy.begin(), 0);
     std::cout << "Transform-reduce of vecx and vecy: "s << vtr << "\n\n"s;
 
-    std::list<int> lstx { 0, 1, 2, 3, 4, };
-    std::list<int> lsty { 5, 4, 2, 3, 1, };
+    std::pmr::list<int> lstx({ 0, 1, 2, 3, 4, }, cfnum::node_resource());
+    std::pmr::list<int> lsty({ 5, 4, 2, 3, 1, }, cfnum::node_resource());
 
     std::cout << "std::list lstx & lsty: "s << '\n';
     cx = 0;
@@ -342,8 +943,8 @@ void fn_transform_reduce(void) {
     //  --------------------------------------------------------------------------------
     //  Sum values from 1 - 100, std::list
     //  transform_reduce using BinaryOp (emulates std::plus), UnaryOp (nop)
-    std::list<int> l1(100, 1);
-    std::list<int> l2(100);
+    std::pmr::list<int> l1(100, 1, cfnum::node_resource());
+    std::pmr::list<int> l2(100, cfnum::node_resource());
     size_t cc = 0;
     size_t constexpr cc_max = 25;
     std::for_each(l1.begin(), l1.end(), [& cc](auto n_) {
@@ -429,25 +1030,25 @@ void fn_transform_reduce(void) {
     //  --------------------------------------------------------------------------------
     //  Sum values from 1 - 100, std::forward_list
     //  transform_reduce using defaults
-    std::forward_list<int> f1(100, 1);
-    std::forward_list<int> f2(100);
-    std::generate(f2.begin(), f2.end(), []() { static int n(0); return ++n; });
+    std::pmr::forward_list<int> f1(100, 1, cfnum::node_resource());
+    std::pmr::forward_list<int> f2(100, cfnum::node_resource());
+    std::generate(f2.begin(), f2.end(), [n(0)]() mutable { return ++n; });
     auto trfr =
-    std::transform_reduce(a2.begin(), a2.end(), a1.begin(), 0);
+    std::transform_reduce(f2.begin(), f2.end(), f1.begin(), 0);
     std::cout << std::setw(20) << "std::forward_list "s << trfr << std::endl;
 
     //  --------------------------------------------------------------------------------
-    std::deque<int> d1(100, 1);
-    std::deque<int> d2(100);
+    std::pmr::deque<int> d1(100, 1, cfnum::node_resource());
+    std::pmr::deque<int> d2(100, cfnum::node_resource());
     std::iota(d2.begin(), d2.end(), 1);
     auto trdr =
     std::transform_reduce(d2.begin(), d2.end(), d1.begin(), 0);
     std::cout << std::setw(20) << "std::deque "s << trdr << std::endl;
 
     //  --------------------------------------------------------------------------------
-    std::deque<int> ds(100);
+    std::pmr::deque<int> ds(100, cfnum::node_resource());
     std::iota(ds.begin(), ds.end(), 1);
-    std::set<int> s1;
+    std::pmr::set<int> s1(cfnum::node_resource());
     std::for_each(ds.cbegin(), ds.cend(), [&s1](auto const sn){ s1.insert(sn); });
     auto trsr =
     std::transform_reduce(s1.begin(), s1.end(), d1.cbegin(), 0);
@@ -472,6 +1073,158 @@ void fn_transform_reduce(void) {
     std::cout << std::setw(20) << "std::span "s << trsp << std::endl;
 #endif  /* __cplusplus >= 201707 */
   }
+
+  //  --------------------------------------------------------------------------------
+  //  The containers above at 1M elements: std::reduce and the two-range
+  //  std::transform_reduce against the blocked versions, which read vectors and
+  //  spans in place and gather std::deque and the node-based containers into a
+  //  scratch block before running the simd kernel.  The values are small
+  //  integers, so every summation order gives the same double.
+  {
+    size_t constexpr n_elem = 1'000'000;
+    std::vector<double> vx(n_elem);
+    std::vector<double> vy(n_elem);
+    std::iota(vx.begin(), vx.end(), 0);
+    std::mt19937 gen { 1717 };
+    std::generate(vy.begin(), vy.end(), [&] { return static_cast<double>(gen() % 100); });
+    cfnum::bench::options const opts {
+      .warmup = 1, .samples = 7, .min_sample_ms = 0.0,
+      .elements = n_elem, .bytes = 0,
+    };
+    double const expect_sum = std::reduce(vx.cbegin(), vx.cend(), 0.0);
+    double const expect_dot = std::transform_reduce(vx.cbegin(), vx.cend(), vy.cbegin(), 0.0);
+
+    std::cout << '\n' << "Sum and dot product of "s << n_elem << " double by container (median ms):"s << '\n'
+              << std::setw(26) << "container"s
+              << std::setw(12) << "std::reduce"s << std::setw(10) << "blocked"s << std::setw(9) << "speedup"s
+              << std::setw(16) << "std::tr_reduce"s << std::setw(10) << "blocked"s << std::setw(9) << "speedup"s << '\n';
+    auto row = [&](std::string const & name_, auto const & x_, auto const & y_) {
+      double s1 = 0.0, s2 = 0.0, d1 = 0.0, d2 = 0.0;
+      auto const rs = cfnum::bench::run("fn_transform_reduce/std::reduce "s + name_, opts, [&] {
+        s1 = std::reduce(x_.begin(), x_.end(), 0.0);
+        cfnum::bench::do_not_optimize(s1);
+      });
+      auto const rb = cfnum::bench::run("fn_transform_reduce/cfnum::blocked_reduce "s + name_, opts, [&] {
+        s2 = cfnum::blocked_reduce(x_.begin(), x_.end(), 0.0);
+        cfnum::bench::do_not_optimize(s2);
+      });
+      auto const rt = cfnum::bench::run("fn_transform_reduce/std::transform_reduce "s + name_, opts, [&] {
+        d1 = std::transform_reduce(x_.begin(), x_.end(), y_.begin(), 0.0);
+        cfnum::bench::do_not_optimize(d1);
+      });
+      auto const rd = cfnum::bench::run("fn_transform_reduce/cfnum::blocked_transform_reduce "s + name_, opts, [&] {
+        d2 = cfnum::blocked_transform_reduce(x_.begin(), x_.end(), y_.begin(), 0.0);
+        cfnum::bench::do_not_optimize(d2);
+      });
+      bool const ok_ = s1 == expect_sum && s2 == expect_sum && d1 == expect_dot && d2 == expect_dot;
+      std::cout << std::setw(26) << name_ << std::defaultfloat << std::setprecision(3)
+                << std::setw(12) << rs.median_ms() << std::setw(10) << rb.median_ms()
+                << std::setw(8) << rs.median_ns / rb.median_ns << "x"s
+                << std::setw(16) << rt.median_ms() << std::setw(10) << rd.median_ms()
+                << std::setw(8) << rt.median_ns / rd.median_ns << "x"s
+                << (ok_ ? ""s : "  (mismatch)"s) << std::setprecision(6) << '\n';
+    };
+    {
+      std::pmr::list<double> lx(vx.cbegin(), vx.cend(), cfnum::node_resource());
+      std::pmr::list<double> ly(vy.cbegin(), vy.cend(), cfnum::node_resource());
+      row("std::list"s, lx, ly);
+    }
+    {
+      std::pmr::forward_list<double> fx(vx.cbegin(), vx.cend(), cfnum::node_resource());
+      std::pmr::forward_list<double> fy(vy.cbegin(), vy.cend(), cfnum::node_resource());
+      row("std::forward_list"s, fx, fy);
+    }
+    {
+      std::pmr::deque<double> dx(vx.cbegin(), vx.cend(), cfnum::node_resource());
+      std::pmr::deque<double> dy(vy.cbegin(), vy.cend(), cfnum::node_resource());
+      row("std::deque"s, dx, dy);
+      std::pmr::set<double> sx(vx.cbegin(), vx.cend(), cfnum::node_resource());
+      row("std::set x std::deque"s, sx, dy);
+    }
+    row("std::vector"s, vx, vy);
+    row("std::span"s, std::span<double const>(vx), std::span<double const>(vy));
+  }
+
+  //  --------------------------------------------------------------------------------
+  //  Where the nodes live: a 1M-node list and set walked with std::reduce, built on
+  //  the default resource (also after heap churn has shuffled its free lists), in
+  //  a node_arena, and relaid out into one in traversal order.  Allocations are
+  //  counted where the memory comes from: per node for the default resource, per
+  //  slab for the arena.
+  {
+    size_t constexpr n_elem = 1'000'000;
+    std::vector<double> keys(n_elem);
+    std::iota(keys.begin(), keys.end(), 0.0);
+    double const expect = std::reduce(keys.cbegin(), keys.cend(), 0.0);
+    std::mt19937 gen { 1818 };
+    cfnum::bench::options const opts {
+      .warmup = 1, .samples = 7, .min_sample_ms = 0.0,
+      .elements = n_elem, .bytes = 0,
+    };
+
+    std::cout << '\n' << "Walking "s << n_elem << " nodes by where they were allocated:"s << '\n'
+              << std::setw(44) << "container"s << std::setw(13) << "allocations"s
+              << std::setw(12) << "walk ms"s << std::setw(10) << "speedup"s << '\n';
+    double base_ns = 0.0;
+    auto row = [&](std::string const & name_, auto const & c_, std::size_t allocations, bool base_) {
+      double sum_ = 0.0;
+      auto const r_ = cfnum::bench::run("fn_transform_reduce/walk "s + name_, opts, [&] {
+        sum_ = std::reduce(c_.begin(), c_.end(), 0.0);
+        cfnum::bench::do_not_optimize(sum_);
+      });
+      base_ns = base_ ? r_.median_ns : base_ns;
+      std::cout << std::setw(44) << name_ << std::setw(13) << allocations
+                << std::setw(12) << std::defaultfloat << std::setprecision(3) << r_.median_ms()
+                << std::setw(9) << base_ns / r_.median_ns << "x"s
+                << (sum_ == expect ? ""s : "  (mismatch)"s) << std::setprecision(6) << '\n';
+    };
+
+    {
+      cfnum::counting_resource heap { std::pmr::new_delete_resource() };
+      std::pmr::list<double> l_(keys.cbegin(), keys.cend(), &heap);
+      row("std::pmr::list, default resource"s, l_, heap.allocations(), true);
+    }
+    {
+      //  A million node-sized blocks freed in random order: the next nodes come
+      //  back from the allocator's free lists in that order.
+      std::vector<void *> junk(n_elem);
+      for (auto & p_ : junk) {
+        p_ = ::operator new(sizeof(double) + 2 * sizeof(void *));
+      }
+      std::shuffle(junk.begin(), junk.end(), gen);
+      for (auto p_ : junk) {
+        ::operator delete(p_);
+      }
+      cfnum::counting_resource heap { std::pmr::new_delete_resource() };
+      std::pmr::list<double> l_(keys.cbegin(), keys.cend(), &heap);
+      row("std::pmr::list, default resource, churned"s, l_, heap.allocations(), false);
+
+      cfnum::counting_resource slabs { std::pmr::new_delete_resource() };
+      cfnum::node_arena arena_ { 64 * 1024, &slabs };
+      auto const r_ = cfnum::relayout(l_, arena_.resource());
+      row("  relaid out into a node_arena"s, r_, slabs.allocations(), false);
+    }
+    {
+      cfnum::counting_resource slabs { std::pmr::new_delete_resource() };
+      cfnum::node_arena arena_ { 64 * 1024, &slabs };
+      std::pmr::list<double> l_(keys.cbegin(), keys.cend(), arena_.resource());
+      row("std::pmr::list, node_arena"s, l_, slabs.allocations(), false);
+    }
+    {
+      std::vector<double> shuffled(keys);
+      std::shuffle(shuffled.begin(), shuffled.end(), gen);
+      cfnum::counting_resource heap { std::pmr::new_delete_resource() };
+      std::pmr::set<double> s_(shuffled.cbegin(), shuffled.cend(), &heap);
+      row("std::pmr::set, random-order inserts"s, s_, heap.allocations(), true);
+
+      cfnum::counting_resource slabs { std::pmr::new_delete_resource() };
+      cfnum::node_arena arena_ { 64 * 1024, &slabs };
+      std::pmr::set<double> a_(shuffled.cbegin(), shuffled.cend(), arena_.resource());
+      row("std::pmr::set, random-order inserts, arena"s, a_, slabs.allocations(), false);
+      auto const r_ = cfnum::relayout(s_, arena_.resource());
+      row("  relaid out into a node_arena"s, r_, slabs.allocations(), false);
+    }
+  }
   std::cout << std::endl;
 
   return;
@@ -505,6 +1258,315 @@ void fn_inner_product(void) {
                               std::plus<>(), std::equal_to<>());
   std::cout << "Number of pairwise matches between a and b: " <<  r2 << '\n';
 
+  //  Products past 2^31: the checked fold names the pair, the widening one
+  //  finishes in 64 bits.
+  std::vector<int> vbig { 3, 46'341, 50'000, 7, };
+  auto const c3 = cfnum::checked_inner_product(vbig.cbegin(), vbig.cend(), vbig.cbegin(), 0);
+  auto const s3 = cfnum::saturating_inner_product(vbig.cbegin(), vbig.cend(), vbig.cbegin(), 0);
+  auto const w3 = cfnum::widening_inner_product(vbig.cbegin(), vbig.cend(), vbig.cbegin(), 0);
+  std::cout << "sum of squares of 3 46341 50000 7: checked overflows at index "s << c3.index
+            << ", saturating "s << s3.value << ", widening "s << cfnum::to_string(w3.value)
+            << " ("s << w3.bits << " bits)"s << '\n';
+
+  //  --------------------------------------------------------------------------------
+  //  Sparse and strided operands: only the nonzeros of a sparse vector are
+  //  stored and multiplied; a strided span reads every stride-th element
+  {
+    std::vector<double> x_(10);
+    std::iota(x_.begin(), x_.end(), 0.0);
+    std::vector<uint32_t> ia { 1, 4, 7, };
+    std::vector<double> va { 2.0, 3.0, 4.0, };
+    std::vector<uint32_t> ib { 0, 4, 5, 7, 9, };
+    std::vector<double> vb { 1.0, 1.0, 1.0, 2.0, 1.0, };
+    cfnum::sparse_span<double> const a_ { ia, va };
+    cfnum::sparse_span<double> const b_ { ib, vb };
+    std::cout << '\n' << "sparse { 1: 2, 4: 3, 7: 4 } . 0 1 2 ... 9 = "s << cfnum::sparse_dot(a_, x_)
+              << ", . sparse { 0: 1, 4: 1, 5: 1, 7: 2, 9: 1 } = "s << cfnum::sparse_dot(a_, b_) << '\n';
+
+    //  Column 1 of a 3 x 4 row-major matrix, and the matrix read backwards
+    std::vector<double> m_ { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, };
+    cfnum::strided_span<double> const col1 { m_.data() + 1, 3, 4 };
+    cfnum::strided_span<double> const rev { m_.data() + 11, 3, -1 };
+    std::cout << "column 1 of [1..12] as 3 x 4: "s << col1[0] << ' ' << col1[1] << ' ' << col1[2]
+              << ", . 12 11 10 = "s << cfnum::strided_dot(col1, rev) << '\n';
+  }
+
+  //  --------------------------------------------------------------------------------
+  //  A batch of inner products: every row of a matrix with a vector (gemv) and
+  //  with every column of another matrix (gemm)
+  {
+    std::vector<double> a_ { 1, 2, 3, 4, 5, 6, };
+    std::vector<double> x_ { 1, 0, -1, };
+    std::vector<double> y_(2);
+    auto const am = cfnum::row_major(a_.data(), 2, 3);
+    cfnum::gemv(am, x_, y_);
+    std::cout << "[1 2 3; 4 5 6] (1 0 -1) = "s << y_[0] << ' ' << y_[1] << '\n';
+
+    //  The same storage read as column-major is the transpose: A A^T
+    std::vector<double> c_(4);
+    cfnum::gemm(am, cfnum::col_major(a_.data(), 3, 2), cfnum::row_major(c_.data(), 2, 2));
+    std::cout << "[1 2 3; 4 5 6] [1 2 3; 4 5 6]^T = ["s << c_[0] << ' ' << c_[1] << "; "s
+              << c_[2] << ' ' << c_[3] << "]"s << '\n';
+  }
+
+  //  --------------------------------------------------------------------------------
+  //  Sparse . dense and sparse . sparse across densities, against the loops
+  //  they replace and against a dense dot of the same vector with its zeros.
+  //  Values are small integers, so every summation order gives the same double
+  {
+    size_t constexpr n_elem = 4'000'000;
+    std::mt19937_64 gen { 2222 };
+    std::vector<double> x_(n_elem);
+    std::generate(x_.begin(), x_.end(), [&] { return static_cast<double>(gen() % 8); });
+    std::vector<uint32_t> ih;
+    std::vector<double> vh;
+    for (uint32_t i_ = 0; i_ < n_elem; ++i_) {
+      if (gen() % 2 == 0) {
+        ih.push_back(i_);
+        vh.push_back(static_cast<double>(1 + gen() % 4));
+      }
+    }
+    cfnum::sparse_span<double> const half { ih, vh };
+
+    std::cout << '\n' << "Sparse inner products with a "s << n_elem << " element double vector ("s
+              << cfnum::simd::isa_name(cfnum::simd::active_isa()) << ", "s << cfnum::default_concurrency()
+              << " threads):"s << '\n';
+    auto row = [&](cfnum::bench::result const & r_, cfnum::bench::result const & base, size_t nnz, bool ok_) {
+      std::cout << std::setw(40) << r_.name.substr(r_.name.find('/') + 1)
+                << std::setw(10) << std::setprecision(3) << r_.median_ms() << " ms"s
+                << std::setw(10) << std::setprecision(3) << base.median_ns / r_.median_ns << "x"s
+                << std::setw(10) << std::setprecision(3) << nnz / r_.median_ns << " Gnnz/s"s
+                << (ok_ ? "  ok"s : "  MISMATCH"s) << std::setprecision(6) << '\n';
+    };
+
+    for (auto const & [density, label] : { std::pair { 0.001, "0.1%"s }, std::pair { 0.01, "1%"s },
+                                           std::pair { 0.1, "10%"s }, std::pair { 0.5, "50%"s }, }) {
+      std::bernoulli_distribution pick(density);
+      std::vector<uint32_t> ia, ib;
+      std::vector<double> va, vb;
+      std::vector<double> dense(n_elem);
+      for (uint32_t i_ = 0; i_ < n_elem; ++i_) {
+        if (pick(gen)) {
+          ia.push_back(i_);
+          va.push_back(dense[i_] = static_cast<double>(1 + gen() % 4));
+        }
+        if (pick(gen)) {
+          ib.push_back(i_);
+          vb.push_back(static_cast<double>(1 + gen() % 4));
+        }
+      }
+      cfnum::sparse_span<double> const a_ { ia, va };
+      cfnum::sparse_span<double> const b_ { ib, vb };
+      size_t const nnz = ia.size();
+      cfnum::bench::options const opts {
+        .warmup = 1, .samples = 9, .min_sample_ms = 1.0,
+        .elements = nnz, .bytes = nnz * (sizeof(uint32_t) + 2 * sizeof(double)),
+      };
+      std::string const tag = " "s + label;
+
+      double expect = 0.0, r_ = 0.0;
+      auto const rl = cfnum::bench::run("fn_inner_product/std::transform_reduce"s + tag, opts, [&] {
+        expect = std::transform_reduce(ia.cbegin(), ia.cend(), va.cbegin(), 0.0, std::plus<>(),
+                                       [&x_](uint32_t i_, double v_) { return v_ * x_[i_]; });
+        cfnum::bench::do_not_optimize(expect);
+      });
+      auto const rd = cfnum::bench::run("fn_inner_product/simd::dot, zeros stored"s + tag, opts, [&] {
+        r_ = cfnum::simd::dot(dense, x_);
+        cfnum::bench::do_not_optimize(r_);
+      });
+      bool const ok_d = r_ == expect;
+      auto const rs = cfnum::bench::run("fn_inner_product/sparse_dot"s + tag, opts, [&] {
+        r_ = cfnum::sparse_dot(a_, x_);
+        cfnum::bench::do_not_optimize(r_);
+      });
+      bool const ok_s = r_ == expect;
+      auto const rp = cfnum::bench::run("fn_inner_product/parallel_sparse_dot"s + tag, opts, [&] {
+        r_ = cfnum::parallel_sparse_dot(a_, x_);
+        cfnum::bench::do_not_optimize(r_);
+      });
+      bool const ok_p = r_ == expect;
+
+      //  The textbook merge of two index lists, with a branch per comparison
+      double expect_ss = 0.0;
+      auto const rm = cfnum::bench::run("fn_inner_product/branching merge"s + tag, opts, [&] {
+        double sum_ = 0.0;
+        for (size_t i_ = 0, j_ = 0; i_ < ia.size() && j_ < ib.size();) {
+          if (ia[i_] < ib[j_]) {
+            ++i_;
+          }
+          else if (ib[j_] < ia[i_]) {
+            ++j_;
+          }
+          else {
+            sum_ += va[i_++] * vb[j_++];
+          }
+        }
+        expect_ss = sum_;
+        cfnum::bench::do_not_optimize(expect_ss);
+      });
+      auto const rss = cfnum::bench::run("fn_inner_product/sparse_dot sparse"s + tag, opts, [&] {
+        r_ = cfnum::sparse_dot(a_, b_);
+        cfnum::bench::do_not_optimize(r_);
+      });
+      bool const ok_ss = r_ == expect_ss;
+
+      //  Against the half-full vector: galloping once the sizes differ enough
+      double expect_h = 0.0;
+      auto const rmh = cfnum::bench::run("fn_inner_product/branching merge, 50% side"s + tag, opts, [&] {
+        double sum_ = 0.0;
+        for (size_t i_ = 0, j_ = 0; i_ < ia.size() && j_ < ih.size();) {
+          if (ia[i_] < ih[j_]) {
+            ++i_;
+          }
+          else if (ih[j_] < ia[i_]) {
+            ++j_;
+          }
+          else {
+            sum_ += va[i_++] * vh[j_++];
+          }
+        }
+        expect_h = sum_;
+        cfnum::bench::do_not_optimize(expect_h);
+      });
+      auto const rsh = cfnum::bench::run("fn_inner_product/sparse_dot, 50% side"s + tag, opts, [&] {
+        r_ = cfnum::sparse_dot(a_, half);
+        cfnum::bench::do_not_optimize(r_);
+      });
+      bool const ok_sh = r_ == expect_h;
+
+      std::cout << "density"s << tag << ", "s << nnz << " nonzeros:"s << '\n';
+      row(rl, rl, nnz, true);
+      row(rd, rl, nnz, ok_d);
+      row(rs, rl, nnz, ok_s);
+      row(rp, rl, nnz, ok_p);
+      row(rm, rm, nnz, true);
+      row(rss, rm, nnz, ok_ss);
+      row(rmh, rmh, nnz, true);
+      row(rsh, rmh, nnz, ok_sh);
+    }
+  }
+
+  //  --------------------------------------------------------------------------------
+  //  Strided dot products: every stride-th double of a 128 MB buffer against a
+  //  contiguous vector, as a column of a row-major matrix is read
+  {
+    size_t constexpr n_buf = 16'000'000;
+    size_t constexpr n_max = 2'000'000;
+    std::vector<double> buf(n_buf);
+    std::mt19937_64 gen { 2223 };
+    std::generate(buf.begin(), buf.end(), [&] { return static_cast<double>(gen() % 8); });
+    std::vector<double> y_(n_max);
+    std::generate(y_.begin(), y_.end(), [&] { return static_cast<double>(gen() % 8); });
+
+    std::cout << '\n' << "Strided dot products, double ("s << cfnum::simd::isa_name(cfnum::simd::active_isa())
+              << "):"s << '\n';
+    for (std::ptrdiff_t const stride : { 1, 2, 8, 64, -3, }) {
+      size_t const n_ = std::min(n_max, n_buf / static_cast<size_t>(stride < 0 ? -stride : stride));
+      double const * first = stride < 0 ? buf.data() + (n_ - 1) * static_cast<size_t>(-stride) : buf.data();
+      cfnum::strided_span<double> const a_ { first, n_, stride };
+      cfnum::strided_span<double> const b_ { y_.data(), n_, 1 };
+      cfnum::bench::options const opts {
+        .warmup = 1, .samples = 9, .min_sample_ms = 1.0,
+        .elements = n_, .bytes = n_ * 2 * sizeof(double),
+      };
+      std::string const tag = " stride "s + std::to_string(stride);
+      double expect = 0.0, r_ = 0.0;
+      auto const rl = cfnum::bench::run("fn_inner_product/indexed loop"s + tag, opts, [&] {
+        double sum_ = 0.0;
+        for (size_t i_ = 0; i_ < n_; ++i_) {
+          sum_ += a_[i_] * y_[i_];
+        }
+        expect = sum_;
+        cfnum::bench::do_not_optimize(expect);
+      });
+      auto const rs = cfnum::bench::run("fn_inner_product/strided_dot"s + tag, opts, [&] {
+        r_ = cfnum::strided_dot(a_, b_);
+        cfnum::bench::do_not_optimize(r_);
+      });
+      bool const ok_s = r_ == expect;
+      auto const rp = cfnum::bench::run("fn_inner_product/parallel_strided_dot"s + tag, opts, [&] {
+        r_ = cfnum::parallel_strided_dot(a_, b_);
+        cfnum::bench::do_not_optimize(r_);
+      });
+      bool const ok_p = r_ == expect;
+      for (auto const & [r0, ok_] : { std::pair { rl, true }, std::pair { rs, ok_s }, std::pair { rp, ok_p }, }) {
+        std::cout << std::setw(40) << r0.name.substr(r0.name.find('/') + 1)
+                  << std::setw(10) << std::setprecision(3) << r0.median_ms() << " ms"s
+                  << std::setw(10) << std::setprecision(3) << rl.median_ns / r0.median_ns << "x"s
+                  << std::setw(10) << std::setprecision(3) << r0.bytes_per_s() * 1e-9 << " GB/s"s
+                  << (ok_ ? "  ok"s : "  MISMATCH"s) << std::setprecision(6) << '\n';
+      }
+    }
+  }
+
+  //  --------------------------------------------------------------------------------
+  //  A csr matrix times a vector: 200000 x 1000000, mostly short rows and one
+  //  in a hundred a hundred times longer, so an even split by rows would not
+  //  be an even split of the work
+  {
+    size_t constexpr rows = 200'000;
+    size_t constexpr cols = 1'000'000;
+    std::mt19937_64 gen { 2224 };
+    std::vector<size_t> row_ptr { 0, };
+    std::vector<uint32_t> col;
+    std::vector<double> val;
+    std::vector<uint32_t> cs;
+    for (size_t r_ = 0; r_ < rows; ++r_) {
+      size_t const len = r_ % 100 == 0 ? 1'000 : 1 + gen() % 16;
+      cs.clear();
+      for (size_t k_ = 0; k_ < len; ++k_) {
+        cs.push_back(static_cast<uint32_t>(gen() % cols));
+      }
+      std::sort(cs.begin(), cs.end());
+      cs.erase(std::unique(cs.begin(), cs.end()), cs.end());
+      for (uint32_t c_ : cs) {
+        col.push_back(c_);
+        val.push_back(static_cast<double>(1 + gen() % 4));
+      }
+      row_ptr.push_back(col.size());
+    }
+    std::vector<double> x_(cols);
+    std::generate(x_.begin(), x_.end(), [&] { return static_cast<double>(gen() % 8); });
+    cfnum::csr_view<double> const m_ { cols, row_ptr, col, val };
+    size_t const nnz = col.size();
+    std::vector<double> expect(rows), y_(rows);
+
+    cfnum::bench::options const opts {
+      .warmup = 1, .samples = 9, .min_sample_ms = 1.0,
+      .elements = nnz, .bytes = nnz * (sizeof(uint32_t) + sizeof(double)),
+    };
+    auto const rl = cfnum::bench::run("fn_inner_product/row by row loop"s, opts, [&] {
+      for (size_t r_ = 0; r_ < rows; ++r_) {
+        double sum_ = 0.0;
+        for (size_t k_ = row_ptr[r_]; k_ < row_ptr[r_ + 1]; ++k_) {
+          sum_ += val[k_] * x_[col[k_]];
+        }
+        expect[r_] = sum_;
+      }
+      cfnum::bench::do_not_optimize(expect.data());
+    });
+    auto const rs = cfnum::bench::run("fn_inner_product/csr_multiply"s, opts, [&] {
+      cfnum::csr_multiply(m_, x_, y_);
+      cfnum::bench::do_not_optimize(y_.data());
+    });
+    bool const ok_s = y_ == expect;
+    std::fill(y_.begin(), y_.end(), 0.0);
+    auto const rp = cfnum::bench::run("fn_inner_product/parallel_csr_multiply"s, opts, [&] {
+      cfnum::parallel_csr_multiply(m_, x_, y_);
+      cfnum::bench::do_not_optimize(y_.data());
+    });
+    bool const ok_p = y_ == expect;
+
+    std::cout << '\n' << rows << " x "s << cols << " csr matrix, "s << nnz << " nonzeros, times a vector:"s << '\n';
+    for (auto const & [r0, ok_] : { std::pair { rl, true }, std::pair { rs, ok_s }, std::pair { rp, ok_p }, }) {
+      std::cout << std::setw(40) << r0.name.substr(r0.name.find('/') + 1)
+                << std::setw(10) << std::setprecision(3) << r0.median_ms() << " ms"s
+                << std::setw(10) << std::setprecision(3) << rl.median_ns / r0.median_ns << "x"s
+                << std::setw(10) << std::setprecision(3) << nnz / r0.median_ns << " Gnnz/s"s
+                << (ok_ ? "  ok"s : "  MISMATCH"s) << std::setprecision(6) << '\n';
+    }
+  }
+
   std::cout << std::endl;
 
   return;
@@ -548,47 +1610,159 @@ void fn_adjacent_difference(void) {
 //  std::copy(begin(ary), end(ary), std::ostream_iterator<int> {std::cout, " "});
   std::cout << '\n';
 
-  uint64_t constexpr fibonacci[] {
-  /*  0 */                          1ULL,                          1ULL,                          2ULL,
-  /*  3 */                          3ULL,                          5ULL,                          8ULL,
-  /*  6 */                         13ULL,                         21ULL,                         34ULL,
-  /*  9 */                         55ULL,                         89ULL,                        144ULL,
-  /* 12 */                        233ULL,                        377ULL,                        610ULL,
-  /* 15 */                        987ULL,                      1'597ULL,                      2'584ULL,
-  /* 18 */                      4'181ULL,                      6'765ULL,                     10'946ULL,
-  /* 21 */                     17'711ULL,                     28'657ULL,                     46'368ULL,
-  /* 24 */                     75'025ULL,                    121'393ULL,                    196'418ULL,
-  /* 27 */                    317'811ULL,                    514'229ULL,                    832'040ULL,
-  /* 30 */                  1'346'269ULL,                  2'178'309ULL,                  3'524'578ULL,
-  /* 33 */                  5'702'887ULL,                  9'227'465ULL,                 14'930'352ULL,
-  /* 36 */                 24'157'817ULL,                 39'088'169ULL,                 63'245'986ULL,
-  /* 39 */                102'334'155ULL,                165'580'141ULL,                267'914'296ULL,
-  /* 42 */                433'494'437ULL,                701'408'733ULL,              1'134'903'170ULL,
-  /* 45 */              1'836'311'903ULL,              2'971'215'073ULL,              4'807'526'976ULL,
-  /* 48 */              7'778'742'049ULL,             12'586'269'025ULL,             20'365'011'074ULL,
-  /* 51 */             32'951'280'099ULL,             53'316'291'173ULL,             86'267'571'272ULL,
-  /* 54 */            139'583'862'445ULL,            225'851'433'717ULL,            365'435'296'162ULL,
-  /* 57 */            591'286'729'879ULL,            956'722'026'041ULL,          1'548'008'755'920ULL,
-  /* 60 */          2'504'730'781'961ULL,          4'052'739'537'881ULL,          6'557'470'319'842ULL,
-  /* 63 */         10'610'209'857'723ULL,         17'167'680'177'565ULL,         27'777'890'035'288ULL,
-  /* 66 */         44'945'570'212'853ULL,         72'723'460'248'141ULL,        117'669'030'460'994ULL,
-  /* 69 */        190'392'490'709'135ULL,        308'061'521'170'129ULL,        498'454'011'879'264ULL,
-  /* 72 */        806'515'533'049'393ULL,      1'304'969'544'928'657ULL,      2'111'485'077'978'050ULL,
-  /* 75 */      3'416'454'622'906'707ULL,      5'527'939'700'884'757ULL,      8'944'394'323'791'464ULL,
-  /* 78 */     14'472'334'024'676'221ULL,     23'416'728'348'467'685ULL,     37'889'062'373'143'906ULL,
-  /* 81 */     61'305'790'721'611'591ULL,     99'194'853'094'755'497ULL,    160'500'643'816'367'088ULL,
-  /* 84 */    259'695'496'911'122'585ULL,    420'196'140'727'489'673ULL,    679'891'637'638'612'258ULL,
-  /* 87 */  1'100'087'778'366'101'931ULL,  1'779'979'416'004'714'189ULL,  2'880'067'194'370'816'120ULL,
-  /* 90 */  4'660'046'610'375'530'309ULL,  7'540'113'804'746'346'429ULL, 12'200'160'415'121'876'738ULL,
-  };
-  size_t constexpr fibonacci_l = sizeof(fibonacci) / sizeof(*fibonacci);
+  //  F(1) .. F(93): the same values, generated by the compiler.
+  auto constexpr & fibonacci = cfnum::fibonacci_table<uint64_t>;
+  static_assert(fibonacci.size() == 94);
   col = 0;
-  std::for_each_n(std::begin(fibonacci), fibonacci_l, [&col](auto f_) {
+  std::for_each(std::next(fibonacci.begin()), fibonacci.end(), [&col](auto f_) {
     std::cout << std::setw(20) << f_ << (++col % col_max == 0 ? '\n' : ' ');
   });
   std::cout << '\n'
             << std::setw(40 + 2) << "Max 64-bit unsigned integer ULLONG_MAX: "s
             << std::setw(20) << ULLONG_MAX << '\n';
+  std::cout << "adjacent_difference series "s
+            << (std::equal(ary.cbegin(), ary.cend(), std::next(fibonacci.cbegin())) ? "matches"s : "differs from"s)
+            << " the generated table"s << '\n';
+
+  //  Checked lookup: each type's table stops at the last Fibonacci number it can hold.
+  std::cout << '\n'
+            << "largest uint32_t Fibonacci: F("s << cfnum::fibonacci_max_index<uint32_t> << ") = "s
+            << *cfnum::fibonacci<uint32_t>(cfnum::fibonacci_max_index<uint32_t>) << '\n'
+            << "largest uint64_t Fibonacci: F("s << cfnum::fibonacci_max_index<uint64_t> << ") = "s
+            << *cfnum::fibonacci<uint64_t>(cfnum::fibonacci_max_index<uint64_t>) << '\n'
+            << "largest u128 Fibonacci:     F("s << cfnum::fibonacci_max_index<unsigned __int128> << ") = "s
+            << cfnum::to_string(*cfnum::fibonacci<unsigned __int128>(cfnum::fibonacci_max_index<unsigned __int128>))
+            << '\n'
+            << "fibonacci<uint64_t>(94): "s << (cfnum::fibonacci<uint64_t>(94) ? "found"s : "does not fit"s) << '\n';
+
+  //  Fast doubling: O(log n) for indices no table could hold.
+  uint64_t constexpr prime = 1'000'000'007;
+  std::cout << "F(10^18) mod 1e9+7 = "s << cfnum::fibonacci_mod(1'000'000'000'000'000'000ULL, prime) << '\n'
+            << "F(93) by fast doubling = "s << cfnum::fibonacci_pair<uint64_t>(93 - 1)->second << '\n';
+
+  //  --------------------------------------------------------------------------------
+  //  The same series as a linear recurrence, x[n] = a x[n-1] + b x[n-2] + c, filled
+  //  a vector of terms at a time rather than by the aliased adjacent_difference
+  //  (see recurrence.hpp)
+  {
+    cfnum::linear_recurrence<uint64_t> constexpr fib { 1, 1, 0, 1, 1 };     //  from F(1), F(2)
+    std::array<uint64_t, 93> rec;
+    cfnum::fill_recurrence(std::span<uint64_t>(rec), fib);
+    std::cout << "fill_recurrence series "s
+              << (std::equal(rec.cbegin(), rec.cend(), std::next(fibonacci.cbegin())) ? "matches"s : "differs from"s)
+              << " the generated table"s << '\n'
+              << "F(93) by matrix powers = "s << cfnum::recurrence_term(fib, 92) << '\n';
+
+    //  x[n] = x[n-1] + 2 x[n-2] + 1 from 0, 0: alternating bits 1, 10, 101, ... (OEIS A000975)
+    cfnum::linear_recurrence<int64_t> constexpr jac { 1, 2, 1, 0, 0 };
+    std::array<int64_t, 12> jr;
+    cfnum::fill_recurrence(std::span<int64_t>(jr), jac);
+    std::cout << "x[n] = x[n-1] + 2 x[n-2] + 1: "s;
+    for (auto n_ : jr) {
+      std::cout << n_ << ' ';
+    }
+    std::cout << '\n';
+  }
+
+  //  --------------------------------------------------------------------------------
+  //  Delta encoding a time series: std::adjacent_difference against the vector
+  //  kernel and the pool, decoded again by the inclusive scan
+  {
+    size_t constexpr n_elem = 16'000'000;
+    std::vector<int64_t> ts(n_elem);
+    std::mt19937 gen { 2020 };
+    int64_t t_ = 1'700'000'000'000;
+    std::generate(ts.begin(), ts.end(), [&] { return t_ += 900 + static_cast<int64_t>(gen() % 200); });
+    std::vector<int64_t> expect(n_elem), delta(n_elem), back(n_elem);
+    cfnum::bench::options const opts {
+      .warmup = 1, .samples = 7, .min_sample_ms = 0.0,
+      .elements = n_elem, .bytes = 2 * n_elem * sizeof(int64_t),
+    };
+    auto const rs = cfnum::bench::run("fn_adjacent_difference/std::adjacent_difference"s, opts, [&] {
+      std::adjacent_difference(ts.cbegin(), ts.cend(), expect.begin());
+      cfnum::bench::do_not_optimize(expect.data());
+    });
+    auto const rv = cfnum::bench::run("fn_adjacent_difference/cfnum::simd::adjacent_difference"s, opts, [&] {
+      cfnum::simd::adjacent_difference(std::span<int64_t const>(ts), std::span<int64_t>(delta));
+      cfnum::bench::do_not_optimize(delta.data());
+    });
+    bool const ok_v = delta == expect;
+    std::fill(delta.begin(), delta.end(), 0);
+    auto const rp = cfnum::bench::run("fn_adjacent_difference/cfnum::parallel_adjacent_difference"s, opts, [&] {
+      cfnum::parallel_adjacent_difference(ts.cbegin(), ts.cend(), delta.begin());
+      cfnum::bench::do_not_optimize(delta.data());
+    });
+    bool const ok_p = delta == expect;
+    cfnum::simd::inclusive_scan(std::span<int64_t const>(delta), std::span<int64_t>(back));
+
+    std::cout << '\n' << "Delta encoding "s << n_elem << " int64_t timestamps:"s << '\n';
+    for (auto const & [r_, ok_] : { std::pair { &rs, true }, std::pair { &rv, ok_v }, std::pair { &rp, ok_p } }) {
+      std::cout << std::setw(40) << r_->name.substr(r_->name.find('/') + 1)
+                << std::setw(10) << std::setprecision(3) << r_->median_ms() << " ms"s
+                << std::setw(10) << std::setprecision(3) << rs.median_ns / r_->median_ns << "x"s
+                << std::setw(10) << std::setprecision(3) << r_->bytes_per_s() * 1e-9 << " GB/s"s
+                << (ok_ ? "  ok"s : "  MISMATCH"s) << std::setprecision(6) << '\n';
+    }
+    std::cout << "decoded by inclusive_scan: "s << (back == ts ? "round trip ok"s : "MISMATCH"s) << '\n';
+  }
+
+  //  --------------------------------------------------------------------------------
+  //  Long recurrences: the serial loop, one term after another, against the
+  //  block-at-a-time kernel and a parallel fill from matrix-power chunk starts
+  {
+    auto run_type = [&]<typename T>(std::string const & type_, cfnum::linear_recurrence<T> const & r_, double tol) {
+      size_t constexpr n_elem = 16'000'000;
+      std::vector<T> expect(n_elem), vt(n_elem);
+      cfnum::bench::options const opts {
+        .warmup = 1, .samples = 7, .min_sample_ms = 0.0,
+        .elements = n_elem, .bytes = n_elem * sizeof(T),
+      };
+      using U = cfnum::simd::detail::lane_t<T>;
+      auto const rl = cfnum::bench::run("fn_adjacent_difference/serial loop "s + type_, opts, [&] {
+        expect[0] = r_.x0;
+        expect[1] = r_.x1;
+        for (size_t i_ = 2; i_ < n_elem; ++i_) {
+          expect[i_] = T(U(r_.a) * U(expect[i_ - 1]) + U(r_.b) * U(expect[i_ - 2]) + U(r_.c));
+        }
+        cfnum::bench::do_not_optimize(expect.data());
+      });
+      auto same = [&] {
+        if constexpr (std::is_floating_point_v<T>) {
+          for (size_t i_ = 0; i_ < n_elem; ++i_) {
+            if (std::abs(vt[i_] - expect[i_]) > tol * std::max(T(1), std::abs(expect[i_]))) {
+              return false;
+            }
+          }
+          return true;
+        }
+        else {
+          return vt == expect;
+        }
+      };
+      auto const rf = cfnum::bench::run("fn_adjacent_difference/cfnum::fill_recurrence "s + type_, opts, [&] {
+        cfnum::fill_recurrence(std::span<T>(vt), r_);
+        cfnum::bench::do_not_optimize(vt.data());
+      });
+      bool const ok_f = same();
+      std::fill(vt.begin(), vt.end(), T(0));
+      auto const rp = cfnum::bench::run("fn_adjacent_difference/cfnum::parallel_fill_recurrence "s + type_, opts, [&] {
+        cfnum::parallel_fill_recurrence(std::span<T>(vt), r_);
+        cfnum::bench::do_not_optimize(vt.data());
+      });
+      bool const ok_p = same();
+
+      std::cout << '\n' << "x[n] = a x[n-1] + b x[n-2] + c, "s << n_elem << ' ' << type_ << " terms:"s << '\n';
+      for (auto const & [r0, ok_] : { std::pair { &rl, true }, std::pair { &rf, ok_f }, std::pair { &rp, ok_p } }) {
+        std::cout << std::setw(40) << r0->name.substr(r0->name.find('/') + 1)
+                  << std::setw(10) << std::setprecision(3) << r0->median_ms() << " ms"s
+                  << std::setw(10) << std::setprecision(3) << rl.median_ns / r0->median_ns << "x"s
+                  << std::setw(10) << std::setprecision(3) << r0->bytes_per_s() * 1e-9 << " GB/s"s
+                  << (ok_ ? "  ok"s : "  MISMATCH"s) << std::setprecision(6) << '\n';
+      }
+    };
+    run_type("uint64_t"s, cfnum::linear_recurrence<uint64_t> { 1, 1, 0, 1, 1 }, 0.0);
+    run_type("double"s, cfnum::linear_recurrence<double> { 0.5, 0.25, 1.0, 2.0, 3.0 }, 1e-12);
+  }
 
   std::cout << std::endl;
 
@@ -643,39 +1817,196 @@ void fn_partial_sum(void) {
     std::cout << std::setw(20) << n_ << '\n';
   });
 
-  //  From GMP.Factorial.Select
-  uint64_t constexpr factorials[] = {
-    /* 0!*/                         0ULL, /* TODO: Added to make picking factorials intuitive */
-    /* 1!*/                         1ULL,
-    /* 2!*/                         2ULL,
-    /* 3!*/                         6ULL,
-    /* 4!*/                        24ULL,
-    /* 5!*/                       120ULL,
-    /* 6!*/                       720ULL,
-    /* 7!*/                     5'040ULL,
-    /* 8!*/                    40'320ULL,
-    /* 9!*/                   362'880ULL,
-    /*10!*/                 3'628'800ULL,
-    /*11!*/                39'916'800ULL,
-    /*12!*/               479'001'600ULL, /* TODO: max factorial for 32-bit integers */
-    /*13!*/             6'227'020'800ULL,
-    /*14!*/            87'178'291'200ULL,
-    /*15!*/         1'307'674'368'000ULL,
-    /*16!*/        20'922'789'888'000ULL,
-    /*17!*/       355'687'428'096'000ULL,
-    /*18!*/     6'402'373'705'728'000ULL,
-    /*19!*/   121'645'100'408'832'000ULL,
-    /*20!*/ 2'432'902'008'176'640'000ULL, /* TODO: max factorial for 64-bit integers */
-    };
-  size_t constexpr factorials_c = sizeof(factorials) / sizeof(*factorials);
-  std::for_each_n(std::begin(factorials), factorials_c, [](auto n_) {
-    if (n_ != 0) {
-      std::cout << std::setw(20) << n_ << '\n';
-    }
+  //  1! .. 20!, generated by the compiler (0! = 1 is entry 0).
+  auto constexpr & factorials = cfnum::factorial_table<uint64_t>;
+  std::for_each(std::next(factorials.begin()), factorials.end(), [](auto n_) {
+    std::cout << std::setw(20) << n_ << '\n';
   });
+  std::cout << "partial_sum factorials "s
+            << (std::equal(vfact.cbegin(), vfact.cend(), std::next(factorials.cbegin())) ? "match"s : "differ from"s)
+            << " the generated table"s << '\n';
+  std::cout << "largest factorials: uint32_t "s << cfnum::factorial_max_index<uint32_t> << "! = "s
+            << *cfnum::factorial<uint32_t>(cfnum::factorial_max_index<uint32_t>)
+            << ", uint64_t "s << cfnum::factorial_max_index<uint64_t> << "!"s
+            << ", u128 "s << cfnum::factorial_max_index<unsigned __int128> << "! = "s
+            << cfnum::to_string(*cfnum::factorial<unsigned __int128>(cfnum::factorial_max_index<unsigned __int128>))
+            << '\n'
+            << "factorial<uint64_t>(21): "s << (cfnum::factorial<uint64_t>(21) ? "found"s : "does not fit"s) << '\n';
+
+  //  The same scan past 20!: the checked version stops at 21! and says so, the
+  //  widening one carries on in 128 bits.
+  std::vector<uint64_t> vn(25);
+  std::iota(vn.begin(), vn.end(), 1);
+  std::vector<uint64_t> vchk(vn.size());
+  auto const chk = cfnum::checked_partial_sum(vn.cbegin(), vn.cend(), vchk.begin(), cfnum::checked_multiplies());
+  std::vector<unsigned __int128> vwide(vn.size());
+  auto const wide = cfnum::widening_partial_sum(vn.cbegin(), vn.cend(), vwide.begin(), cfnum::checked_multiplies());
+  std::cout << "checked partial_sum of 1..25: overflow at index "s << chk.index << " ("s << vn[chk.index] << "!), "s
+            << std::distance(vchk.begin(), chk.out) << " factorials written"s << '\n'
+            << "widening partial_sum: 25! = "s << cfnum::to_string(vwide.back())
+            << " ("s << wide.bits << " bits from index "s << wide.widened_at << "), "s
+            << (std::equal(vwide.cbegin(), vwide.cend(), std::next(cfnum::factorial_table<unsigned __int128>.cbegin()))
+                ? "matches"s : "differs from"s)
+            << " the u128 table"s << '\n';
 
   std::cout << '\n';
 
+  //  --------------------------------------------------------------------------------
+  //  Running sums and running maxima over 4M elements: the serial library scans
+  //  against the in-register log-step kernel, for each element type it supports
+  {
+    size_t constexpr n_elem = 4'000'037;
+    auto run = [](auto const & name, auto const & in, auto op) {
+      using T = typename std::remove_cvref_t<decltype(in)>::value_type;
+      std::vector<T> serial(in.size());
+      std::vector<T> simd(in.size());
+      cfnum::bench::options const opts {
+        .warmup = 1, .samples = 7, .min_sample_ms = 0.0,
+        .elements = in.size(), .bytes = 2 * in.size() * sizeof(T),
+      };
+      auto const rs = cfnum::bench::run("fn_partial_sum/std::partial_sum "s + name, opts, [&] {
+        std::partial_sum(in.cbegin(), in.cend(), serial.begin(), op);
+        cfnum::bench::do_not_optimize(serial.data());
+      });
+      auto const rv = cfnum::bench::run("fn_partial_sum/cfnum::simd::inclusive_scan "s + name, opts, [&] {
+        cfnum::simd::inclusive_scan(std::span<T const>(in), std::span<T>(simd), op);
+        cfnum::bench::do_not_optimize(simd.data());
+      });
+      std::cout << std::setw(20) << name
+                << std::setw(12) << std::setprecision(3) << rs.median_ms() << " ms"s
+                << std::setw(12) << rv.median_ms() << " ms"s
+                << std::setw(10) << std::setprecision(2) << rs.median_ns / rv.median_ns << "x"s
+                << (serial == simd ? "  identical"s : "  rounding differs"s)
+                << std::setprecision(6) << '\n';
+    };
+
+    std::vector<int32_t> vi(n_elem);
+    std::vector<int64_t> vl(n_elem);
+    std::vector<float> vf(n_elem);
+    std::vector<double> vd(n_elem);
+    std::mt19937 gen { 1111 };
+    std::generate(vi.begin(), vi.end(), [&] { return static_cast<int32_t>(gen() % 1'000); });
+    std::copy(vi.cbegin(), vi.cend(), vl.begin());
+    std::copy(vi.cbegin(), vi.cend(), vf.begin());
+    std::copy(vi.cbegin(), vi.cend(), vd.begin());
+
+    std::cout << "Scans over "s << n_elem << " elements ("s
+              << cfnum::simd::isa_name(cfnum::simd::active_isa()) << "):"s << '\n'
+              << std::setw(20) << "operation"s
+              << std::setw(15) << "partial_sum"s
+              << std::setw(15) << "simd scan"s
+              << std::setw(11) << "speedup"s << '\n';
+    run("int32_t sum"s, vi, std::plus<>());
+    run("int64_t sum"s, vl, std::plus<>());
+    run("float sum"s, vf, std::plus<>());
+    run("double sum"s, vd, std::plus<>());
+    run("int32_t max"s, vi, cfnum::maximum());
+    run("double min"s, vd, cfnum::minimum());
+  }
+
+  //  --------------------------------------------------------------------------------
+  //  The two halves together as a codec: sorted ids and timestamps stored as
+  //  delta + zigzag + bit-packed blocks, then summed, scanned and searched in
+  //  that form (see delta_codec.hpp)
+  {
+    auto run_type = [&]<typename T>(std::string const & type_, std::vector<T> const & src) {
+      size_t const n_elem = src.size();
+      cfnum::bench::options const opts {
+        .warmup = 1, .samples = 7, .min_sample_ms = 0.0,
+        .elements = n_elem, .bytes = n_elem * sizeof(T),
+      };
+      using S = typename cfnum::delta_packed<T>::sum_type;
+      cfnum::delta_packed<T> packed;
+      std::vector<T> out(n_elem), expect(n_elem);
+
+      auto const re = cfnum::bench::run("fn_partial_sum/delta_packed encode "s + type_, opts, [&] {
+        packed.assign(std::span<T const>(src));
+        cfnum::bench::do_not_optimize(packed);
+      });
+      auto const rc = cfnum::bench::run("fn_partial_sum/std::copy "s + type_, opts, [&] {
+        std::copy(src.cbegin(), src.cend(), expect.begin());
+        cfnum::bench::do_not_optimize(expect.data());
+      });
+      auto const rd = cfnum::bench::run("fn_partial_sum/delta_packed decode "s + type_, opts, [&] {
+        packed.decode(std::span<T>(out));
+        cfnum::bench::do_not_optimize(out.data());
+      });
+      bool const ok_d = out == src;
+
+      //  The references wrap like the codec does: 64-bit totals of 64-bit
+      //  timestamps do not fit, and a signed std::plus would overflow.
+      using US = std::make_unsigned_t<S>;
+      using UT = std::make_unsigned_t<T>;
+      auto const wrap_sum = [](S a_, S b_) { return static_cast<S>(static_cast<US>(a_) + static_cast<US>(b_)); };
+      auto const wrap_plus = [](T a_, T b_) { return static_cast<T>(static_cast<UT>(a_) + static_cast<UT>(b_)); };
+      S sum_raw {}, sum_packed {};
+      auto const rr = cfnum::bench::run("fn_partial_sum/std::reduce "s + type_, opts, [&] {
+        sum_raw = std::reduce(src.cbegin(), src.cend(), S {}, wrap_sum);
+        cfnum::bench::do_not_optimize(sum_raw);
+      });
+      auto const rs = cfnum::bench::run("fn_partial_sum/delta_packed sum "s + type_, opts, [&] {
+        sum_packed = packed.sum();
+        cfnum::bench::do_not_optimize(sum_packed);
+      });
+
+      auto const ri = cfnum::bench::run("fn_partial_sum/std::inclusive_scan "s + type_, opts, [&] {
+        std::inclusive_scan(src.cbegin(), src.cend(), expect.begin(), wrap_plus);
+        cfnum::bench::do_not_optimize(expect.data());
+      });
+      auto const rp = cfnum::bench::run("fn_partial_sum/delta_packed inclusive_scan "s + type_, opts, [&] {
+        packed.inclusive_scan(std::span<T>(out));
+        cfnum::bench::do_not_optimize(out.data());
+      });
+      bool const ok_p = out == expect;
+
+      //  Random access: lower_bound for every 1000th value decodes one block each
+      bool ok_l = true;
+      for (size_t i_ = 0; i_ < n_elem; i_ += 1'000) {
+        ok_l &= packed.lower_bound(src[i_]) == size_t(std::lower_bound(src.cbegin(), src.cend(), src[i_]) - src.cbegin())
+             && packed[i_] == src[i_];
+      }
+
+      std::cout << '\n' << n_elem << " sorted "s << type_ << ": "s << n_elem * sizeof(T) / 1'000'000 << " MB raw, "s
+                << std::setprecision(3) << packed.compressed_bytes() * 1e-6 << " MB packed ("s
+                << packed.bits_per_value() << " bits per value), "s << cfnum::simd::isa_name(cfnum::simd::active_isa())
+                << std::setprecision(6) << '\n';
+      auto row = [&](cfnum::bench::result const & r_, cfnum::bench::result const & base, bool ok_) {
+        std::cout << std::setw(40) << r_.name.substr(r_.name.find('/') + 1)
+                  << std::setw(10) << std::setprecision(3) << r_.median_ms() << " ms"s
+                  << std::setw(10) << std::setprecision(3) << base.median_ns / r_.median_ns << "x"s
+                  << std::setw(10) << std::setprecision(3) << n_elem / r_.median_ns << " Gval/s"s
+                  << (ok_ ? "  ok"s : "  MISMATCH"s) << std::setprecision(6) << '\n';
+      };
+      row(re, re, true);
+      row(rc, rc, true);
+      row(rd, rc, ok_d);
+      row(rr, rr, true);
+      row(rs, rr, sum_raw == sum_packed);
+      row(ri, ri, true);
+      row(rp, ri, ok_p);
+      std::cout << "lower_bound and operator[] on the packed form: "s << (ok_l ? "ok"s : "MISMATCH"s) << '\n';
+    };
+
+    size_t constexpr n_elem = 16'000'000;
+    std::mt19937_64 gen { 2121 };
+    //  Not a multiple of codec_block: the last block is a partial one.
+    std::vector<uint32_t> ids(n_elem - 37);
+    uint32_t id_ = 1'000;
+    std::generate(ids.begin(), ids.end(), [&] { return id_ += 1 + static_cast<uint32_t>(gen() % 16); });
+    run_type("uint32_t ids"s, ids);
+    std::vector<int64_t> ts(n_elem);
+    int64_t t_ = 1'700'000'000'000;
+    std::generate(ts.begin(), ts.end(), [&] { return t_ += 900 + static_cast<int64_t>(gen() % 200); });
+    run_type("int64_t timestamps"s, ts);
+    //  A gap in 512 wider than 32 bits: the blocks holding one are stored raw.
+    std::vector<int64_t> gaps(1'000'003);
+    int64_t g_ = 0;
+    std::generate(gaps.begin(), gaps.end(), [&] {
+      return g_ += gen() % 512 == 0 ? static_cast<int64_t>(gen() >> 28) : static_cast<int64_t>(gen() % 1'000);
+    });
+    run_type("int64_t gaps"s, gaps);
+  }
+
   std::cout << std::endl;
 
   return;
@@ -764,6 +2095,208 @@ void fn_exclusive_scan_inclusive_scan(void) {
 
   std::cout << std::endl;
 
+  //  --------------------------------------------------------------------------------
+  //  Offsets over a large array: cfnum parallel scans against the serial std:: scans
+  {
+    std::vector<int64_t> sizes(20'000'003);
+    std::mt19937 gen { 1111 };
+    std::uniform_int_distribution<int64_t> dist { 0, 4'096 };
+    std::generate(sizes.begin(), sizes.end(), [&] { return dist(gen); });
+    std::vector<int64_t> serial(sizes.size());
+    std::vector<int64_t> parallel(sizes.size());
+
+    cfnum::bench::options const opts {
+      .warmup = 1, .samples = 5, .min_sample_ms = 0.0,
+      .elements = sizes.size(), .bytes = 2 * sizes.size() * sizeof(int64_t),
+    };
+    cfnum::bench::print_header();
+    cfnum::bench::print(cfnum::bench::run("fn_exclusive_scan_inclusive_scan/std::inclusive_scan"s, opts, [&] {
+      std::inclusive_scan(sizes.cbegin(), sizes.cend(), serial.begin());
+      cfnum::bench::do_not_optimize(serial.data());
+    }));
+    cfnum::bench::print(cfnum::bench::run("fn_exclusive_scan_inclusive_scan/cfnum::parallel_inclusive_scan"s, opts, [&] {
+      cfnum::parallel_inclusive_scan(sizes.cbegin(), sizes.cend(), parallel.begin());
+      cfnum::bench::do_not_optimize(parallel.data());
+    }));
+    std::cout << "inclusive identical: "s << std::boolalpha << (serial == parallel) << '\n';
+
+    std::exclusive_scan(sizes.cbegin(), sizes.cend(), serial.begin(), int64_t(0));
+    cfnum::parallel_exclusive_scan(sizes.cbegin(), sizes.cend(), parallel.begin(), int64_t(0));
+    std::cout << "exclusive identical: "s << (serial == parallel) << '\n';
+
+    //  In place, and with a non-commutative but associative operator (max)
+    std::inclusive_scan(sizes.cbegin(), sizes.cend(), serial.begin(),
+                        [](int64_t a_, int64_t b_) { return std::max(a_, b_); });
+    parallel = sizes;
+    cfnum::parallel_inclusive_scan(parallel.begin(), parallel.end(), parallel.begin(),
+                                   [](int64_t a_, int64_t b_) { return std::max(a_, b_); });
+    std::cout << "in-place max identical: "s << (serial == parallel) << std::noboolalpha << '\n';
+  }
+
+  std::cout << std::endl;
+
+  //  --------------------------------------------------------------------------------
+  //  Segmented scans: the scan restarts wherever a head flag is set, or wherever the
+  //  key changes; reduce_by_key keeps one value per run of equal keys
+  {
+    size_t constexpr pad(20);
+    size_t constexpr pw(4);
+    auto pf = [](auto n_) {
+      std::cout << std::setw(pw) << n_ << ' ';
+    };
+    std::vector<int> keys { 1, 1, 2, 2, 2, 5, 7, 7, };
+    std::vector<int> i_data { 3, 1, 4, 1, 5, 9, 2, 6, };
+    std::vector<uint8_t> flags { 1, 0, 0, 1, 0, 1, 1, 0, };
+    std::vector<int> o_data(i_data.size());
+
+    std::cout << std::setw(pad) << "keys: "s;
+    std::for_each(keys.begin(), keys.end(), pf);
+    std::cout << '\n' << std::setw(pad) << "input data: "s;
+    std::for_each(i_data.begin(), i_data.end(), pf);
+    std::cout << '\n' << std::setw(pad) << "head flags: "s;
+    std::for_each(flags.begin(), flags.end(), [&](auto f_) { pf(int(f_)); });
+    std::cout << '\n' << '\n';
+
+    std::cout << std::setw(pad) << "segmented sum: "s;
+    cfnum::segmented_inclusive_scan(i_data.begin(), i_data.end(), flags.begin(), o_data.begin());
+    std::for_each(o_data.begin(), o_data.end(), pf);
+    std::cout << '\n';
+
+    std::cout << std::setw(pad) << "segmented max: "s;
+    cfnum::segmented_inclusive_scan(i_data.begin(), i_data.end(), flags.begin(), o_data.begin(),
+                                    [](int a_, int b_) { return std::max(a_, b_); });
+    std::for_each(o_data.begin(), o_data.end(), pf);
+    std::cout << '\n';
+
+    std::cout << std::setw(pad) << "sum by key: "s;
+    cfnum::inclusive_scan_by_key(keys.begin(), keys.end(), i_data.begin(), o_data.begin());
+    std::for_each(o_data.begin(), o_data.end(), pf);
+    std::cout << '\n' << '\n';
+
+    std::vector<int> k_out(keys.size());
+    auto const [ke, ve] = cfnum::reduce_by_key(keys.begin(), keys.end(), i_data.begin(),
+                                               k_out.begin(), o_data.begin());
+    std::cout << std::setw(pad) << "reduce_by_key: "s;
+    for (auto k_ = k_out.begin(), v_ = o_data.begin(); k_ != ke; ++k_, ++v_) {
+      std::cout << *k_ << ':' << *v_ << ' ';
+    }
+    std::cout << '(' << std::distance(o_data.begin(), ve) << " groups)"s << '\n';
+  }
+
+  std::cout << std::endl;
+
+  //  --------------------------------------------------------------------------------
+  //  Per-group loops against one segmented pass, over sorted int32_t keys in runs
+  //  of random length around 4, 64 and 4096.  The values are small integers, so the
+  //  double sums are exact in any order and every variant must agree
+  {
+    std::size_t const n = 4'000'000;
+    std::mt19937 gen { 25 };
+    std::vector<double> vals(n);
+    std::generate(vals.begin(), vals.end(), [&] { return double(gen() % 16); });
+    std::span<double const> const sv(vals);
+
+    cfnum::bench::options const o_ { .warmup = 1, .samples = 5, .min_sample_ms = 1.0, };
+    std::cout << "Segmented scans and reduce_by_key, "s << n << " elements ("s
+              << cfnum::simd::isa_name(cfnum::simd::active_isa()) << ", "s
+              << cfnum::default_concurrency() << " threads):"s << '\n';
+    auto row = [&](cfnum::bench::result const & r_, cfnum::bench::result const & base, bool ok_) {
+      std::cout << std::setw(40) << r_.name.substr(r_.name.find('/') + 1)
+                << std::setw(10) << std::setprecision(3) << r_.median_ms() << " ms"s
+                << std::setw(10) << std::setprecision(3) << base.median_ns / r_.median_ns << "x"s
+                << std::setw(10) << std::setprecision(4) << double(n) / r_.median_ns * 1'000.0 << " Melem/s"s
+                << (ok_ ? "  ok"s : "  MISMATCH"s) << std::setprecision(6) << '\n';
+    };
+
+    for (std::size_t const run : { std::size_t(4), std::size_t(64), std::size_t(4'096) }) {
+      std::vector<std::int32_t> keys(n);
+      std::vector<uint8_t> flags(n);
+      std::int32_t k_ = 0;
+      for (std::size_t i_ = 0; i_ < n;) {
+        std::size_t const e_ = std::min(n, i_ + 1 + gen() % (2 * run - 1));
+        flags[i_] = 1;
+        std::fill(keys.begin() + i_, keys.begin() + e_, k_);
+        k_ += 1 + static_cast<std::int32_t>(gen() % 3);
+        i_ = e_;
+      }
+      std::span<std::int32_t const> const sk(keys);
+      std::cout << "  runs of about "s << run << " ("s << std::count(flags.cbegin(), flags.cend(), 1)
+                << " groups):"s << '\n';
+
+      std::vector<std::int32_t> ek(n);
+      std::vector<double> ev(n);
+      std::vector<std::int32_t> ok(n);
+      std::vector<double> ov(n);
+      std::size_t groups = 0;
+      std::size_t got = 0;
+      auto same = [&] {
+        return got == groups && std::equal(ek.cbegin(), ek.cbegin() + groups, ok.cbegin())
+            && std::equal(ev.cbegin(), ev.cbegin() + groups, ov.cbegin());
+      };
+      auto const rl = cfnum::bench::run("fn_exclusive_scan_inclusive_scan/per-group find_if + std::reduce"s, o_, [&] {
+        groups = 0;
+        for (auto b_ = keys.cbegin(); b_ != keys.cend(); ++groups) {
+          auto const e_ = std::find_if(b_, keys.cend(), [k0 = *b_](std::int32_t k1) { return k1 != k0; });
+          auto const v_ = vals.cbegin() + (b_ - keys.cbegin());
+          ek[groups] = *b_;
+          ev[groups] = std::reduce(v_, v_ + (e_ - b_));
+          b_ = e_;
+        }
+        cfnum::bench::do_not_optimize(ev.data());
+      });
+      auto const rg = cfnum::bench::run("fn_exclusive_scan_inclusive_scan/cfnum::reduce_by_key"s, o_, [&] {
+        got = std::size_t(cfnum::reduce_by_key(keys.cbegin(), keys.cend(), vals.cbegin(),
+                                               ok.begin(), ov.begin()).second - ov.begin());
+        cfnum::bench::do_not_optimize(ov.data());
+      });
+      row(rl, rl, true);
+      row(rg, rl, same());
+      auto const rs = cfnum::bench::run("fn_exclusive_scan_inclusive_scan/simd::reduce_by_key"s, o_, [&] {
+        got = cfnum::simd::reduce_by_key(sk, sv, std::span(ok), std::span(ov));
+        cfnum::bench::do_not_optimize(ov.data());
+      });
+      row(rs, rl, same());
+      auto const rp = cfnum::bench::run("fn_exclusive_scan_inclusive_scan/parallel_reduce_by_key"s, o_, [&] {
+        got = cfnum::parallel_reduce_by_key(sk, sv, std::span(ok), std::span(ov));
+        cfnum::bench::do_not_optimize(ov.data());
+      });
+      row(rp, rl, same());
+
+      auto const ri = cfnum::bench::run("fn_exclusive_scan_inclusive_scan/per-group std::inclusive_scan"s, o_, [&] {
+        for (auto b_ = keys.cbegin(); b_ != keys.cend();) {
+          auto const e_ = std::find_if(b_, keys.cend(), [k0 = *b_](std::int32_t k1) { return k1 != k0; });
+          auto const v_ = vals.cbegin() + (b_ - keys.cbegin());
+          std::inclusive_scan(v_, v_ + (e_ - b_), ev.begin() + (b_ - keys.cbegin()));
+          b_ = e_;
+        }
+        cfnum::bench::do_not_optimize(ev.data());
+      });
+      auto const rk = cfnum::bench::run("fn_exclusive_scan_inclusive_scan/cfnum::inclusive_scan_by_key"s, o_, [&] {
+        cfnum::inclusive_scan_by_key(keys.cbegin(), keys.cend(), vals.cbegin(), ov.begin());
+        cfnum::bench::do_not_optimize(ov.data());
+      });
+      row(ri, ri, true);
+      row(rk, ri, ov == ev);
+      auto const rv = cfnum::bench::run("fn_exclusive_scan_inclusive_scan/simd::inclusive_scan_by_key"s, o_, [&] {
+        cfnum::simd::inclusive_scan_by_key(sk, sv, std::span(ov));
+        cfnum::bench::do_not_optimize(ov.data());
+      });
+      row(rv, ri, ov == ev);
+      auto const rf = cfnum::bench::run("fn_exclusive_scan_inclusive_scan/simd::segmented_inclusive_scan"s, o_, [&] {
+        cfnum::simd::segmented_inclusive_scan(sv, std::span<uint8_t const>(flags), std::span(ov));
+        cfnum::bench::do_not_optimize(ov.data());
+      });
+      row(rf, ri, ov == ev);
+      auto const rq = cfnum::bench::run("fn_exclusive_scan_inclusive_scan/parallel_inclusive_scan_by_key"s, o_, [&] {
+        cfnum::parallel_inclusive_scan_by_key(sk, sv, std::span(ov));
+        cfnum::bench::do_not_optimize(ov.data());
+      });
+      row(rq, ri, ov == ev);
+    }
+  }
+
+  std::cout << std::endl;
+
   return;
 }
 
@@ -827,6 +2360,18 @@ void fn_transform_exclusive_scan_transform_inclusive_scan(void) {
                                   times_10);
     std::for_each(o_data.begin(), o_data.end(), pf);
     std::cout << '\n' << '\n';
+
+    cfnum::thread_pool pool(4);
+    std::cout << std::setw(pad) << "cfnum 10 times exclusive: ";
+    cfnum::parallel_transform_exclusive_scan(pool, i_data.begin(), i_data.end(), o_data.begin(),
+                                             0, std::plus<int>{}, times_10, 2);
+    std::for_each(o_data.begin(), o_data.end(), pf);
+    std::cout << '\n';
+    std::cout << std::setw(pad) << "cfnum 10 times inclusive: ";
+    cfnum::parallel_transform_inclusive_scan(pool, i_data.begin(), i_data.end(), o_data.begin(),
+                                             std::plus<int>{}, times_10, std::nullopt, 2);
+    std::for_each(o_data.begin(), o_data.end(), pf);
+    std::cout << '\n' << '\n';
   }
 
   std::cout << std::endl;
@@ -845,7 +2390,7 @@ void fn_gcd(void) {
     << std::endl;
 
   std::vector<int32_t>  vals(30);
-  std::iota(vals.begin(), vals.end(), 21);
+  cfnum::parallel_iota(vals.begin(), vals.end(), 21);
   int32_t constexpr cv(3);
   size_t constexpr sw(2);
   std::cout << "greatest common divisors:"s << '\n';
@@ -857,6 +2402,132 @@ void fn_gcd(void) {
               << '\n';
   });
 
+  //  --------------------------------------------------------------------------------
+  //  Batched: the same 30 values in one call, then millions of random pairs.
+  {
+    std::vector<int32_t> out(vals.size());
+    cfnum::gcd(std::span<int32_t const> { vals }, cv, std::span<int32_t> { out });
+    bool const same = std::equal(vals.cbegin(), vals.cend(), out.cbegin(),
+                                 [](int32_t v_, int32_t g_) { return std::gcd(cv, v_) == g_; });
+    std::cout << '\n' << "cfnum::gcd(vals, "s << cv << ") "s << (same ? "matches"s : "MISMATCH"s) << '\n';
+
+    size_t constexpr n_pairs = 1'000'000;
+    std::vector<int64_t> va(n_pairs);
+    std::vector<int64_t> vb(n_pairs);
+    std::vector<int64_t> vg(n_pairs);
+    std::vector<int64_t> expect(n_pairs);
+    std::mt19937_64 gen { 20201111 };
+    std::uniform_int_distribution<int64_t> dist { -1'000'000'000, 1'000'000'000 };
+    for (size_t i_ = 0; i_ < n_pairs; ++i_) {
+      int64_t const k_ = dist(gen) % 1'000;        //  shared factor, so results are not all 1
+      va[i_] = dist(gen) * k_;
+      vb[i_] = (dist(gen) % 1'000'000) * k_;
+      expect[i_] = std::gcd(va[i_], vb[i_]);
+    }
+    std::span<int64_t const> const sa { va };
+    std::span<int64_t const> const sb { vb };
+    cfnum::gcd(sa, sb, std::span<int64_t> { vg });
+    std::cout << "cfnum::gcd over "s << n_pairs << " int64 pairs "s << (vg == expect ? "matches"s : "MISMATCH"s) << '\n';
+    std::fill(vg.begin(), vg.end(), 0);
+    cfnum::parallel_gcd(sa, sb, std::span<int64_t> { vg });
+    std::cout << "cfnum::parallel_gcd "s << (vg == expect ? "matches"s : "MISMATCH"s) << '\n';
+
+    //  The reduction stops at the first block whose running gcd is 1.
+    std::vector<int64_t> multiples(n_pairs);
+    for (size_t i_ = 0; i_ < n_pairs; ++i_) {
+      multiples[i_] = int64_t(360) * ((i_ % 1'000) + 1) * ((i_ & 1) ? -1 : 1);
+    }
+    std::cout << "gcd_reduce(multiples of 360) "s << cfnum::gcd_reduce(std::span<int64_t const> { multiples })
+              << ", parallel "s << cfnum::parallel_gcd_reduce(std::span<int64_t const> { multiples })
+              << ", of random pairs "s << cfnum::gcd_reduce(sa) << '\n' << '\n';
+
+    cfnum::bench::options const opts {
+      .samples = 7, .elements = n_pairs, .bytes = 3 * n_pairs * sizeof(int64_t),
+    };
+    cfnum::bench::print_header();
+    cfnum::bench::print(cfnum::bench::run("fn_gcd/std::gcd"s, opts, [&] {
+      std::transform(va.cbegin(), va.cend(), vb.cbegin(), vg.begin(),
+                     [](int64_t a_, int64_t b_) { return std::gcd(a_, b_); });
+      cfnum::bench::do_not_optimize(vg.data());
+    }));
+    cfnum::bench::print(cfnum::bench::run("fn_gcd/cfnum::binary_gcd"s, opts, [&] {
+      std::transform(va.cbegin(), va.cend(), vb.cbegin(), vg.begin(),
+                     [](int64_t a_, int64_t b_) { return cfnum::binary_gcd(a_, b_); });
+      cfnum::bench::do_not_optimize(vg.data());
+    }));
+    auto const best = cfnum::simd::detect_isa();
+    for (auto i_ : { cfnum::simd::isa::scalar, cfnum::simd::isa::neon, cfnum::simd::isa::sse2,
+                     cfnum::simd::isa::avx2, cfnum::simd::isa::avx512, }) {
+      if (!cfnum::simd::supports(i_)) {
+        continue;
+      }
+      cfnum::simd::force_isa(i_);
+      cfnum::bench::print(cfnum::bench::run("fn_gcd/cfnum::gcd "s + cfnum::simd::isa_name(i_), opts, [&] {
+        cfnum::gcd(sa, sb, std::span<int64_t> { vg });
+        cfnum::bench::do_not_optimize(vg.data());
+      }));
+    }
+    cfnum::simd::force_isa(best);
+    cfnum::bench::print(cfnum::bench::run("fn_gcd/cfnum::parallel_gcd"s, opts, [&] {
+      cfnum::parallel_gcd(sa, sb, std::span<int64_t> { vg });
+      cfnum::bench::do_not_optimize(vg.data());
+    }));
+    for (auto const & [name, data] : { std::pair { "random"s, &va, }, std::pair { "multiples"s, &multiples, }, }) {
+      cfnum::bench::print(cfnum::bench::run("fn_gcd/std::reduce(std::gcd) "s + name, opts, [&] {
+        cfnum::bench::do_not_optimize(std::reduce(data->cbegin(), data->cend(), int64_t(0),
+                                                  [](int64_t a_, int64_t b_) { return std::gcd(a_, b_); }));
+      }));
+      cfnum::bench::print(cfnum::bench::run("fn_gcd/cfnum::gcd_reduce "s + name, opts, [&] {
+        cfnum::bench::do_not_optimize(cfnum::gcd_reduce(std::span<int64_t const> { *data }));
+      }));
+    }
+  }
+
+  //  --------------------------------------------------------------------------------
+  //  Fixed operand: factor k once, then each gcd is a few multiplications.
+  {
+    cfnum::fixed_gcd<int32_t> const g3 { cv };
+    bool const same = std::all_of(vals.cbegin(), vals.cend(),
+                                  [&](int32_t v_) { return g3.gcd(v_) == std::gcd(cv, v_); });
+    std::cout << '\n' << "fixed_gcd("s << cv << ") over vals "s << (same ? "matches"s : "MISMATCH"s) << '\n';
+
+    size_t constexpr n_vals = 1'000'000;
+    std::vector<int64_t> vx(n_vals);
+    std::vector<int64_t> vg(n_vals);
+    std::mt19937_64 gen { 20201111 };
+    std::uniform_int_distribution<int64_t> dist { -1'000'000'000'000, 1'000'000'000'000 };
+    std::generate(vx.begin(), vx.end(), [&] { return dist(gen); });
+    std::span<int64_t const> const sx { vx };
+
+    cfnum::bench::options const opts {
+      .samples = 7, .elements = n_vals, .bytes = 2 * n_vals * sizeof(int64_t),
+    };
+    cfnum::bench::print_header();
+    for (int64_t k_ : { int64_t(3), int64_t(720), int64_t(1'000'000'007) * 998'244'353, }) {
+      cfnum::fixed_gcd<int64_t> const fk { k_ };
+      bool ok = true;
+      for (size_t i_ = 0; i_ < n_vals; i_ += 97) {
+        ok = ok && fk.gcd(vx[i_]) == std::gcd(k_, vx[i_]);
+      }
+      std::string const tag = " k="s + std::to_string(k_) + (fk.factored() ? " factored"s : " fastmod"s);
+      if (!ok) {
+        std::cout << "fixed_gcd"s << tag << " MISMATCH"s << '\n';
+      }
+      cfnum::bench::print(cfnum::bench::run("fn_gcd/std::gcd"s + tag, opts, [&] {
+        std::transform(vx.cbegin(), vx.cend(), vg.begin(), [k_](int64_t v_) { return std::gcd(k_, v_); });
+        cfnum::bench::do_not_optimize(vg.data());
+      }));
+      cfnum::bench::print(cfnum::bench::run("fn_gcd/cfnum::gcd(a, k)"s + tag, opts, [&] {
+        cfnum::gcd(sx, k_, std::span<int64_t> { vg });
+        cfnum::bench::do_not_optimize(vg.data());
+      }));
+      cfnum::bench::print(cfnum::bench::run("fn_gcd/cfnum::fixed_gcd"s + tag, opts, [&] {
+        fk.gcd(sx, std::span<int64_t> { vg });
+        cfnum::bench::do_not_optimize(vg.data());
+      }));
+    }
+  }
+
   std::cout << std::endl;
 
   return;;
@@ -873,7 +2544,7 @@ void fn_lcm(void) {
     << std::endl;
 
   std::vector<int32_t>  vals(30);
-  std::iota(vals.begin(), vals.end(), 21);
+  cfnum::parallel_iota(vals.begin(), vals.end(), 21);
   int32_t constexpr cv(3);
   size_t constexpr sw(2);
   std::cout << "least common multiples:"s << '\n';
@@ -885,6 +2556,63 @@ void fn_lcm(void) {
               << '\n';
   });
 
+  //  --------------------------------------------------------------------------------
+  //  Batched lcm: entries that overflow are reported instead of wrapping.
+  {
+    std::vector<int32_t> out(vals.size());
+    std::size_t const bad = cfnum::lcm(std::span<int32_t const> { vals }, cv, std::span<int32_t> { out });
+    bool const same = std::equal(vals.cbegin(), vals.cend(), out.cbegin(),
+                                 [](int32_t v_, int32_t l_) { return std::lcm(cv, v_) == l_; });
+    std::cout << '\n' << "cfnum::lcm(vals, "s << cv << ") "s << (same ? "matches"s : "MISMATCH"s)
+              << (bad == vals.size() ? ", no overflow"s : ", overflow at "s + std::to_string(bad)) << '\n';
+
+    std::vector<int32_t> big { 65'536, 46'341, 1'000'000, 2'147'483'647, };
+    std::vector<int32_t> other { 32'768, 46'337, 3, 2, };
+    std::vector<int32_t> res(big.size());
+    std::size_t const first = cfnum::lcm(std::span<int32_t const> { big }, std::span<int32_t const> { other },
+                                         std::span<int32_t> { res });
+    std::cout << "lcm of int32 pairs:"s;
+    for (size_t i_ = 0; i_ < big.size(); ++i_) {
+      std::cout << "  "s << big[i_] << "/"s << other[i_] << " -> "s << res[i_];
+    }
+    std::cout << '\n' << "first overflow at index "s << first << '\n';
+
+    std::vector<int32_t> small(23);
+    std::iota(small.begin(), small.end(), 1);
+    auto const l20 = cfnum::lcm_reduce(std::span<int32_t const> { small.data(), 20 });
+    auto const l23 = cfnum::lcm_reduce(std::span<int32_t const> { small });
+    std::cout << "lcm_reduce(1..20) "s << (l20 ? std::to_string(*l20) : "overflow"s)
+              << ", lcm_reduce(1..23) "s << (l23 ? std::to_string(*l23) : "overflow"s) << '\n';
+  }
+
+  //  --------------------------------------------------------------------------------
+  //  Fixed operand: x / gcd comes out of the factor test, so no division at all.
+  {
+    cfnum::fixed_gcd<int32_t> const l3 { cv };
+    bool const same = std::all_of(vals.cbegin(), vals.cend(),
+                                  [&](int32_t v_) { return l3.lcm(v_) == std::lcm(cv, v_); });
+    std::cout << '\n' << "fixed_gcd("s << cv << ").lcm over vals "s << (same ? "matches"s : "MISMATCH"s) << '\n';
+
+    size_t constexpr n_vals = 1'000'000;
+    std::vector<int32_t> vx(n_vals);
+    std::vector<int32_t> vl(n_vals);
+    std::iota(vx.begin(), vx.end(), 1);
+    cfnum::bench::options const opts {
+      .samples = 7, .elements = n_vals, .bytes = 2 * n_vals * sizeof(int32_t),
+    };
+    cfnum::bench::print_header();
+    cfnum::bench::print(cfnum::bench::run("fn_lcm/std::lcm k=3"s, opts, [&] {
+      std::transform(vx.cbegin(), vx.cend(), vl.begin(), [](int32_t v_) { return std::lcm(cv, v_); });
+      cfnum::bench::do_not_optimize(vl.data());
+    }));
+    cfnum::bench::print(cfnum::bench::run("fn_lcm/cfnum::lcm(a, k) k=3"s, opts, [&] {
+      cfnum::bench::do_not_optimize(cfnum::lcm(std::span<int32_t const> { vx }, cv, std::span<int32_t> { vl }));
+    }));
+    cfnum::bench::print(cfnum::bench::run("fn_lcm/cfnum::fixed_gcd::lcm k=3"s, opts, [&] {
+      cfnum::bench::do_not_optimize(l3.lcm(std::span<int32_t const> { vx }, std::span<int32_t> { vl }));
+    }));
+  }
+
   std::cout << std::endl;
 
   return;
@@ -927,3 +2655,615 @@ void fn_midpoint(void) {
 
   return;
 }
+
+/*
+ *  MARK: fn_simd_kernels()
+ */
+void fn_simd_kernels(void) {
+  std::cout << "Function: "s << __func__ << std::endl;
+  std::cout
+    << "--------------------------------------------------------------------------------"s
+    << '\n'
+    << std::endl;
+
+  std::cout << "Kernel instruction set: "s
+            << cfnum::simd::isa_name(cfnum::simd::active_isa()) << '\n';
+
+  //  Each kernel checked against the std::accumulate / std::inner_product result;
+  //  floating-point results may differ in the last bits because the kernels reassociate.
+  auto check = [](auto const & name, auto const & vec) {
+    using T = typename std::remove_cvref_t<decltype(vec)>::value_type;
+    auto same = [](T a_, T b_) {
+      if constexpr (std::is_floating_point_v<T>) {
+        return std::abs(a_ - b_) <= std::abs(b_) * std::numeric_limits<T>::epsilon() * 16;
+      }
+      else {
+        return a_ == b_;
+      }
+    };
+    //  20! overflows int32_t, so the reference product wraps as the kernel does.
+    auto times = [](T a_, T b_) {
+      if constexpr (std::is_integral_v<T>) {
+        using U = std::make_unsigned_t<T>;
+        return static_cast<T>(static_cast<U>(a_) * static_cast<U>(b_));
+      }
+      else {
+        return a_ * b_;
+      }
+    };
+    std::span<T const> const head { vec.data(), 20 };
+    T const sum = cfnum::simd::sum(vec);
+    T const product = cfnum::simd::product(head);
+    T const dot = cfnum::simd::dot(vec, vec);
+    std::cout << std::setw(8) << name
+              << "  sum "s << std::setw(12) << sum
+              << (same(sum, std::accumulate(vec.cbegin(), vec.cend(), T(0))) ? " ok"s : " MISMATCH"s)
+              << "  product "s << std::setw(20) << product
+              << (same(product, std::accumulate(head.begin(), head.end(), T(1), times))
+                  ? " ok"s : " MISMATCH"s)
+              << "  dot "s << std::setw(12) << dot
+              << (same(dot, std::inner_product(vec.cbegin(), vec.cend(), vec.cbegin(), T(0)))
+                  ? " ok"s : " MISMATCH"s)
+              << '\n';
+  };
+
+  std::vector<double> vd(1'003);
+  std::vector<float> vf(1'003);
+  std::vector<int32_t> vi(1'003);
+  std::vector<int64_t> vl(1'003);
+  std::iota(vd.begin(), vd.end(), 1.0);
+  std::iota(vf.begin(), vf.end(), 1.0F);
+  std::iota(vi.begin(), vi.end(), 1);
+  std::iota(vl.begin(), vl.end(), 1);
+
+  std::cout << std::defaultfloat;
+  check("double"s, vd);
+  check("float"s, vf);
+  check("int32_t"s, vi);
+  check("int64_t"s, vl);
+
+  std::cout << std::endl;
+
+  return;
+}
+
+/*
+ *  MARK: fn_summation()
+ */
+void fn_summation(void) {
+  std::cout << "Function: "s << __func__ << std::endl;
+  std::cout
+    << "--------------------------------------------------------------------------------"s
+    << '\n'
+    << std::endl;
+
+  //  0.1 is not representable, so unlike the 0.5s in fn_reduce() every addition rounds.
+  std::vector<double> vec(10'000'007, 0.1);
+  std::span<double const> const sv { vec };
+  long double const exact = static_cast<long double>(0.1) * static_cast<long double>(vec.size());
+
+  std::cout << std::setprecision(17)
+            << std::setw(20) << "exact: "s << exact << '\n';
+  cfnum::bench::options const opts {
+    .warmup = 1, .samples = 7, .min_sample_ms = 0.0,
+    .elements = vec.size(), .bytes = vec.size() * sizeof(double),
+  };
+  auto row = [&](std::string const & name, auto && fn) {
+    double result = 0.0;
+    auto const r_ = cfnum::bench::run("fn_summation/"s + name, opts, [&] {
+      result = fn();
+      cfnum::bench::do_not_optimize(result);
+    });
+    std::cout << std::setw(20) << name + ": "s << std::setw(26) << result
+              << "  error "s << std::setw(10) << std::setprecision(3)
+              << static_cast<double>(std::abs(result - exact))
+              << std::setprecision(3) << std::setw(10) << r_.median_ms() << " ms"s
+              << std::setprecision(17) << '\n';
+  };
+
+  row("std::accumulate"s, [&] { return std::accumulate(vec.cbegin(), vec.cend(), 0.0); });
+  row("std::reduce"s, [&] { return std::reduce(vec.cbegin(), vec.cend(), 0.0); });
+  row("simd::sum"s, [&] { return cfnum::simd::sum(sv); });
+  for (auto s_ : { cfnum::summation::kahan, cfnum::summation::neumaier, cfnum::summation::pairwise,
+                   cfnum::summation::blocked_pairwise, cfnum::summation::reproducible, }) {
+    row(cfnum::summation_name(s_), [&] { return cfnum::sum(sv, s_); });
+  }
+
+  //  Ill-conditioned: the large terms cancel, only the compensated sums keep the 1s.
+  {
+    std::vector<double> ill { 1.0, 1e100, 1.0, -1e100, };
+    std::span<double const> const si { ill };
+    std::cout << '\n' << "sum of 1, 1e100, 1, -1e100 (exact 2):"s << '\n'
+              << std::setw(20) << "std::accumulate: "s << std::accumulate(ill.cbegin(), ill.cend(), 0.0) << '\n'
+              << std::setw(20) << "kahan: "s << cfnum::kahan_sum(si) << '\n'
+              << std::setw(20) << "neumaier: "s << cfnum::neumaier_sum(si) << '\n';
+  }
+
+  //  Reproducible mode: same bits whatever the thread count.
+  {
+    std::vector<double> noisy(3'000'017);
+    std::mt19937_64 gen { 20201111 };
+    std::uniform_real_distribution<double> dist { -1.0, 1.0 };
+    std::generate(noisy.begin(), noisy.end(), [&] { return dist(gen) * std::exp2(dist(gen) * 40.0); });
+    std::span<double const> const sn { noisy };
+
+    std::cout << '\n' << "reproducible_sum vs parallel_reduce by thread count:"s << '\n';
+    for (size_t t_ : { 1, 2, 3, 4, 7, 16, }) {
+      cfnum::thread_pool pool(t_);
+      double const rs = cfnum::reproducible_sum(pool, sn);
+      double const pr = cfnum::parallel_reduce(pool, noisy.cbegin(), noisy.cend(), 0.0, std::plus<>(), 4'096);
+      std::cout << std::setw(4) << t_ << " threads  "s
+                << std::hexfloat << std::setw(26) << rs << "  "s << std::setw(26) << pr
+                << std::defaultfloat << '\n';
+    }
+  }
+
+  std::cout << std::setprecision(6) << std::fixed;
+  std::cout << std::endl;
+
+  return;
+}
+
+/*
+ *  MARK: fn_streaming()
+ *
+ *  A 64 MiB file of int64 read back in 4 MiB chunks: memory use is set by the
+ *  chunk size, not the file size, so the same code runs on inputs larger than RAM.
+ */
+void fn_streaming(void) {
+  std::cout << "Function: "s << __func__ << std::endl;
+  std::cout
+    << "--------------------------------------------------------------------------------"s
+    << '\n'
+    << std::endl;
+
+  namespace fs = std::filesystem;
+  size_t constexpr n_elem = size_t(8) << 20;
+  auto value = [](size_t i_) { return static_cast<int64_t>(i_ % 1'000) - 499; };
+  fs::path const in_path = fs::temp_directory_path() / "cf_stl_numeric_stream_in.bin";
+  fs::path const out_path = fs::temp_directory_path() / "cf_stl_numeric_stream_out.bin";
+
+  cfnum::stream::options opts { .chunk_bytes = size_t(4) << 20, };
+  if (!cfnum::stream::generate<int64_t>(in_path.string(), n_elem, value, opts)) {
+    std::cout << "unable to write "s << in_path << '\n' << std::endl;
+    return;
+  }
+
+  //  In-memory results to check against.
+  std::vector<int64_t> vec(n_elem);
+  for (size_t i_ = 0; i_ < n_elem; ++i_) {
+    vec[i_] = value(i_);
+  }
+  int64_t const sum = std::reduce(vec.cbegin(), vec.cend(), int64_t(0));
+  int64_t const sum_sq = std::transform_reduce(vec.cbegin(), vec.cend(), int64_t(0), std::plus<>(),
+                                               [](int64_t v_) { return v_ * v_; });
+  std::inclusive_scan(vec.cbegin(), vec.cend(), vec.begin());
+
+  cfnum::bench::options const bo {
+    .warmup = 1, .samples = 5, .min_sample_ms = 0.0,
+    .elements = n_elem, .bytes = n_elem * sizeof(int64_t),
+  };
+  cfnum::bench::print_header();
+  for (auto io_ : { cfnum::stream::source::buffered, cfnum::stream::source::mapped, }) {
+    opts.io = io_;
+    std::string const tag = io_ == cfnum::stream::source::mapped ? "mapped"s : "buffered"s;
+
+    auto const r_sum = cfnum::stream::reduce(in_path.string(), int64_t(0), std::plus<>(), opts);
+    auto const r_sq = cfnum::stream::transform_reduce<int64_t>(in_path.string(), int64_t(0), std::plus<>(),
+                                                               [](int64_t v_) { return v_ * v_; }, opts);
+    auto const r_scan = cfnum::stream::inclusive_scan<int64_t>(in_path.string(), out_path.string(),
+                                                               std::plus<>(), opts);
+    bool scan_ok = r_scan && *r_scan == vec.back();
+    size_t pos = 0;
+    cfnum::stream::for_each_chunk<int64_t>(out_path.string(), {}, [&](std::span<int64_t const> c_) {
+      scan_ok = scan_ok && std::equal(c_.begin(), c_.end(), vec.cbegin() + static_cast<std::ptrdiff_t>(pos));
+      pos += c_.size();
+    });
+
+    std::cout << std::setw(10) << tag << ": reduce "s << (r_sum && *r_sum == sum ? "ok"s : "MISMATCH"s)
+              << ", transform_reduce "s << (r_sq && *r_sq == sum_sq ? "ok"s : "MISMATCH"s)
+              << ", inclusive_scan "s << (scan_ok ? "ok"s : "MISMATCH"s) << '\n';
+
+    cfnum::bench::print(cfnum::bench::run("fn_streaming/reduce "s + tag, bo, [&] {
+      cfnum::bench::do_not_optimize(cfnum::stream::reduce(in_path.string(), int64_t(0), std::plus<>(), opts));
+    }));
+    cfnum::bench::print(cfnum::bench::run("fn_streaming/inclusive_scan "s + tag, bo, [&] {
+      cfnum::bench::do_not_optimize(cfnum::stream::inclusive_scan<int64_t>(in_path.string(), out_path.string(),
+                                                                           std::plus<>(), opts));
+    }));
+  }
+
+  std::error_code ec;
+  fs::remove(in_path, ec);
+  fs::remove(out_path, ec);
+
+  std::cout << std::endl;
+
+  return;
+}
+
+/*
+ *  MARK: fn_column_file()
+ *
+ *  10M doubles saved as text and as a column file, then summed straight off the
+ *  mapped pages.
+ */
+void fn_column_file(void) {
+  std::cout << "Function: "s << __func__ << std::endl;
+  std::cout
+    << "--------------------------------------------------------------------------------"s
+    << '\n'
+    << std::endl;
+
+  namespace fs = std::filesystem;
+  size_t constexpr n_elem = 10'000'000;
+  fs::path const txt_path = fs::temp_directory_path() / "cf_stl_numeric_column.txt";
+  fs::path const col_path = fs::temp_directory_path() / "cf_stl_numeric_column.f64";
+  fs::path const scan_path = fs::temp_directory_path() / "cf_stl_numeric_column_scan.i64";
+
+  std::vector<double> vec(n_elem);
+  std::iota(vec.begin(), vec.end(), 0.5);
+  double const sum = cfnum::simd::sum(std::span<double const> { vec });
+
+  cfnum::bench::options const bo {
+    .warmup = 0, .samples = 3, .min_sample_ms = 0.0,
+    .elements = n_elem, .bytes = n_elem * sizeof(double),
+  };
+  auto text_bo = bo;
+  text_bo.samples = 1;      //  seconds per call
+  cfnum::bench::print_header();
+  cfnum::bench::print(cfnum::bench::run("fn_column_file/write text"s, text_bo, [&] {
+    std::ofstream out(txt_path);
+    for (auto v_ : vec) {
+      out << v_ << '\n';
+    }
+  }));
+  cfnum::bench::print(cfnum::bench::run("fn_column_file/write column"s, bo, [&] {
+    cfnum::bench::do_not_optimize(cfnum::write_column(col_path.string(), std::span<double const> { vec }));
+  }));
+  cfnum::bench::print(cfnum::bench::run("fn_column_file/read text + sum"s, text_bo, [&] {
+    std::ifstream in(txt_path);
+    double v_ = 0.0;
+    double total = 0.0;
+    while (in >> v_) {
+      total += v_;
+    }
+    cfnum::bench::do_not_optimize(total);
+  }));
+  cfnum::bench::print(cfnum::bench::run("fn_column_file/map column + simd::sum"s, bo, [&] {
+    auto const col = cfnum::read_column<double>(col_path.string());
+    cfnum::bench::do_not_optimize(cfnum::simd::sum(col.values()));
+  }));
+  std::cout << '\n';
+
+  auto const col = cfnum::read_column<double>(col_path.string(), cfnum::mapped_file::advice::huge_pages);
+  if (!col) {
+    std::cout << "unable to map "s << col_path << '\n' << std::endl;
+    return;
+  }
+  auto const & h_ = col.header();
+  std::cout << "column: dtype "s << cfnum::dtype_name(h_.type) << ", count "s << h_.count
+            << ", payload offset "s << h_.offset << ", 64-byte aligned "s << std::boolalpha
+            << (reinterpret_cast<std::uintptr_t>(col.values().data()) % 64 == 0) << std::noboolalpha << '\n';
+  std::cout << "mapped simd::sum "s << (cfnum::simd::sum(col.values()) == sum ? "matches"s : "MISMATCH"s) << '\n';
+  std::cout << "read as int64 "s << (cfnum::read_column<int64_t>(col_path.string()) ? "accepted"s : "rejected"s) << '\n';
+
+  //  A scan written straight into a mapped output column.
+  {
+    std::vector<int64_t> vi(n_elem);
+    std::iota(vi.begin(), vi.end(), int64_t(-5'000'000));
+    cfnum::column_writer<int64_t> out(scan_path.string(), vi.size());
+    cfnum::parallel_inclusive_scan(vi.cbegin(), vi.cend(), out.values().begin());
+    bool const ok = out.commit();
+    std::inclusive_scan(vi.cbegin(), vi.cend(), vi.begin());
+    auto const back = cfnum::read_column<int64_t>(scan_path.string());
+    std::cout << "scan into column_writer "s
+              << (ok && std::ranges::equal(back.values(), vi) ? "round-trips"s : "MISMATCH"s) << '\n';
+
+    //  The streaming engine reads the same file by skipping the header.  The
+    //  prefix sums total about -8e19, past int64_t, so both sides fold the same
+    //  bits as uint64_t and wrap.
+    auto const total = cfnum::stream::reduce(scan_path.string(), uint64_t(0), std::plus<>(),
+                                             { .offset = back.header().offset, });
+    uint64_t const expect = std::transform_reduce(vi.cbegin(), vi.cend(), uint64_t(0), std::plus<>(),
+                                                  [](int64_t x_) { return static_cast<uint64_t>(x_); });
+    std::cout << "stream::reduce over column "s << (total && *total == expect ? "matches"s : "MISMATCH"s) << '\n';
+  }
+
+  std::error_code ec;
+  fs::remove(txt_path, ec);
+  fs::remove(col_path, ec);
+  fs::remove(scan_path, ec);
+
+  std::cout << std::endl;
+
+  return;
+}
+
+/*
+ *  MARK: fn_bignum()
+ *
+ *  Factorials and Fibonacci numbers past the 64- and 128-bit tables.
+ */
+void fn_bignum(void) {
+  std::cout << "Function: "s << __func__ << std::endl;
+  std::cout
+    << "--------------------------------------------------------------------------------"s
+    << '\n'
+    << std::endl;
+
+  //  Agreement with the compile-time tables where those still apply.
+  bool tables_ok = true;
+  for (size_t n_ = 0; n_ <= cfnum::factorial_max_index<unsigned __int128>; ++n_) {
+    tables_ok = tables_ok && cfnum::big_factorial(n_) == cfnum::biguint(cfnum::factorial_table<unsigned __int128>[n_]);
+  }
+  for (size_t n_ = 0; n_ <= cfnum::fibonacci_max_index<unsigned __int128>; ++n_) {
+    tables_ok = tables_ok && cfnum::big_fibonacci(n_) == cfnum::biguint(cfnum::fibonacci_table<unsigned __int128>[n_]);
+  }
+  std::cout << "big_factorial / big_fibonacci vs u128 tables: "s << (tables_ok ? "match"s : "MISMATCH"s) << '\n';
+
+  std::cout << "21!     = "s << cfnum::big_factorial(21).to_string() << '\n'
+            << "100!    = "s << cfnum::big_factorial(100).to_string() << '\n'
+            << "F(94)   = "s << cfnum::big_fibonacci(94).to_string() << '\n'
+            << "F(1000) = "s << cfnum::big_fibonacci(1'000).to_string() << '\n';
+
+  //  Cross-checks that exercise Karatsuba and the threaded paths.
+  {
+    auto const f_big = cfnum::big_factorial(20'000);
+    cfnum::biguint naive(uint64_t(1));
+    for (uint64_t k_ = 2; k_ <= 20'000; ++k_) {
+      naive *= k_;
+    }
+    cfnum::thread_pool single(1);
+    auto const fib = cfnum::big_fibonacci(100'000);
+    cfnum::biguint f0, f1(uint64_t(1));
+    for (size_t k_ = 0; k_ < 100'000; ++k_) {
+      f0 += f1;
+      std::swap(f0, f1);
+    }
+    std::string const digits = f_big.to_string();
+    std::cout << "20000! has "s << digits.size() << " digits, leading "s << digits.substr(0, 12)
+              << ", binary splitting vs running product "s << (f_big == naive ? "match"s : "MISMATCH"s)
+              << ", 1 vs "s << cfnum::default_concurrency() << " threads "s
+              << (cfnum::big_factorial(20'000, single) == f_big ? "match"s : "MISMATCH"s) << '\n';
+    std::cout << "F(100000) has "s << fib.bit_width() << " bits, fast doubling vs iteration "s
+              << (fib == f0 ? "match"s : "MISMATCH"s) << '\n';
+  }
+
+  //  --------------------------------------------------------------------------------
+  //  Timings: running product vs binary splitting, 1 thread vs the default pool.
+  std::cout << '\n';
+  cfnum::bench::print_header();
+  cfnum::bench::options const opts { .warmup = 1, .samples = 3, .min_sample_ms = 0.0, };
+  cfnum::thread_pool single(1);
+  for (uint64_t n_ : { 1'000ULL, 10'000ULL, 100'000ULL, }) {
+    std::string const tag = " n="s + std::to_string(n_);
+    cfnum::bench::print(cfnum::bench::run("fn_bignum/factorial running product"s + tag, opts, [&] {
+      cfnum::biguint f_(uint64_t(1));
+      for (uint64_t k_ = 2; k_ <= n_; ++k_) {
+        f_ *= k_;
+      }
+      cfnum::bench::do_not_optimize(f_.size());
+    }));
+    cfnum::bench::print(cfnum::bench::run("fn_bignum/big_factorial 1 thread"s + tag, opts, [&] {
+      cfnum::bench::do_not_optimize(cfnum::big_factorial(n_, single).size());
+    }));
+    cfnum::bench::print(cfnum::bench::run("fn_bignum/big_factorial pool"s + tag, opts, [&] {
+      cfnum::bench::do_not_optimize(cfnum::big_factorial(n_).size());
+    }));
+  }
+  for (uint64_t n_ : { 10'000ULL, 100'000ULL, 1'000'000ULL, }) {
+    std::string const tag = " n="s + std::to_string(n_);
+    if (n_ <= 100'000) {
+      cfnum::bench::print(cfnum::bench::run("fn_bignum/fibonacci iteration"s + tag, opts, [&] {
+        cfnum::biguint a_, b_(uint64_t(1));
+        for (uint64_t k_ = 0; k_ < n_; ++k_) {
+          a_ += b_;
+          std::swap(a_, b_);
+        }
+        cfnum::bench::do_not_optimize(a_.size());
+      }));
+    }
+    cfnum::bench::print(cfnum::bench::run("fn_bignum/big_fibonacci 1 thread"s + tag, opts, [&] {
+      cfnum::bench::do_not_optimize(cfnum::big_fibonacci(n_, single).size());
+    }));
+    cfnum::bench::print(cfnum::bench::run("fn_bignum/big_fibonacci pool"s + tag, opts, [&] {
+      cfnum::bench::do_not_optimize(cfnum::big_fibonacci(n_).size());
+    }));
+  }
+
+  std::cout << std::endl;
+
+  return;
+}
+
+/*
+ *  MARK: fn_benchmarks()
+ *
+ *  One timing per algorithm demonstrated above, on a 1M-element input, so the
+ *  --json / --csv output can be compared between builds.
+ */
+void fn_benchmarks(void) {
+  std::cout << "Function: "s << __func__ << std::endl;
+  std::cout
+    << "--------------------------------------------------------------------------------"s
+    << '\n'
+    << std::endl;
+
+  size_t constexpr n_elem = 1 << 20;
+  std::vector<int> vi(n_elem);
+  std::vector<int> vo(n_elem);
+  std::vector<double> vd(n_elem);
+  std::vector<double> vd2(n_elem);
+  //  1..100, so the int scans below stay in range even after the transform
+  //  scans' factor of 10 (about 5.3e8 at the end of 2^20 elements).
+  std::generate(vi.begin(), vi.end(), [i_ = 0]() mutable { return i_++ % 100 + 1; });
+  std::iota(vd.begin(), vd.end(), 1.0);
+  std::fill(vd2.begin(), vd2.end(), 0.5);
+
+  auto opts = [](size_t bytes_per_elem) {
+    return cfnum::bench::options { .elements = n_elem, .bytes = n_elem * bytes_per_elem, };
+  };
+  auto bench = [](std::string const & name, cfnum::bench::options const & o_, auto && fn) {
+    cfnum::bench::print(cfnum::bench::run("fn_benchmarks/"s + name, o_, fn));
+  };
+
+  cfnum::bench::print_header();
+  bench("std::iota"s, opts(sizeof(int)), [&] {
+    std::iota(vo.begin(), vo.end(), 0);
+    cfnum::bench::do_not_optimize(vo.data());
+  });
+  bench("std::accumulate"s, opts(sizeof(double)), [&] {
+    cfnum::bench::do_not_optimize(std::accumulate(vd.cbegin(), vd.cend(), 0.0));
+  });
+  bench("std::reduce"s, opts(sizeof(double)), [&] {
+    cfnum::bench::do_not_optimize(std::reduce(vd.cbegin(), vd.cend(), 0.0));
+  });
+  bench("std::transform_reduce"s, opts(2 * sizeof(double)), [&] {
+    cfnum::bench::do_not_optimize(std::transform_reduce(vd.cbegin(), vd.cend(), vd2.cbegin(), 0.0));
+  });
+  bench("std::inner_product"s, opts(2 * sizeof(double)), [&] {
+    cfnum::bench::do_not_optimize(std::inner_product(vd.cbegin(), vd.cend(), vd2.cbegin(), 0.0));
+  });
+  bench("std::adjacent_difference"s, opts(2 * sizeof(int)), [&] {
+    std::adjacent_difference(vi.cbegin(), vi.cend(), vo.begin());
+    cfnum::bench::do_not_optimize(vo.data());
+  });
+  bench("std::partial_sum"s, opts(2 * sizeof(int)), [&] {
+    std::partial_sum(vi.cbegin(), vi.cend(), vo.begin());
+    cfnum::bench::do_not_optimize(vo.data());
+  });
+  bench("std::exclusive_scan"s, opts(2 * sizeof(int)), [&] {
+    std::exclusive_scan(vi.cbegin(), vi.cend(), vo.begin(), 0);
+    cfnum::bench::do_not_optimize(vo.data());
+  });
+  bench("std::inclusive_scan"s, opts(2 * sizeof(int)), [&] {
+    std::inclusive_scan(vi.cbegin(), vi.cend(), vo.begin());
+    cfnum::bench::do_not_optimize(vo.data());
+  });
+  bench("std::transform_exclusive_scan"s, opts(2 * sizeof(int)), [&] {
+    std::transform_exclusive_scan(vi.cbegin(), vi.cend(), vo.begin(), 0, std::plus<int>{},
+                                  [](int x) { return x * 10; });
+    cfnum::bench::do_not_optimize(vo.data());
+  });
+  bench("std::transform_inclusive_scan"s, opts(2 * sizeof(int)), [&] {
+    std::transform_inclusive_scan(vi.cbegin(), vi.cend(), vo.begin(), std::plus<int>{},
+                                  [](int x) { return x * 10; });
+    cfnum::bench::do_not_optimize(vo.data());
+  });
+  bench("std::gcd"s, opts(sizeof(int)), [&] {
+    std::transform(vi.cbegin(), vi.cend(), vo.begin(), [](int v_) { return std::gcd(3, v_); });
+    cfnum::bench::do_not_optimize(vo.data());
+  });
+  bench("std::lcm"s, opts(sizeof(int)), [&] {
+    std::transform(vi.cbegin(), vi.cend(), vo.begin(), [](int v_) { return std::lcm(3, v_); });
+    cfnum::bench::do_not_optimize(vo.data());
+  });
+  bench("std::midpoint"s, opts(2 * sizeof(int)), [&] {
+    std::transform(vi.cbegin(), vi.cend(), vi.crbegin(), vo.begin(),
+                   [](int a_, int b_) { return std::midpoint(a_, b_); });
+    cfnum::bench::do_not_optimize(vo.data());
+  });
+
+  //  --------------------------------------------------------------------------------
+  //  Dense matrix products in GFLOP/s (2 m n k flops), against one
+  //  std::inner_product per row of A (gemv) or per element of C (gemm, on a
+  //  transposed copy of B so both operands are contiguous).  Entries are small
+  //  integers, so every summation order gives the same doubles
+  {
+    std::mt19937_64 gen { 2323 };
+    auto fill = [&](std::vector<double> & v_) {
+      std::generate(v_.begin(), v_.end(), [&] { return static_cast<double>(gen() % 8); });
+    };
+    std::cout << '\n' << "Dense matrix products, double ("s << cfnum::simd::isa_name(cfnum::simd::active_isa())
+              << ", "s << cfnum::default_concurrency() << " threads):"s << '\n';
+    auto row = [](cfnum::bench::result const & r_, cfnum::bench::result const & base, double flops, bool ok_) {
+      std::cout << std::setw(40) << r_.name.substr(r_.name.find('/') + 1)
+                << std::setw(10) << std::setprecision(3) << r_.median_ms() << " ms"s
+                << std::setw(10) << std::setprecision(3) << flops / r_.median_ns << " GFLOP/s"s
+                << std::setw(10) << std::setprecision(3) << base.median_ns / r_.median_ns << "x"s
+                << (ok_ ? "  ok"s : "  MISMATCH"s) << std::setprecision(6) << '\n';
+    };
+
+    for (size_t const n_ : { 512, 2'048, }) {
+      std::vector<double> a_(n_ * n_), at(n_ * n_), x_(n_), expect(n_), y_(n_);
+      fill(a_);
+      fill(x_);
+      for (size_t i_ = 0; i_ < n_; ++i_) {
+        for (size_t j_ = 0; j_ < n_; ++j_) {
+          at[j_ * n_ + i_] = a_[i_ * n_ + j_];
+        }
+      }
+      cfnum::bench::options const o_ { .warmup = 1, .samples = 9, .min_sample_ms = 1.0, };
+      std::string const tag = " "s + std::to_string(n_) + "^2"s;
+      double const flops = 2.0 * double(n_) * double(n_);
+      auto const r0 = cfnum::bench::run("fn_benchmarks/gemv std::inner_product"s + tag, o_, [&] {
+        for (size_t i_ = 0; i_ < n_; ++i_) {
+          expect[i_] = std::inner_product(a_.cbegin() + i_ * n_, a_.cbegin() + (i_ + 1) * n_, x_.cbegin(), 0.0);
+        }
+        cfnum::bench::do_not_optimize(expect.data());
+      });
+      auto const r1 = cfnum::bench::run("fn_benchmarks/gemv row-major"s + tag, o_, [&] {
+        cfnum::gemv(cfnum::row_major(a_.data(), n_, n_), x_, y_);
+        cfnum::bench::do_not_optimize(y_.data());
+      });
+      bool const ok1 = y_ == expect;
+      auto const r2 = cfnum::bench::run("fn_benchmarks/gemv column-major"s + tag, o_, [&] {
+        cfnum::gemv(cfnum::col_major(at.data(), n_, n_), x_, y_);
+        cfnum::bench::do_not_optimize(y_.data());
+      });
+      bool const ok2 = y_ == expect;
+      auto const r3 = cfnum::bench::run("fn_benchmarks/parallel_gemv"s + tag, o_, [&] {
+        cfnum::parallel_gemv(cfnum::row_major(a_.data(), n_, n_), x_, y_);
+        cfnum::bench::do_not_optimize(y_.data());
+      });
+      bool const ok3 = y_ == expect;
+      row(r0, r0, flops, true);
+      row(r1, r0, flops, ok1);
+      row(r2, r0, flops, ok2);
+      row(r3, r0, flops, ok3);
+    }
+
+    for (size_t const n_ : { 128, 512, }) {
+      std::vector<double> a_(n_ * n_), b_(n_ * n_), bt(n_ * n_), expect(n_ * n_), c_(n_ * n_);
+      fill(a_);
+      fill(b_);
+      for (size_t i_ = 0; i_ < n_; ++i_) {
+        for (size_t j_ = 0; j_ < n_; ++j_) {
+          bt[j_ * n_ + i_] = b_[i_ * n_ + j_];
+        }
+      }
+      cfnum::bench::options const o_ { .warmup = 1, .samples = 5, .min_sample_ms = 1.0, };
+      std::string const tag = " "s + std::to_string(n_) + "^3"s;
+      double const flops = 2.0 * double(n_) * double(n_) * double(n_);
+      auto const r0 = cfnum::bench::run("fn_benchmarks/gemm std::inner_product"s + tag, o_, [&] {
+        for (size_t i_ = 0; i_ < n_; ++i_) {
+          for (size_t j_ = 0; j_ < n_; ++j_) {
+            expect[i_ * n_ + j_] = std::inner_product(a_.cbegin() + i_ * n_, a_.cbegin() + (i_ + 1) * n_,
+                                                      bt.cbegin() + j_ * n_, 0.0);
+          }
+        }
+        cfnum::bench::do_not_optimize(expect.data());
+      });
+      auto const r1 = cfnum::bench::run("fn_benchmarks/gemm"s + tag, o_, [&] {
+        cfnum::gemm(cfnum::row_major(a_.data(), n_, n_), cfnum::row_major(b_.data(), n_, n_),
+                    cfnum::row_major(c_.data(), n_, n_));
+        cfnum::bench::do_not_optimize(c_.data());
+      });
+      bool const ok1 = c_ == expect;
+      auto const r2 = cfnum::bench::run("fn_benchmarks/parallel_gemm"s + tag, o_, [&] {
+        cfnum::parallel_gemm(cfnum::row_major(a_.data(), n_, n_), cfnum::row_major(b_.data(), n_, n_),
+                             cfnum::row_major(c_.data(), n_, n_));
+        cfnum::bench::do_not_optimize(c_.data());
+      });
+      bool const ok2 = c_ == expect;
+      row(r0, r0, flops, true);
+      row(r1, r0, flops, ok1);
+      row(r2, r0, flops, ok2);
+    }
+  }
+
+  std::cout << std::endl;
+
+  return;
+}
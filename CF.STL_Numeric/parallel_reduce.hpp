@@ -0,0 +1,187 @@
+//
+//  parallel_reduce.hpp
+//  CF.STL_Numeric
+//
+//  MARK: - References.
+//  @see: https://en.cppreference.com/w/cpp/algorithm/reduce
+//  @see: https://en.cppreference.com/w/cpp/algorithm/transform_reduce
+//
+
+#ifndef parallel_reduce_hpp
+#define parallel_reduce_hpp
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <span>
+#include <vector>
+
+#include "thread_pool.hpp"
+#include "simd_kernels.hpp"
+
+namespace cfnum {
+
+//  Below this many elements per thread the fork-join overhead outweighs the win.
+inline constexpr std::size_t reduce_grain = 32'768;
+
+namespace detail {
+
+//  Padded so neighbouring partial results never share a cache line.
+template <typename T>
+struct alignas(64) padded {
+  T value;
+};
+
+//  Number of chunks for n elements on a pool of the given size: a few per thread
+//  so the dynamic hand-out in thread_pool can even out stragglers.
+inline std::size_t chunk_count(std::size_t n, std::size_t threads, std::size_t grain) noexcept {
+  if (threads <= 1 || n <= grain) {
+    return 1;
+  }
+  std::size_t const by_grain = (n + grain - 1) / grain;
+  return std::min(by_grain, threads * 4);
+}
+
+} /* namespace detail */
+
+/*
+ *  MARK: parallel_transform_reduce()
+ *
+ *  Splits [first, last) into chunks, reduces each chunk on a pool thread with
+ *  std::transform_reduce, then folds the per-chunk partials left to right.
+ *  BinaryOp must be associative and commutative, exactly as for std::reduce.
+ *  The chunking depends only on the pool size, so a given pool always returns
+ *  the same answer for the same input.
+ */
+template <typename RandomIt, typename T, typename BinaryOp, typename UnaryOp>
+T parallel_transform_reduce(thread_pool & pool,
+                            RandomIt first, RandomIt last, T init,
+                            BinaryOp reduce_op, UnaryOp transform_op,
+                            std::size_t grain = reduce_grain) {
+  auto const n = static_cast<std::size_t>(std::distance(first, last));
+  std::size_t const chunks = detail::chunk_count(n, pool.size(), grain);
+  if (chunks == 1) {
+    return std::transform_reduce(first, last, init, reduce_op, transform_op);
+  }
+
+  std::vector<detail::padded<T>> partial(chunks, detail::padded<T> { init });
+  pool.parallel_for(chunks, [&](std::size_t c_) {
+    auto const lo = first + static_cast<std::ptrdiff_t>(n * c_ / chunks);
+    auto const hi = first + static_cast<std::ptrdiff_t>(n * (c_ + 1) / chunks);
+    auto const seed = transform_op(*lo);
+    partial[c_].value = std::transform_reduce(std::next(lo), hi, T(seed), reduce_op, transform_op);
+  });
+
+  T result = init;
+  for (auto const & p_ : partial) {
+    result = reduce_op(result, p_.value);
+  }
+  return result;
+}
+
+template <typename RandomIt, typename T, typename BinaryOp = std::plus<>>
+T parallel_reduce(thread_pool & pool,
+                  RandomIt first, RandomIt last, T init,
+                  BinaryOp op = {}, std::size_t grain = reduce_grain) {
+  return parallel_transform_reduce(pool, first, last, init, op, std::identity {}, grain);
+}
+
+//  Convenience overloads running on default_pool().
+template <typename RandomIt, typename T, typename BinaryOp = std::plus<>>
+T parallel_reduce(RandomIt first, RandomIt last, T init, BinaryOp op = {}) {
+  return parallel_reduce(default_pool(), first, last, init, op);
+}
+
+template <typename RandomIt, typename T, typename BinaryOp, typename UnaryOp>
+T parallel_transform_reduce(RandomIt first, RandomIt last, T init,
+                            BinaryOp reduce_op, UnaryOp transform_op) {
+  return parallel_transform_reduce(default_pool(), first, last, init, reduce_op, transform_op);
+}
+
+/*
+ *  MARK: parallel_inner_product()
+ *
+ *  Two-range form: sum of transform_op(a[i], b[i]), the parallel counterpart of
+ *  std::transform_reduce(first1, last1, first2, init).
+ */
+template <typename RandomIt1, typename RandomIt2, typename T,
+          typename BinaryOp1 = std::plus<>, typename BinaryOp2 = std::multiplies<>>
+T parallel_inner_product(thread_pool & pool,
+                         RandomIt1 first1, RandomIt1 last1, RandomIt2 first2, T init,
+                         BinaryOp1 reduce_op = {}, BinaryOp2 transform_op = {},
+                         std::size_t grain = reduce_grain) {
+  auto const n = static_cast<std::size_t>(std::distance(first1, last1));
+  std::size_t const chunks = detail::chunk_count(n, pool.size(), grain);
+  if (chunks == 1) {
+    return std::transform_reduce(first1, last1, first2, init, reduce_op, transform_op);
+  }
+
+  std::vector<detail::padded<T>> partial(chunks, detail::padded<T> { init });
+  pool.parallel_for(chunks, [&](std::size_t c_) {
+    auto const lo = static_cast<std::ptrdiff_t>(n * c_ / chunks);
+    auto const hi = static_cast<std::ptrdiff_t>(n * (c_ + 1) / chunks);
+    T const seed = transform_op(first1[lo], first2[lo]);
+    partial[c_].value = std::transform_reduce(first1 + lo + 1, first1 + hi, first2 + lo + 1,
+                                              seed, reduce_op, transform_op);
+  });
+
+  T result = init;
+  for (auto const & p_ : partial) {
+    result = reduce_op(result, p_.value);
+  }
+  return result;
+}
+
+/*
+ *  MARK: parallel_sum(), parallel_dot()
+ *
+ *  Contiguous fast path: each chunk runs the CPUID-dispatched simd kernel.
+ *  Integer results wrap modulo 2^N, as simd::sum() and simd::dot() do.
+ */
+template <simd::kernel_type T>
+T parallel_sum(thread_pool & pool, std::span<T const> s_, std::size_t grain = reduce_grain) {
+  std::size_t const chunks = detail::chunk_count(s_.size(), pool.size(), grain);
+  if (chunks == 1) {
+    return simd::sum(s_);
+  }
+  std::vector<detail::padded<T>> partial(chunks);
+  pool.parallel_for(chunks, [&](std::size_t c_) {
+    std::size_t const lo = s_.size() * c_ / chunks;
+    std::size_t const hi = s_.size() * (c_ + 1) / chunks;
+    partial[c_].value = simd::sum(s_.subspan(lo, hi - lo));
+  });
+  //  In the kernels' lane type, so integer partials wrap as the kernels do.
+  simd::detail::lane_t<T> result {};
+  for (auto const & p_ : partial) {
+    result += static_cast<simd::detail::lane_t<T>>(p_.value);
+  }
+  return static_cast<T>(result);
+}
+
+template <simd::kernel_type T>
+T parallel_dot(thread_pool & pool, std::span<T const> a_, std::span<T const> b_,
+               std::size_t grain = reduce_grain) {
+  std::size_t const n = std::min(a_.size(), b_.size());
+  std::size_t const chunks = detail::chunk_count(n, pool.size(), grain);
+  if (chunks == 1) {
+    return simd::dot(a_, b_);
+  }
+  std::vector<detail::padded<T>> partial(chunks);
+  pool.parallel_for(chunks, [&](std::size_t c_) {
+    std::size_t const lo = n * c_ / chunks;
+    std::size_t const hi = n * (c_ + 1) / chunks;
+    partial[c_].value = simd::dot(a_.subspan(lo, hi - lo), b_.subspan(lo, hi - lo));
+  });
+  //  In the kernels' lane type, so integer partials wrap as the kernels do.
+  simd::detail::lane_t<T> result {};
+  for (auto const & p_ : partial) {
+    result += static_cast<simd::detail::lane_t<T>>(p_.value);
+  }
+  return static_cast<T>(result);
+}
+
+} /* namespace cfnum */
+
+#endif /* parallel_reduce_hpp */
@@ -0,0 +1,334 @@
+//
+//  parallel_scan.hpp
+//  CF.STL_Numeric
+//
+//  MARK: - References.
+//  @see: https://en.cppreference.com/w/cpp/algorithm/inclusive_scan
+//  @see: https://en.cppreference.com/w/cpp/algorithm/exclusive_scan
+//  @see: https://en.cppreference.com/w/cpp/algorithm/adjacent_difference
+//  @see: Blelloch, "Prefix Sums and Their Applications" (reduce-then-scan)
+//
+
+#ifndef parallel_scan_hpp
+#define parallel_scan_hpp
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "thread_pool.hpp"
+#include "parallel_reduce.hpp"
+#include "simd_scan.hpp"
+
+namespace cfnum {
+
+//  Below this many elements per chunk the two passes cost more than they save.
+inline constexpr std::size_t scan_grain = 65'536;
+
+namespace detail {
+
+//  Final-pass worker: scan [lo, hi) into out, folding carry in front when there is one.
+template <typename InIt, typename OutIt, typename T, typename BinaryOp, typename UnaryOp>
+void scan_chunk(InIt lo, InIt hi, OutIt out, std::optional<T> carry, BinaryOp op, UnaryOp f_) {
+  if (lo == hi) {
+    return;
+  }
+  T acc = carry ? op(*carry, f_(*lo)) : T(f_(*lo));
+  *out = acc;
+  for (++lo, ++out; lo != hi; ++lo, ++out) {
+    acc = op(acc, f_(*lo));
+    *out = acc;
+  }
+}
+
+} /* namespace detail */
+
+/*
+ *  MARK: parallel_transform_inclusive_scan()
+ *
+ *  Two-pass reduce-then-scan over random-access ranges:
+ *    1. each chunk is reduced independently on the pool;
+ *    2. an exclusive scan of the chunk totals gives every chunk its carry-in;
+ *    3. each chunk is scanned from its carry-in on the pool.
+ *  Any associative BinaryOp is accepted (commutativity is not required: chunk
+ *  totals are always combined left to right).  d_first may equal first for an
+ *  in-place scan; pass 1 only reads and pass 3 writes each element after reading it.
+ *
+ *  For exactly associative operations (integer +, *, min, max, bitwise ops) the
+ *  output is identical to std::inclusive_scan.  Floating-point + is not
+ *  associative, so there results can differ from the serial scan in the last bits;
+ *  pass a pool of size 1 when bit-for-bit serial results are required.
+ */
+template <typename RandomIt, typename OutIt, typename BinaryOp, typename UnaryOp,
+          typename T = std::remove_cvref_t<std::invoke_result_t<UnaryOp &, std::iter_reference_t<RandomIt>>>>
+OutIt parallel_transform_inclusive_scan(thread_pool & pool,
+                                        RandomIt first, RandomIt last, OutIt d_first,
+                                        BinaryOp op, UnaryOp f_,
+                                        std::type_identity_t<std::optional<T>> init = std::nullopt,
+                                        std::size_t grain = scan_grain) {
+  auto const n = static_cast<std::size_t>(std::distance(first, last));
+  std::size_t const chunks = detail::chunk_count(n, pool.size(), grain);
+  if (chunks == 1) {
+    detail::scan_chunk(first, last, d_first, init, op, f_);
+    return d_first + static_cast<std::ptrdiff_t>(n);
+  }
+
+  auto bound = [n, chunks](std::size_t c_) { return static_cast<std::ptrdiff_t>(n * c_ / chunks); };
+
+  //  Pass 1: chunk totals.  The last chunk's total is never needed.
+  std::vector<std::optional<T>> carry(chunks);
+  pool.parallel_for(chunks - 1, [&](std::size_t c_) {
+    auto lo = first + bound(c_);
+    auto const hi = first + bound(c_ + 1);
+    T acc = f_(*lo);
+    for (++lo; lo != hi; ++lo) {
+      acc = op(acc, f_(*lo));
+    }
+    carry[c_ + 1] = acc;
+  });
+
+  //  Pass 2: carry-in of each chunk, serially (chunks is small).
+  carry[0] = init;
+  for (std::size_t c_ = 1; c_ < chunks; ++c_) {
+    if (carry[c_ - 1]) {
+      carry[c_] = op(*carry[c_ - 1], *carry[c_]);
+    }
+  }
+
+  //  Pass 3: scan each chunk from its carry-in.
+  pool.parallel_for(chunks, [&](std::size_t c_) {
+    detail::scan_chunk(first + bound(c_), first + bound(c_ + 1), d_first + bound(c_), carry[c_], op, f_);
+  });
+  return d_first + static_cast<std::ptrdiff_t>(n);
+}
+
+/*
+ *  MARK: parallel_simd_inclusive_scan()
+ *
+ *  Contiguous arithmetic input: the same two passes, with the chunk scans done by
+ *  simd::inclusive_scan.  parallel_inclusive_scan() routes here on its own when
+ *  the result is exact (integer sums, any max/min); call it directly to opt in
+ *  for floating-point sums.
+ */
+template <simd::kernel_type T, typename BinaryOp>
+  requires simd::scan_operator<BinaryOp, T>
+void parallel_simd_inclusive_scan(thread_pool & pool, std::span<T const> in, std::span<T> out,
+                                  BinaryOp op = {},
+                                  std::type_identity_t<T> init = simd::scan_identity<BinaryOp, T>(),
+                                  std::size_t grain = scan_grain) {
+  std::size_t const n = in.size();
+  std::size_t const chunks = detail::chunk_count(n, pool.size(), grain);
+  if (chunks == 1) {
+    simd::inclusive_scan(in, out, op, init);
+    return;
+  }
+
+  auto bound = [n, chunks](std::size_t c_) { return n * c_ / chunks; };
+  std::vector<T> carry(chunks, simd::scan_identity<BinaryOp, T>());
+  carry[0] = init;
+  pool.parallel_for(chunks - 1, [&](std::size_t c_) {
+    auto const chunk = in.subspan(bound(c_), bound(c_ + 1) - bound(c_));
+    if constexpr (std::is_same_v<typename simd::detail::scan_kind<BinaryOp>::type, simd::detail::scan_add>) {
+      carry[c_ + 1] = simd::sum(chunk);
+    }
+    else {
+      T acc = simd::scan_identity<BinaryOp, T>();
+      for (auto x_ : chunk) {
+        acc = op(acc, x_);
+      }
+      carry[c_ + 1] = acc;
+    }
+  });
+  for (std::size_t c_ = 1; c_ < chunks; ++c_) {
+    carry[c_] = op(carry[c_ - 1], carry[c_]);
+  }
+  pool.parallel_for(chunks, [&](std::size_t c_) {
+    std::size_t const lo = bound(c_);
+    std::size_t const len = bound(c_ + 1) - lo;
+    simd::inclusive_scan(in.subspan(lo, len), out.subspan(lo, len), op, carry[c_]);
+  });
+}
+
+template <typename RandomIt, typename OutIt, typename BinaryOp = std::plus<>>
+OutIt parallel_inclusive_scan(thread_pool & pool,
+                              RandomIt first, RandomIt last, OutIt d_first, BinaryOp op = {}) {
+  using T = std::iter_value_t<RandomIt>;
+  if constexpr (std::contiguous_iterator<RandomIt> && std::contiguous_iterator<OutIt>
+                && std::is_same_v<std::iter_value_t<OutIt>, T>
+                && simd::exact_scan<BinaryOp, T>) {
+    auto const n = static_cast<std::size_t>(std::distance(first, last));
+    parallel_simd_inclusive_scan(pool, std::span<T const>(std::to_address(first), n),
+                                 std::span<T>(std::to_address(d_first), n), op);
+    return d_first + static_cast<std::ptrdiff_t>(n);
+  }
+  else {
+    return parallel_transform_inclusive_scan(pool, first, last, d_first, op, std::identity {});
+  }
+}
+
+template <typename RandomIt, typename OutIt, typename BinaryOp, typename T>
+OutIt parallel_inclusive_scan(thread_pool & pool,
+                              RandomIt first, RandomIt last, OutIt d_first, BinaryOp op, T init) {
+  using V = std::iter_value_t<RandomIt>;
+  if constexpr (std::contiguous_iterator<RandomIt> && std::contiguous_iterator<OutIt>
+                && std::is_same_v<std::iter_value_t<OutIt>, V> && std::is_same_v<T, V>
+                && simd::exact_scan<BinaryOp, V>) {
+    auto const n = static_cast<std::size_t>(std::distance(first, last));
+    parallel_simd_inclusive_scan(pool, std::span<V const>(std::to_address(first), n),
+                                 std::span<V>(std::to_address(d_first), n), op, init);
+    return d_first + static_cast<std::ptrdiff_t>(n);
+  }
+  else {
+    return parallel_transform_inclusive_scan(pool, first, last, d_first, op, std::identity {},
+                                             std::optional<T>(init));
+  }
+}
+
+/*
+ *  MARK: parallel_transform_exclusive_scan()
+ *
+ *  Same two passes; each chunk writes init-or-carry first and folds one element
+ *  behind, which is what makes the in-place form safe.
+ */
+template <typename RandomIt, typename OutIt, typename T, typename BinaryOp, typename UnaryOp>
+OutIt parallel_transform_exclusive_scan(thread_pool & pool,
+                                        RandomIt first, RandomIt last, OutIt d_first, T init,
+                                        BinaryOp op, UnaryOp f_,
+                                        std::size_t grain = scan_grain) {
+  auto const n = static_cast<std::size_t>(std::distance(first, last));
+  std::size_t const chunks = detail::chunk_count(n, pool.size(), grain);
+  auto bound = [n, chunks](std::size_t c_) { return static_cast<std::ptrdiff_t>(n * c_ / chunks); };
+
+  std::vector<T> carry(chunks, init);
+  if (chunks > 1) {
+    std::vector<std::optional<T>> total(chunks);
+    pool.parallel_for(chunks - 1, [&](std::size_t c_) {
+      auto lo = first + bound(c_);
+      auto const hi = first + bound(c_ + 1);
+      T acc = f_(*lo);
+      for (++lo; lo != hi; ++lo) {
+        acc = op(acc, f_(*lo));
+      }
+      total[c_] = acc;
+    });
+    for (std::size_t c_ = 1; c_ < chunks; ++c_) {
+      carry[c_] = op(carry[c_ - 1], *total[c_ - 1]);
+    }
+  }
+
+  pool.parallel_for(chunks, [&](std::size_t c_) {
+    auto lo = first + bound(c_);
+    auto const hi = first + bound(c_ + 1);
+    auto out = d_first + bound(c_);
+    T acc = carry[c_];
+    for (; lo != hi; ++lo, ++out) {
+      T next = op(acc, f_(*lo));
+      *out = std::move(acc);
+      acc = std::move(next);
+    }
+  });
+  return d_first + static_cast<std::ptrdiff_t>(n);
+}
+
+template <typename RandomIt, typename OutIt, typename T, typename BinaryOp = std::plus<>>
+OutIt parallel_exclusive_scan(thread_pool & pool,
+                              RandomIt first, RandomIt last, OutIt d_first, T init, BinaryOp op = {}) {
+  return parallel_transform_exclusive_scan(pool, first, last, d_first, init, op, std::identity {});
+}
+
+/*
+ *  MARK: parallel_adjacent_difference()
+ *
+ *  Each chunk needs only the element before it, so every chunk runs at once.
+ *  Those elements are read before any chunk is written, which keeps the
+ *  in-place form (d_first == first) safe.  Contiguous kernel_type ranges with
+ *  std::minus or std::plus take simd::adjacent_difference.
+ */
+template <simd::kernel_type T, typename BinaryOp = std::minus<>>
+  requires simd::difference_operator<BinaryOp, T>
+void parallel_simd_adjacent_difference(thread_pool & pool, std::span<T const> in, std::span<T> out,
+                                       BinaryOp op = {}, std::size_t grain = scan_grain) {
+  std::size_t const n = in.size();
+  std::size_t const chunks = detail::chunk_count(n, pool.size(), grain);
+  if (chunks == 1) {
+    simd::adjacent_difference(in, out, op);
+    return;
+  }
+
+  auto bound = [n, chunks](std::size_t c_) { return n * c_ / chunks; };
+  std::vector<T> prev(chunks, T {});
+  for (std::size_t c_ = 1; c_ < chunks; ++c_) {
+    prev[c_] = in[bound(c_) - 1];
+  }
+  pool.parallel_for(chunks, [&](std::size_t c_) {
+    std::size_t const lo = bound(c_);
+    std::size_t const len = bound(c_ + 1) - lo;
+    simd::adjacent_difference(in.subspan(lo, len), out.subspan(lo, len), op, prev[c_]);
+  });
+}
+
+template <typename RandomIt, typename OutIt, typename BinaryOp = std::minus<>>
+OutIt parallel_adjacent_difference(thread_pool & pool,
+                                   RandomIt first, RandomIt last, OutIt d_first, BinaryOp op = {},
+                                   std::size_t grain = scan_grain) {
+  using T = std::iter_value_t<RandomIt>;
+  auto const n = static_cast<std::size_t>(std::distance(first, last));
+  if constexpr (std::contiguous_iterator<RandomIt> && std::contiguous_iterator<OutIt>
+                && std::is_same_v<std::iter_value_t<OutIt>, T>
+                && simd::difference_operator<BinaryOp, T>) {
+    parallel_simd_adjacent_difference(pool, std::span<T const>(std::to_address(first), n),
+                                      std::span<T>(std::to_address(d_first), n), op, grain);
+  }
+  else if (n != 0) {
+    std::size_t const chunks = detail::chunk_count(n, pool.size(), grain);
+    auto bound = [n, chunks](std::size_t c_) { return static_cast<std::ptrdiff_t>(n * c_ / chunks); };
+    std::vector<T> prev;
+    prev.reserve(chunks);
+    for (std::size_t c_ = 0; c_ < chunks; ++c_) {
+      prev.push_back(first[c_ == 0 ? 0 : bound(c_) - 1]);
+    }
+    pool.parallel_for(chunks, [&](std::size_t c_) {
+      auto lo = first + bound(c_);
+      auto const hi = first + bound(c_ + 1);
+      auto out = d_first + bound(c_);
+      T acc = std::move(prev[c_]);
+      if (c_ == 0) {
+        *out = acc;
+        ++lo;
+        ++out;
+      }
+      for (; lo != hi; ++lo, ++out) {
+        T val = *lo;
+        *out = op(val, std::move(acc));
+        acc = std::move(val);
+      }
+    });
+  }
+  return d_first + static_cast<std::ptrdiff_t>(n);
+}
+
+//  Convenience overloads running on default_pool().
+template <typename RandomIt, typename OutIt, typename BinaryOp = std::plus<>>
+OutIt parallel_inclusive_scan(RandomIt first, RandomIt last, OutIt d_first, BinaryOp op = {}) {
+  return parallel_inclusive_scan(default_pool(), first, last, d_first, op);
+}
+
+template <typename RandomIt, typename OutIt, typename T, typename BinaryOp = std::plus<>>
+OutIt parallel_exclusive_scan(RandomIt first, RandomIt last, OutIt d_first, T init, BinaryOp op = {}) {
+  return parallel_exclusive_scan(default_pool(), first, last, d_first, init, op);
+}
+
+template <typename RandomIt, typename OutIt, typename BinaryOp = std::minus<>>
+OutIt parallel_adjacent_difference(RandomIt first, RandomIt last, OutIt d_first, BinaryOp op = {}) {
+  return parallel_adjacent_difference(default_pool(), first, last, d_first, op);
+}
+
+} /* namespace cfnum */
+
+#endif /* parallel_scan_hpp */
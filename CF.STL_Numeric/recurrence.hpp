@@ -0,0 +1,289 @@
+//
+//  recurrence.hpp
+//  CF.STL_Numeric
+//
+//  MARK: - References.
+//  @see: https://en.wikipedia.org/wiki/Linear_recurrence_with_constant_coefficients
+//  @see: https://en.wikipedia.org/wiki/Companion_matrix
+//  @see: Kogge & Stone, "A Parallel Algorithm for the Efficient Solution of a General Class of Recurrence Equations" (1973)
+//
+
+#ifndef recurrence_hpp
+#define recurrence_hpp
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#include "thread_pool.hpp"
+#include "parallel_reduce.hpp"
+#include "simd_kernels.hpp"
+#include "index_fill.hpp"
+
+namespace cfnum {
+
+//  Element types the recurrence kernels are built for.  Integers are computed
+//  in unsigned lanes, so they wrap: Fibonacci numbers past F(93) come out
+//  modulo 2^64, exactly as the serial loop would produce them.
+template <typename T>
+concept recurrence_type = simd::kernel_type<T> || std::same_as<T, std::uint32_t> || std::same_as<T, std::uint64_t>;
+
+/*
+ *  MARK: linear_recurrence
+ *
+ *  x[n] = a x[n-1] + b x[n-2] + c, from x[0] and x[1].  Fibonacci is
+ *  { 1, 1, 0, 0, 1 }; a = 1, b = 0 gives an arithmetic series, b = c = 0 a
+ *  geometric one.
+ */
+template <recurrence_type T>
+struct linear_recurrence {
+  T a;
+  T b;
+  T c;
+  T x0;
+  T x1;
+};
+
+namespace detail {
+
+//  The companion matrix of the recurrence, acting on (x[n], x[n-1], 1).
+template <typename U>
+struct mat3 {
+  U m[3][3];
+
+  friend constexpr mat3 operator*(mat3 const & l_, mat3 const & r_) noexcept {
+    mat3 p_ {};
+    for (int i_ = 0; i_ < 3; ++i_) {
+      for (int j_ = 0; j_ < 3; ++j_) {
+        p_.m[i_][j_] = l_.m[i_][0] * r_.m[0][j_] + l_.m[i_][1] * r_.m[1][j_] + l_.m[i_][2] * r_.m[2][j_];
+      }
+    }
+    return p_;
+  }
+};
+
+template <typename U>
+constexpr mat3<U> mat3_pow(mat3<U> m_, std::uint64_t k_) noexcept {
+  mat3<U> r_ { { { U(1), U(0), U(0) }, { U(0), U(1), U(0) }, { U(0), U(0), U(1) } } };
+  for (; k_ != 0; k_ >>= 1) {
+    if ((k_ & 1) != 0) {
+      r_ = r_ * m_;
+    }
+    m_ = m_ * m_;
+  }
+  return r_;
+}
+
+//  The recurrence in lane arithmetic.
+template <typename U>
+struct lane_recurrence {
+  U a;
+  U b;
+  U c;
+  U x0;
+  U x1;
+};
+
+template <recurrence_type T>
+constexpr lane_recurrence<simd::detail::lane_t<T>> as_lanes(linear_recurrence<T> const & r_) noexcept {
+  using U = simd::detail::lane_t<T>;
+  return { static_cast<U>(r_.a), static_cast<U>(r_.b), static_cast<U>(r_.c),
+           static_cast<U>(r_.x0), static_cast<U>(r_.x1) };
+}
+
+//  (x[j], x[j-1]) for j >= 1: M^(j-1) applied to (x[1], x[0], 1), in O(log j).
+template <typename U>
+constexpr std::pair<U, U> recurrence_state(lane_recurrence<U> const & r_, std::uint64_t j_) noexcept {
+  mat3<U> const m_ { { { r_.a, r_.b, r_.c }, { U(1), U(0), U(0) }, { U(0), U(0), U(1) } } };
+  mat3<U> const p_ = mat3_pow(m_, j_ - 1);
+  return { p_.m[0][0] * r_.x1 + p_.m[0][1] * r_.x0 + p_.m[0][2],
+           p_.m[1][0] * r_.x1 + p_.m[1][1] * r_.x0 + p_.m[1][2] };
+}
+
+//  Unrolled vectors per step of recurrence_kernel.
+inline constexpr std::size_t recurrence_unroll = 4;
+
+/*
+ *  Each term k = 1 .. 4L ahead of (x[j], x[j-1]) is a fixed combination
+ *  alpha_k x[j] + beta_k x[j-1] + gamma_k, so a whole step of 4L terms is
+ *  two multiply-adds per vector from two broadcasts, and the only chain
+ *  between steps is the last two lanes of the last vector.
+ */
+template <std::size_t Bytes, bool Stream, typename U>
+[[gnu::always_inline]] inline void recurrence_kernel(U * out, std::size_t n_, lane_recurrence<U> const & r_,
+                                                     U p1, U p2) noexcept {
+  using V = typename simd::detail::vec<U, Bytes>::type;
+  constexpr std::size_t L = simd::detail::vec<U, Bytes>::lanes;
+  constexpr std::size_t K = recurrence_unroll;
+
+  //  alpha, beta and gamma by running the recurrence from the unit states.
+  V A[K];
+  V B[K];
+  V C[K];
+  U a1 = U(1), a2 = U(0), b1 = U(0), b2 = U(1), c1 = U(0), c2 = U(0);
+  for (std::size_t k_ = 0; k_ < K * L; ++k_) {
+    U const a0 = r_.a * a1 + r_.b * a2;
+    U const b0 = r_.a * b1 + r_.b * b2;
+    U const c0 = r_.a * c1 + r_.b * c2 + r_.c;
+    A[k_ / L][k_ % L] = a0;
+    B[k_ / L][k_ % L] = b0;
+    C[k_ / L][k_ % L] = c0;
+    a2 = a1; a1 = a0;
+    b2 = b1; b1 = b0;
+    c2 = c1; c1 = c0;
+  }
+
+  std::size_t i_ = 0;
+  if constexpr (Stream) {
+    for (; i_ < n_ && reinterpret_cast<std::uintptr_t>(out + i_) % Bytes != 0; ++i_) {
+      U const x0 = r_.a * p1 + r_.b * p2 + r_.c;
+      out[i_] = x0;
+      p2 = p1;
+      p1 = x0;
+    }
+  }
+  V P1 = V {} + p1;
+  V P2 = V {} + p2;
+  V x_[K];
+  for (; i_ + K * L <= n_; i_ += K * L) {
+#pragma GCC unroll 4
+    for (std::size_t k_ = 0; k_ < K; ++k_) {
+      x_[k_] = A[k_] * P1 + (B[k_] * P2 + C[k_]);
+      simd::detail::store<Bytes, Stream>(out + i_ + k_ * L, x_[k_]);
+    }
+    P1 = V {} + x_[K - 1][L - 1];
+    P2 = V {} + x_[K - 1][L - 2];
+  }
+  p1 = P1[0];
+  p2 = P2[0];
+  for (; i_ < n_; ++i_) {
+    U const x0 = r_.a * p1 + r_.b * p2 + r_.c;
+    out[i_] = x0;
+    p2 = p1;
+    p1 = x0;
+  }
+#if defined(CFNUM_SIMD_X86)
+  if constexpr (Stream) {
+    __builtin_ia32_sfence();
+  }
+#endif
+}
+
+template <typename U>
+inline void recurrence_scalar(U * out, std::size_t n_, lane_recurrence<U> const & r_, U p1, U p2) noexcept {
+  for (std::size_t i_ = 0; i_ < n_; ++i_) {
+    U const x0 = r_.a * p1 + r_.b * p2 + r_.c;
+    out[i_] = x0;
+    p2 = p1;
+    p1 = x0;
+  }
+}
+
+#if defined(CFNUM_SIMD_X86)
+template <bool Stream, typename U>
+[[gnu::target("avx512f,avx512dq")]] void recurrence_avx512(U * out, std::size_t n_, lane_recurrence<U> const & r_,
+                                                           U p1, U p2) noexcept {
+  recurrence_kernel<64, Stream>(out, n_, r_, p1, p2);
+}
+
+template <bool Stream, typename U>
+[[gnu::target("avx2,fma")]] void recurrence_avx2(U * out, std::size_t n_, lane_recurrence<U> const & r_,
+                                                 U p1, U p2) noexcept {
+  recurrence_kernel<32, Stream>(out, n_, r_, p1, p2);
+}
+#endif
+
+template <bool Stream, typename U>
+inline void recurrence_dispatch(U * out, std::size_t n_, lane_recurrence<U> const & r_, U p1, U p2) noexcept {
+  switch (simd::active_isa()) {
+#if defined(CFNUM_SIMD_X86)
+    case simd::isa::avx512: recurrence_avx512<Stream>(out, n_, r_, p1, p2); break;
+    case simd::isa::avx2:   recurrence_avx2<Stream>(out, n_, r_, p1, p2); break;
+    case simd::isa::sse2:   recurrence_kernel<16, Stream>(out, n_, r_, p1, p2); break;
+#elif defined(CFNUM_SIMD_NEON)
+    case simd::isa::neon:   recurrence_kernel<16, false>(out, n_, r_, p1, p2); break;
+#endif
+    default:                recurrence_scalar(out, n_, r_, p1, p2); break;
+  }
+}
+
+//  x[first], x[first + 1], ... into out; stream_ as for iota_span, from the
+//  size of the whole fill.
+template <recurrence_type T>
+inline void recurrence_span(std::span<T> s_, linear_recurrence<T> const & r0, std::uint64_t first,
+                            bool stream_) noexcept {
+  using U = simd::detail::lane_t<T>;
+  auto const r_ = as_lanes(r0);
+  U * out = reinterpret_cast<U *>(s_.data());
+  std::size_t n_ = s_.size();
+  for (; n_ != 0 && first < 2; ++out, --n_, ++first) {
+    *out = first == 0 ? r_.x0 : r_.x1;
+  }
+  if (n_ == 0) {
+    return;
+  }
+  auto const [p1, p2] = recurrence_state(r_, first - 1);
+  if (stream_) {
+    recurrence_dispatch<true>(out, n_, r_, p1, p2);
+  }
+  else {
+    recurrence_dispatch<false>(out, n_, r_, p1, p2);
+  }
+}
+
+} /* namespace detail */
+
+/*
+ *  MARK: recurrence_term()
+ *
+ *  x[n] by powers of the companion matrix, in O(log n) steps.
+ */
+template <recurrence_type T>
+constexpr T recurrence_term(linear_recurrence<T> const & r_, std::uint64_t n_) noexcept {
+  if (n_ == 0) {
+    return r_.x0;
+  }
+  return static_cast<T>(detail::recurrence_state(detail::as_lanes(r_), n_).first);
+}
+
+/*
+ *  MARK: fill_recurrence(), parallel_fill_recurrence()
+ *
+ *  out[i] = x[first + i].  Every block of terms is computed from the two
+ *  before it, and every chunk of a parallel fill starts from x[lo - 1] and
+ *  x[lo - 2] found by matrix powers, so no thread waits for another.  Integer
+ *  results equal the serial loop's; floating-point ones differ from it by
+ *  rounding, since each term is reached by a different sum of products.
+ */
+template <recurrence_type T>
+void fill_recurrence(std::span<T> out, linear_recurrence<T> const & r_, std::uint64_t first = 0) noexcept {
+  detail::recurrence_span(out, r_, first, out.size_bytes() > stream_bytes);
+}
+
+template <recurrence_type T>
+void parallel_fill_recurrence(thread_pool & pool, std::span<T> out, linear_recurrence<T> const & r_,
+                              std::uint64_t first = 0, std::size_t grain = fill_grain) {
+  bool const stream_ = out.size_bytes() > stream_bytes;
+  std::size_t const chunks = detail::chunk_count(out.size(), pool.size(), grain);
+  if (chunks == 1) {
+    detail::recurrence_span(out, r_, first, stream_);
+    return;
+  }
+  pool.parallel_for(chunks, [&](std::size_t c_) {
+    std::size_t const lo = out.size() * c_ / chunks;
+    std::size_t const hi = out.size() * (c_ + 1) / chunks;
+    detail::recurrence_span(out.subspan(lo, hi - lo), r_, first + lo, stream_);
+  });
+}
+
+template <recurrence_type T>
+void parallel_fill_recurrence(std::span<T> out, linear_recurrence<T> const & r_, std::uint64_t first = 0) {
+  parallel_fill_recurrence(default_pool(), out, r_, first);
+}
+
+} /* namespace cfnum */
+
+#endif /* recurrence_hpp */
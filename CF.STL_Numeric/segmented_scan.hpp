@@ -0,0 +1,644 @@
+//
+//  segmented_scan.hpp
+//  CF.STL_Numeric
+//
+//  MARK: - References.
+//  @see: Blelloch, "Vector Models for Data-Parallel Computing" (1990), ch. 4 (segmented scans)
+//  @see: Sengupta, Harris, Zhang & Owens, "Scan Primitives for GPU Computing" (2007)
+//  @see: https://nvidia.github.io/cccl/thrust/api/function_group__reductions_1gaf05e9f2b3a8dcdd4d40d0fa7e3c19dc0.html (thrust::reduce_by_key)
+//
+
+#ifndef segmented_scan_hpp
+#define segmented_scan_hpp
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "thread_pool.hpp"
+#include "parallel_reduce.hpp"
+#include "parallel_scan.hpp"
+#include "simd_kernels.hpp"
+#include "simd_scan.hpp"
+
+namespace cfnum {
+
+/*
+ *  MARK: segmented_inclusive_scan(), inclusive_scan_by_key(), reduce_by_key()
+ *
+ *  Scans and reductions that restart at segment boundaries, in one pass.  A
+ *  segment starts at the first element, at every element whose head flag is
+ *  set, or (the _by_key forms) at every element whose key is not pred-equal to
+ *  the key before it, so the groups of a sorted key column are its segments.
+ *  Inside a segment the operator conventions are those of std::inclusive_scan
+ *  without init: the first element is the seed, op(acc, x) is applied left to
+ *  right, and the accumulator has the value type of the input.
+ *
+ *  reduce_by_key writes one key and one reduced value per segment and returns
+ *  the ends of both outputs; its pred, op argument order is thrust's.
+ */
+template <typename InputIt, typename FlagIt, typename OutIt, typename BinaryOp = std::plus<>>
+OutIt segmented_inclusive_scan(InputIt first, InputIt last, FlagIt flags, OutIt d_first, BinaryOp op = {}) {
+  if (first == last) {
+    return d_first;
+  }
+  std::iter_value_t<InputIt> acc = *first;
+  *d_first = acc;
+  for (++first, ++flags, ++d_first; first != last; ++first, ++flags, ++d_first) {
+    if (*flags) {
+      acc = *first;
+    }
+    else {
+      acc = op(std::move(acc), *first);
+    }
+    *d_first = acc;
+  }
+  return d_first;
+}
+
+template <typename KeyIt, typename InputIt, typename OutIt,
+          typename BinaryPred = std::equal_to<>, typename BinaryOp = std::plus<>>
+OutIt inclusive_scan_by_key(KeyIt keys_first, KeyIt keys_last, InputIt first, OutIt d_first,
+                            BinaryPred pred = {}, BinaryOp op = {}) {
+  if (keys_first == keys_last) {
+    return d_first;
+  }
+  std::iter_value_t<KeyIt> key = *keys_first;
+  std::iter_value_t<InputIt> acc = *first;
+  *d_first = acc;
+  for (++keys_first, ++first, ++d_first; keys_first != keys_last; ++keys_first, ++first, ++d_first) {
+    if (pred(key, *keys_first)) {
+      acc = op(std::move(acc), *first);
+    }
+    else {
+      key = *keys_first;
+      acc = *first;
+    }
+    *d_first = acc;
+  }
+  return d_first;
+}
+
+template <typename KeyIt, typename InputIt, typename KeyOutIt, typename OutIt,
+          typename BinaryPred = std::equal_to<>, typename BinaryOp = std::plus<>>
+std::pair<KeyOutIt, OutIt> reduce_by_key(KeyIt keys_first, KeyIt keys_last, InputIt first,
+                                         KeyOutIt keys_out, OutIt d_first,
+                                         BinaryPred pred = {}, BinaryOp op = {}) {
+  if (keys_first == keys_last) {
+    return { keys_out, d_first };
+  }
+  std::iter_value_t<KeyIt> key = *keys_first;
+  std::iter_value_t<InputIt> acc = *first;
+  for (++keys_first, ++first; keys_first != keys_last; ++keys_first, ++first) {
+    if (pred(key, *keys_first)) {
+      acc = op(std::move(acc), *first);
+    }
+    else {
+      *keys_out = std::move(key);
+      *d_first = std::move(acc);
+      ++keys_out;
+      ++d_first;
+      key = *keys_first;
+      acc = *first;
+    }
+  }
+  *keys_out = std::move(key);
+  *d_first = std::move(acc);
+  return { ++keys_out, ++d_first };
+}
+
+namespace simd {
+
+//  Key columns the vector kernels compare lane by lane.
+template <typename K>
+concept segment_key = std::same_as<K, std::int32_t> || std::same_as<K, std::uint32_t>
+                   || std::same_as<K, std::int64_t> || std::same_as<K, std::uint64_t>;
+
+namespace detail {
+
+/*
+ *  Where segments start, as a scalar test at(i) and as a lane mask for the L
+ *  elements from i (all ones where a segment starts).  Both read absolute
+ *  indices, so a chunk of a longer range sees the heads the whole range has.
+ *  Vector loads from key_heads need i >= 1: they compare keys[i ..] with the
+ *  overlapping keys[i - 1 ..].
+ */
+struct flag_heads {
+  std::uint8_t const * flags;
+
+  bool at(std::size_t i_) const noexcept { return flags[i_] != 0; }
+
+  //  Sixteen flags widen in one instruction.  GCC splits narrower byte vectors
+  //  into scalars, so up to eight flags are read as one integer, broadcast,
+  //  and shifted into place lane by lane.
+  template <std::size_t L, typename M, std::size_t... Is>
+  [[gnu::always_inline]] void mask(M & h_, std::size_t i_, std::index_sequence<Is...>) const noexcept {
+    if constexpr (L == 16) {
+      typename vec<std::uint8_t, 16>::type f_;
+      load(f_, flags + i_);
+      h_ = __builtin_convertvector(f_, M) != 0;
+    }
+    else {
+      using W = typename vec<std::uint64_t, L * sizeof(std::uint64_t)>::type;
+      std::uint64_t q_ = 0;
+      std::memcpy(&q_, flags + i_, L);
+      W const f_ = ((q_ - W {}) >> W { (Is * 8)... }) & 0xffu;
+      h_ = __builtin_convertvector(f_ != 0, M);
+    }
+  }
+
+  template <std::size_t L, typename M>
+  [[gnu::always_inline]] void mask(M & h_, std::size_t i_) const noexcept {
+    mask<L>(h_, i_, std::make_index_sequence<L> {});
+  }
+};
+
+template <typename K>
+struct key_heads {
+  K const * keys;
+
+  bool at(std::size_t i_) const noexcept { return i_ == 0 || keys[i_] != keys[i_ - 1]; }
+
+  template <std::size_t L, typename M>
+  [[gnu::always_inline]] void mask(M & h_, std::size_t i_) const noexcept {
+    using W = typename vec<lane_t<K>, L * sizeof(K)>::type;
+    W a_;
+    W b_;
+    load(a_, keys + i_);
+    load(b_, keys + i_ - 1);
+    h_ = __builtin_convertvector(a_ != b_, M);
+  }
+};
+
+//  a = h ? b : a, lane by lane, for vectors of any element type.
+template <typename V, typename M>
+[[gnu::always_inline]] inline void select_lanes(V & a_, M const & h_, V const & b_) noexcept {
+  a_ = (V) (((M) a_ & ~h_) | ((M) b_ & h_));
+}
+
+//  The log_step of simd_scan.hpp on (head, value) pairs: a lane only takes in
+//  the lane K below it while no head lies between them, and then inherits that
+//  lane's heads.  Afterwards h holds "a segment starts at or below this lane".
+template <std::size_t K, std::size_t L, typename Kind, typename V, typename M>
+[[gnu::always_inline]] inline void segmented_log_step(V & v_, M & h_, V const & fill) noexcept {
+  if constexpr (K < L) {
+    V s_;
+    M g_;
+    shift_up<K, L>(s_, v_, fill, std::make_index_sequence<L> {});
+    shift_up<K, L>(g_, h_, M {}, std::make_index_sequence<L> {});
+    select_lanes(s_, h_, fill);
+    Kind::apply(v_, s_);
+    h_ |= g_;
+    segmented_log_step<2 * K, L, Kind>(v_, h_, fill);
+  }
+}
+
+//  Any lane set, by OR-ing halves of the mask together down to one word.
+template <typename W>
+[[gnu::always_inline]] inline bool any_word(W const & w_) noexcept {
+  if constexpr (sizeof(W) == 16) {
+    return (w_[0] | w_[1]) != 0;
+  }
+  else if constexpr (sizeof(W) == 32) {
+    auto const h_ = __builtin_shufflevector(w_, w_, 0, 1) | __builtin_shufflevector(w_, w_, 2, 3);
+    return any_word(h_);
+  }
+  else {
+    auto const h_ = __builtin_shufflevector(w_, w_, 0, 1, 2, 3) | __builtin_shufflevector(w_, w_, 4, 5, 6, 7);
+    return any_word(h_);
+  }
+}
+
+template <typename M>
+[[gnu::always_inline]] inline bool any_lane(M const & h_) noexcept {
+  return any_word((typename vec<std::uint64_t, sizeof(M)>::type) h_);
+}
+
+//  One scalar step of a segmented scan.
+template <typename Kind, typename Heads, typename U>
+[[gnu::always_inline]] inline void segmented_step(Heads const & heads, U const * in, std::size_t i_, U & carry) noexcept {
+  if (heads.at(i_)) {
+    carry = in[i_];
+  }
+  else {
+    Kind::apply(carry, in[i_]);
+  }
+}
+
+template <typename Kind, typename Heads, typename U>
+inline U segmented_scan_scalar(Heads const & heads, U const * in, U * out,
+                               std::size_t lo, std::size_t hi, U carry) noexcept {
+  for (std::size_t i_ = lo; i_ < hi; ++i_) {
+    segmented_step<Kind>(heads, in, i_, carry);
+    out[i_] = carry;
+  }
+  return carry;
+}
+
+//  out[i] for i in [lo, hi); carry is folded into the lanes before the first
+//  head, exactly as scan_kernel folds it into every lane.
+template <std::size_t Bytes, typename Kind, typename Heads, typename U>
+[[gnu::always_inline]] inline U segmented_scan_kernel(Heads const & heads, U const * in, U * out,
+                                                      std::size_t lo, std::size_t hi, U carry) noexcept {
+  using V = typename vec<U, Bytes>::type;
+  using M = decltype(V {} != V {});
+  constexpr std::size_t L = vec<U, Bytes>::lanes;
+  if constexpr (L < 4) {
+    return segmented_scan_scalar<Kind>(heads, in, out, lo, hi, carry);
+  }
+  std::size_t i_ = lo;
+  if (i_ == 0 && i_ < hi) {
+    segmented_step<Kind>(heads, in, i_, carry);
+    out[i_++] = carry;
+  }
+  V const fill = V {} + Kind::template identity<U>();
+  V carry_v = carry - V {};
+  V v_;
+  V s_;
+  M h_;
+  for (; i_ + L <= hi; i_ += L) {
+    load(v_, in + i_);
+    heads.template mask<L>(h_, i_);
+    if (any_lane(h_)) {
+      segmented_log_step<1, L, Kind>(v_, h_, fill);
+      s_ = carry_v;
+      select_lanes(s_, h_, fill);
+      Kind::apply(v_, s_);
+    }
+    else {
+      log_step<1, L, Kind>(v_, fill);
+      Kind::apply(v_, carry_v);
+    }
+    std::memcpy(out + i_, &v_, sizeof(V));
+    broadcast_last<L>(carry_v, v_, std::make_index_sequence<L> {});
+  }
+  carry = carry_v[0];
+  for (; i_ < hi; ++i_) {
+    segmented_step<Kind>(heads, in, i_, carry);
+    out[i_] = carry;
+  }
+  return carry;
+}
+
+//  One element of reduce_by_key, g groups closed and carry open.  Branch-free:
+//  slot g belongs to the open group until a head closes it, so writing it on
+//  every element stays inside the output.
+template <typename Kind, typename K, typename U>
+[[gnu::always_inline]] inline void reduce_by_key_step(K const * keys, U const * in, std::size_t i_,
+                                                      K * keys_out, U * out, std::size_t & g_, U & carry) noexcept {
+  bool const head = keys[i_] != keys[i_ - 1];
+  keys_out[g_] = keys[i_ - 1];
+  out[g_] = carry;
+  g_ += head;
+  carry = head ? Kind::template identity<U>() : carry;
+  Kind::apply(carry, in[i_]);
+}
+
+template <typename Kind, typename K, typename U>
+inline std::size_t reduce_by_key_scalar(K const * keys, U const * in, std::size_t lo, std::size_t hi,
+                                        K * keys_out, U * out) noexcept {
+  std::size_t g_ = 0;
+  U carry = in[lo];
+  for (std::size_t i_ = lo + 1; i_ < hi; ++i_) {
+    reduce_by_key_step<Kind>(keys, in, i_, keys_out, out, g_, carry);
+  }
+  keys_out[g_] = keys[hi - 1];
+  out[g_] = carry;
+  return g_ + 1;
+}
+
+/*
+ *  Groups of [lo, hi), lo taken as a head.  A vector with no head in it is
+ *  folded into a vector accumulator, one compare and one op.  A vector with
+ *  heads is scanned as in segmented_scan_kernel and its lanes are stored to
+ *  the open group's slot, the slot moving on at each head: only the slot
+ *  index runs from lane to lane, not the op.
+ */
+template <std::size_t Bytes, typename Kind, typename K, typename U>
+[[gnu::always_inline]] inline std::size_t reduce_by_key_kernel(K const * keys, U const * in, std::size_t lo,
+                                                               std::size_t hi, K * keys_out, U * out) noexcept {
+  using V = typename vec<U, Bytes>::type;
+  using M = decltype(V {} != V {});
+  constexpr std::size_t L = vec<U, Bytes>::lanes;
+  if constexpr (L < 4) {
+    return reduce_by_key_scalar<Kind>(keys, in, lo, hi, keys_out, out);
+  }
+  key_heads<K> const heads { keys };
+  std::size_t g_ = 0;
+  U carry = in[lo];
+  std::size_t i_ = lo + 1;
+  V const fill = V {} + Kind::template identity<U>();
+  V acc = fill;
+  V v_;
+  V s_;
+  M h_;
+  U lanes_[L];
+  for (; i_ + L <= hi; i_ += L) {
+    load(v_, in + i_);
+    heads.template mask<L>(h_, i_);
+    if (!any_lane(h_)) {
+      Kind::apply(acc, v_);
+      continue;
+    }
+    for (std::size_t l_ = 0; l_ < L; ++l_) {
+      Kind::apply(carry, acc[l_]);
+    }
+    acc = fill;
+    keys_out[g_] = keys[i_ - 1];
+    out[g_] = carry;
+    segmented_log_step<1, L, Kind>(v_, h_, fill);
+    s_ = carry - V {};
+    select_lanes(s_, h_, fill);
+    Kind::apply(v_, s_);
+    std::memcpy(lanes_, &v_, sizeof(V));
+    for (std::size_t l_ = 0; l_ < L; ++l_) {
+      g_ += keys[i_ + l_] != keys[i_ + l_ - 1];
+      keys_out[g_] = keys[i_ + l_];
+      out[g_] = lanes_[l_];
+    }
+    carry = lanes_[L - 1];
+  }
+  for (std::size_t l_ = 0; l_ < L; ++l_) {
+    Kind::apply(carry, acc[l_]);
+  }
+  for (; i_ < hi; ++i_) {
+    reduce_by_key_step<Kind>(keys, in, i_, keys_out, out, g_, carry);
+  }
+  keys_out[g_] = keys[hi - 1];
+  out[g_] = carry;
+  return g_ + 1;
+}
+
+#if defined(CFNUM_SIMD_X86)
+template <typename Kind, typename Heads, typename U>
+[[gnu::target("avx512f,avx512dq")]] U segmented_scan_avx512(Heads const & heads, U const * in, U * out,
+                                                                     std::size_t lo, std::size_t hi,
+                                                                     U carry) noexcept {
+  return segmented_scan_kernel<64, Kind>(heads, in, out, lo, hi, carry);
+}
+
+template <typename Kind, typename Heads, typename U>
+[[gnu::target("avx2,fma")]] U segmented_scan_avx2(Heads const & heads, U const * in, U * out,
+                                                  std::size_t lo, std::size_t hi, U carry) noexcept {
+  return segmented_scan_kernel<32, Kind>(heads, in, out, lo, hi, carry);
+}
+
+template <typename Kind, typename K, typename U>
+[[gnu::target("avx512f,avx512dq")]] std::size_t reduce_by_key_avx512(K const * keys, U const * in,
+                                                                              std::size_t lo, std::size_t hi,
+                                                                              K * keys_out, U * out) noexcept {
+  return reduce_by_key_kernel<64, Kind>(keys, in, lo, hi, keys_out, out);
+}
+
+template <typename Kind, typename K, typename U>
+[[gnu::target("avx2,fma")]] std::size_t reduce_by_key_avx2(K const * keys, U const * in, std::size_t lo,
+                                                           std::size_t hi, K * keys_out, U * out) noexcept {
+  return reduce_by_key_kernel<32, Kind>(keys, in, lo, hi, keys_out, out);
+}
+#endif
+
+template <typename Op, typename T, typename Heads>
+inline T segmented_scan_dispatch(Heads const & heads, std::span<T const> in, std::span<T> out,
+                                 std::size_t lo, std::size_t hi, T carry) noexcept {
+  using Kind = typename scan_kind<Op>::type;
+  using U = scan_lane_t<Kind, T>;
+  auto const * pi = reinterpret_cast<U const *>(in.data());
+  auto * po = reinterpret_cast<U *>(out.data());
+  auto const c_ = static_cast<U>(carry);
+  switch (active_isa()) {
+#if defined(CFNUM_SIMD_X86)
+    case isa::avx512: return static_cast<T>(segmented_scan_avx512<Kind>(heads, pi, po, lo, hi, c_));
+    case isa::avx2:   return static_cast<T>(segmented_scan_avx2<Kind>(heads, pi, po, lo, hi, c_));
+    case isa::sse2:   return static_cast<T>(segmented_scan_kernel<16, Kind>(heads, pi, po, lo, hi, c_));
+#elif defined(CFNUM_SIMD_NEON)
+    case isa::neon:   return static_cast<T>(segmented_scan_kernel<16, Kind>(heads, pi, po, lo, hi, c_));
+#endif
+    default:          return static_cast<T>(segmented_scan_scalar<Kind>(heads, pi, po, lo, hi, c_));
+  }
+}
+
+template <typename Op, typename K, typename T>
+inline std::size_t reduce_by_key_dispatch(std::span<K const> keys, std::span<T const> in, std::size_t lo,
+                                          std::size_t hi, K * keys_out, T * out) noexcept {
+  using Kind = typename scan_kind<Op>::type;
+  using U = scan_lane_t<Kind, T>;
+  auto const * pi = reinterpret_cast<U const *>(in.data());
+  auto * po = reinterpret_cast<U *>(out);
+  switch (active_isa()) {
+#if defined(CFNUM_SIMD_X86)
+    case isa::avx512: return reduce_by_key_avx512<Kind>(keys.data(), pi, lo, hi, keys_out, po);
+    case isa::avx2:   return reduce_by_key_avx2<Kind>(keys.data(), pi, lo, hi, keys_out, po);
+    case isa::sse2:   return reduce_by_key_kernel<16, Kind>(keys.data(), pi, lo, hi, keys_out, po);
+#elif defined(CFNUM_SIMD_NEON)
+    case isa::neon:   return reduce_by_key_kernel<16, Kind>(keys.data(), pi, lo, hi, keys_out, po);
+#endif
+    default:          return reduce_by_key_scalar<Kind>(keys.data(), pi, lo, hi, keys_out, po);
+  }
+}
+
+} /* namespace detail */
+
+/*
+ *  MARK: simd::segmented_inclusive_scan(), simd::inclusive_scan_by_key(), simd::reduce_by_key()
+ *
+ *  Contiguous kernel_type values under a scan_operator (std::plus, maximum,
+ *  minimum).  flags holds one byte per element, nonzero starting a segment.
+ *  The segmented scan works like simd::inclusive_scan: carry is folded into
+ *  the elements before the first head (so a block can continue the last
+ *  segment of the one before), and the value of the last segment is returned.
+ *  Each vector is scanned in log2(lanes) steps, so floating-point sums
+ *  reassociate inside a segment as they do there.  reduce_by_key returns the
+ *  number of groups written; keys_out and out need room for all of them.
+ */
+template <kernel_type T, typename Op = std::plus<>>
+  requires scan_operator<Op, T>
+inline T segmented_inclusive_scan(std::span<T const> in, std::span<std::uint8_t const> flags, std::span<T> out,
+                                  Op = {}, T carry = scan_identity<Op, T>()) noexcept {
+  return detail::segmented_scan_dispatch<Op>(detail::flag_heads { flags.data() }, in, out, 0, in.size(), carry);
+}
+
+template <segment_key K, kernel_type T, typename Op = std::plus<>>
+  requires scan_operator<Op, T>
+inline T inclusive_scan_by_key(std::span<K const> keys, std::span<T const> in, std::span<T> out, Op = {}) noexcept {
+  return detail::segmented_scan_dispatch<Op>(detail::key_heads<K> { keys.data() }, in, out, 0, in.size(),
+                                             scan_identity<Op, T>());
+}
+
+template <segment_key K, kernel_type T, typename Op = std::plus<>>
+  requires scan_operator<Op, T>
+inline std::size_t reduce_by_key(std::span<K const> keys, std::span<T const> in, std::span<K> keys_out,
+                                 std::span<T> out, Op = {}) noexcept {
+  if (in.empty()) {
+    return 0;
+  }
+  return detail::reduce_by_key_dispatch<Op>(keys, in, 0, in.size(), keys_out.data(), out.data());
+}
+
+} /* namespace simd */
+
+namespace detail {
+
+//  Two passes over chunks instead of three: every chunk is scanned from the
+//  identity at once, then only its elements before the first head, the ones
+//  the chunks to its left reach, get their carry folded in.
+template <typename Op, typename T, typename Heads>
+void parallel_segmented_scan(thread_pool & pool, Heads const & heads, std::span<T const> in, std::span<T> out,
+                             Op op, std::size_t grain) {
+  std::size_t const n = in.size();
+  std::size_t const chunks = chunk_count(n, pool.size(), grain);
+  if (chunks == 1) {
+    simd::detail::segmented_scan_dispatch<Op>(heads, in, out, 0, n, simd::scan_identity<Op, T>());
+    return;
+  }
+
+  auto bound = [n, chunks](std::size_t c_) { return n * c_ / chunks; };
+  std::vector<T> tail(chunks);
+  std::vector<std::size_t> first_head(chunks);
+  pool.parallel_for(chunks, [&](std::size_t c_) {
+    std::size_t const lo = bound(c_);
+    std::size_t const hi = bound(c_ + 1);
+    tail[c_] = simd::detail::segmented_scan_dispatch<Op>(heads, in, out, lo, hi, simd::scan_identity<Op, T>());
+    std::size_t h_ = lo;
+    while (h_ < hi && !heads.at(h_)) {
+      ++h_;
+    }
+    first_head[c_] = h_;
+  });
+
+  //  carry[c] = value of the segment open at the end of chunk c - 1.
+  std::vector<T> carry(chunks);
+  carry[0] = simd::scan_identity<Op, T>();
+  for (std::size_t c_ = 1; c_ < chunks; ++c_) {
+    bool const restarted = first_head[c_ - 1] < bound(c_);
+    carry[c_] = restarted ? tail[c_ - 1] : op(carry[c_ - 1], tail[c_ - 1]);
+  }
+  pool.parallel_for(chunks - 1, [&](std::size_t c_) {
+    T const c0 = carry[c_ + 1];
+    for (std::size_t i_ = bound(c_ + 1); i_ < first_head[c_ + 1]; ++i_) {
+      out[i_] = op(c0, out[i_]);
+    }
+  });
+}
+
+} /* namespace detail */
+
+/*
+ *  MARK: parallel_segmented_inclusive_scan(), parallel_inclusive_scan_by_key(), parallel_reduce_by_key()
+ *
+ *  The simd:: forms split across the pool.  Chunk boundaries ignore segment
+ *  boundaries: a segment spanning chunks gets the value of its earlier part
+ *  folded in afterwards, left to right, so integer results and all max/min
+ *  results equal the serial ones.  parallel_reduce_by_key counts the groups
+ *  starting in each chunk first, so every chunk knows where its own groups go
+ *  and writes them directly.
+ */
+template <simd::kernel_type T, typename BinaryOp = std::plus<>>
+  requires simd::scan_operator<BinaryOp, T>
+void parallel_segmented_inclusive_scan(thread_pool & pool, std::span<T const> in,
+                                       std::span<std::uint8_t const> flags, std::span<T> out,
+                                       BinaryOp op = {}, std::size_t grain = scan_grain) {
+  detail::parallel_segmented_scan(pool, simd::detail::flag_heads { flags.data() }, in, out, op, grain);
+}
+
+template <simd::segment_key K, simd::kernel_type T, typename BinaryOp = std::plus<>>
+  requires simd::scan_operator<BinaryOp, T>
+void parallel_inclusive_scan_by_key(thread_pool & pool, std::span<K const> keys, std::span<T const> in,
+                                    std::span<T> out, BinaryOp op = {}, std::size_t grain = scan_grain) {
+  detail::parallel_segmented_scan(pool, simd::detail::key_heads<K> { keys.data() }, in, out, op, grain);
+}
+
+template <simd::segment_key K, simd::kernel_type T, typename BinaryOp = std::plus<>>
+  requires simd::scan_operator<BinaryOp, T>
+std::size_t parallel_reduce_by_key(thread_pool & pool, std::span<K const> keys, std::span<T const> in,
+                                   std::span<K> keys_out, std::span<T> out,
+                                   BinaryOp op = {}, std::size_t grain = scan_grain) {
+  std::size_t const n = in.size();
+  std::size_t const chunks = detail::chunk_count(n, pool.size(), grain);
+  if (chunks == 1) {
+    return simd::reduce_by_key(keys, in, keys_out, out, op);
+  }
+
+  //  Pass 1: groups starting in each chunk, and where the first one starts.
+  auto bound = [n, chunks](std::size_t c_) { return n * c_ / chunks; };
+  std::vector<std::size_t> offset(chunks + 1);
+  std::vector<std::size_t> first_head(chunks);
+  pool.parallel_for(chunks, [&](std::size_t c_) {
+    std::size_t const lo = bound(c_);
+    std::size_t const hi = bound(c_ + 1);
+    std::size_t count = lo == 0 ? 1 : 0;
+    for (std::size_t i_ = std::max<std::size_t>(lo, 1); i_ < hi; ++i_) {
+      count += keys[i_] != keys[i_ - 1];
+    }
+    std::size_t h_ = lo;
+    while (h_ < hi && h_ != 0 && keys[h_] == keys[h_ - 1]) {
+      ++h_;
+    }
+    offset[c_ + 1] = count;
+    first_head[c_] = h_;
+  });
+  for (std::size_t c_ = 1; c_ <= chunks; ++c_) {
+    offset[c_] += offset[c_ - 1];
+  }
+
+  //  Pass 2: each chunk reduces its own groups in place, and the elements
+  //  before its first head to a partial value for the group on its left.
+  std::vector<detail::padded<T>> partial(chunks);
+  pool.parallel_for(chunks, [&](std::size_t c_) {
+    std::size_t const lo = bound(c_);
+    std::size_t const hi = bound(c_ + 1);
+    std::size_t const h_ = first_head[c_];
+    if (h_ > lo) {
+      T acc = in[lo];
+      for (std::size_t i_ = lo + 1; i_ < h_; ++i_) {
+        acc = op(acc, in[i_]);
+      }
+      partial[c_].value = acc;
+    }
+    if (h_ < hi) {
+      simd::detail::reduce_by_key_dispatch<BinaryOp>(keys, in, h_, hi, keys_out.data() + offset[c_],
+                                                     out.data() + offset[c_]);
+    }
+  });
+
+  //  Pass 3: fold the partials into the groups they continue, left to right.
+  for (std::size_t c_ = 1; c_ < chunks; ++c_) {
+    if (first_head[c_] > bound(c_)) {
+      T & g_ = out[offset[c_] - 1];
+      g_ = op(g_, partial[c_].value);
+    }
+  }
+  return offset[chunks];
+}
+
+template <simd::kernel_type T, typename BinaryOp = std::plus<>>
+  requires simd::scan_operator<BinaryOp, T>
+void parallel_segmented_inclusive_scan(std::span<T const> in, std::span<std::uint8_t const> flags,
+                                       std::span<T> out, BinaryOp op = {}) {
+  parallel_segmented_inclusive_scan(default_pool(), in, flags, out, op);
+}
+
+template <simd::segment_key K, simd::kernel_type T, typename BinaryOp = std::plus<>>
+  requires simd::scan_operator<BinaryOp, T>
+void parallel_inclusive_scan_by_key(std::span<K const> keys, std::span<T const> in, std::span<T> out,
+                                    BinaryOp op = {}) {
+  parallel_inclusive_scan_by_key(default_pool(), keys, in, out, op);
+}
+
+template <simd::segment_key K, simd::kernel_type T, typename BinaryOp = std::plus<>>
+  requires simd::scan_operator<BinaryOp, T>
+std::size_t parallel_reduce_by_key(std::span<K const> keys, std::span<T const> in, std::span<K> keys_out,
+                                   std::span<T> out, BinaryOp op = {}) {
+  return parallel_reduce_by_key(default_pool(), keys, in, keys_out, out, op);
+}
+
+} /* namespace cfnum */
+
+#endif /* segmented_scan_hpp */
@@ -0,0 +1,210 @@
+//
+//  sequences.hpp
+//  CF.STL_Numeric
+//
+//  MARK: - References.
+//  @see: https://oeis.org/A000045 (Fibonacci numbers)
+//  @see: https://oeis.org/A000142 (factorials)
+//  @see: https://www.nayuki.io/page/fast-fibonacci-algorithms (fast doubling)
+//
+
+#ifndef sequences_hpp
+#define sequences_hpp
+
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+
+namespace cfnum {
+
+//  Unsigned types with generated tables.
+template <typename T>
+concept table_type = std::same_as<T, std::uint32_t> || std::same_as<T, std::uint64_t>
+                  || std::same_as<T, unsigned __int128>;
+
+//  Decimal text of a 128-bit value (iostreams have no operator<< for it).
+inline std::string to_string(unsigned __int128 v_) {
+  std::string s_;
+  do {
+    s_.insert(s_.begin(), static_cast<char>('0' + static_cast<int>(v_ % 10)));
+    v_ /= 10;
+  } while (v_ != 0);
+  return s_;
+}
+
+inline std::string to_string(__int128 v_) {
+  return v_ < 0 ? '-' + to_string(0 - static_cast<unsigned __int128>(v_)) : to_string(static_cast<unsigned __int128>(v_));
+}
+
+namespace detail {
+
+template <table_type T>
+constexpr T max_of() noexcept { return T(~T(0)); }
+
+//  Largest n with F(n) representable in T (F(0) = 0, F(1) = 1).
+template <table_type T>
+constexpr std::size_t fibonacci_limit() noexcept {
+  T a_ = 0;
+  T b_ = 1;
+  std::size_t n_ = 0;
+  while (b_ <= max_of<T>() - a_) {
+    b_ = a_ + b_;
+    a_ = b_ - a_;
+    ++n_;
+  }
+  return n_ + 1;
+}
+
+//  Largest n with n! representable in T.
+template <table_type T>
+constexpr std::size_t factorial_limit() noexcept {
+  T f_ = 1;
+  std::size_t n_ = 0;
+  while (f_ <= max_of<T>() / (n_ + 1)) {
+    f_ *= T(n_ + 1);
+    ++n_;
+  }
+  return n_;
+}
+
+template <table_type T, std::size_t N>
+constexpr std::array<T, N> make_fibonacci() noexcept {
+  std::array<T, N> t_ {};
+  for (std::size_t i_ = 1; i_ < N; ++i_) {
+    t_[i_] = i_ == 1 ? T(1) : T(t_[i_ - 1] + t_[i_ - 2]);
+  }
+  return t_;
+}
+
+template <table_type T, std::size_t N>
+constexpr std::array<T, N> make_factorial() noexcept {
+  std::array<T, N> t_ {};
+  t_[0] = 1;
+  for (std::size_t i_ = 1; i_ < N; ++i_) {
+    t_[i_] = t_[i_ - 1] * T(i_);
+  }
+  return t_;
+}
+
+} /* namespace detail */
+
+/*
+ *  MARK: fibonacci_table, factorial_table
+ *
+ *  Built by the compiler: F(0) .. F(fibonacci_max_index<T>) and
+ *  0! .. factorial_max_index<T>!, every entry that fits in T.
+ *    uint32_t           F(47), 12!
+ *    uint64_t           F(93), 20!
+ *    unsigned __int128  F(186), 34!
+ */
+template <table_type T>
+inline constexpr std::size_t fibonacci_max_index = detail::fibonacci_limit<T>();
+
+template <table_type T>
+inline constexpr std::size_t factorial_max_index = detail::factorial_limit<T>();
+
+template <table_type T>
+inline constexpr std::array<T, fibonacci_max_index<T> + 1> fibonacci_table
+  = detail::make_fibonacci<T, fibonacci_max_index<T> + 1>();
+
+template <table_type T>
+inline constexpr std::array<T, factorial_max_index<T> + 1> factorial_table
+  = detail::make_factorial<T, factorial_max_index<T> + 1>();
+
+static_assert(fibonacci_max_index<std::uint32_t> == 47 && fibonacci_max_index<std::uint64_t> == 93
+              && fibonacci_max_index<unsigned __int128> == 186);
+static_assert(factorial_max_index<std::uint32_t> == 12 && factorial_max_index<std::uint64_t> == 20
+              && factorial_max_index<unsigned __int128> == 34);
+static_assert(fibonacci_table<std::uint64_t>[93] == 12'200'160'415'121'876'738ULL);
+static_assert(factorial_table<std::uint64_t>[20] == 2'432'902'008'176'640'000ULL);
+
+/*
+ *  MARK: fibonacci(), factorial()
+ *
+ *  Checked table lookup: std::nullopt when the value does not fit in T.
+ */
+template <table_type T>
+constexpr std::optional<T> fibonacci(std::size_t n_) noexcept {
+  if (n_ > fibonacci_max_index<T>) {
+    return std::nullopt;
+  }
+  return fibonacci_table<T>[n_];
+}
+
+template <table_type T>
+constexpr std::optional<T> factorial(std::size_t n_) noexcept {
+  if (n_ > factorial_max_index<T>) {
+    return std::nullopt;
+  }
+  return factorial_table<T>[n_];
+}
+
+/*
+ *  MARK: fibonacci_mod()
+ *
+ *  F(n) mod m in O(log n) by fast doubling, for indices far past any table:
+ *    F(2k)     = F(k) * (2 F(k+1) - F(k))
+ *    F(2k + 1) = F(k)^2 + F(k+1)^2
+ *  Products are formed in 128 bits, so any 64-bit modulus works.  m == 0 means
+ *  no reduction (the result then wraps modulo 2^64).
+ */
+constexpr std::uint64_t fibonacci_mod(std::uint64_t n_, std::uint64_t m_) noexcept {
+  using u128 = unsigned __int128;
+  auto reduce = [m_](u128 x_) { return m_ == 0 ? std::uint64_t(x_) : std::uint64_t(x_ % m_); };
+  std::uint64_t a_ = 0;                       //  F(k)
+  std::uint64_t b_ = reduce(1);               //  F(k + 1)
+  for (int bit = 63; bit >= 0; --bit) {
+    std::uint64_t const two_b = reduce(u128(b_) * 2);
+    std::uint64_t const diff = reduce(u128(two_b) + m_ - a_);
+    std::uint64_t const c_ = reduce(u128(a_) * diff);                       //  F(2k)
+    std::uint64_t const d_ = reduce(u128(a_) * a_ + u128(b_) * b_);         //  F(2k + 1)
+    if ((n_ >> bit) & 1) {
+      a_ = d_;
+      b_ = reduce(u128(c_) + d_);
+    }
+    else {
+      a_ = c_;
+      b_ = d_;
+    }
+  }
+  return a_;
+}
+
+/*
+ *  MARK: fibonacci_pair()
+ *
+ *  (F(n), F(n + 1)) by the same fast doubling in T, std::nullopt unless both fit.
+ *  Used where a table would be the wrong size, e.g. to seed a recurrence at n.
+ */
+template <table_type T>
+constexpr std::optional<std::pair<T, T>> fibonacci_pair(std::size_t n_) noexcept {
+  if (n_ >= fibonacci_max_index<T>) {
+    return std::nullopt;
+  }
+  T a_ = 0;
+  T b_ = 1;
+  for (int bit = std::bit_width(n_) - 1; bit >= 0; --bit) {
+    T const c_ = a_ * (T(2) * b_ - a_);
+    T const d_ = a_ * a_ + b_ * b_;
+    if ((n_ >> bit) & 1) {
+      a_ = d_;
+      b_ = c_ + d_;
+    }
+    else {
+      a_ = c_;
+      b_ = d_;
+    }
+  }
+  return std::pair { a_, b_ };
+}
+
+static_assert(fibonacci_pair<std::uint64_t>(92)->second == fibonacci_table<std::uint64_t>[93]);
+
+} /* namespace cfnum */
+
+#endif /* sequences_hpp */
@@ -0,0 +1,358 @@
+//
+//  simd_kernels.hpp
+//  CF.STL_Numeric
+//
+//  MARK: - References.
+//  @see: https://gcc.gnu.org/onlinedocs/gcc/Vector-Extensions.html
+//  @see: https://gcc.gnu.org/onlinedocs/gcc/x86-Built-in-Functions.html
+//
+
+#ifndef simd_kernels_hpp
+#define simd_kernels_hpp
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CFNUM_SIMD_X86 1
+#elif defined(__aarch64__) || defined(__ARM_NEON)
+#define CFNUM_SIMD_NEON 1
+#endif
+
+namespace cfnum::simd {
+
+/*
+ *  MARK: isa
+ *
+ *  Instruction sets the kernels are built for.  The best one the CPU supports is
+ *  picked once at first use (CPUID on x86); force_isa() lowers it, which the
+ *  benchmarks use to compare kernels on the same machine.
+ */
+enum class isa : int { scalar, neon, sse2, avx2, avx512, };
+
+inline char const * isa_name(isa i_) noexcept {
+  switch (i_) {
+    case isa::neon:   return "neon";
+    case isa::sse2:   return "sse2";
+    case isa::avx2:   return "avx2";
+    case isa::avx512: return "avx512";
+    default:          return "scalar";
+  }
+}
+
+inline isa detect_isa() noexcept {
+#if defined(CFNUM_SIMD_X86)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq")) {
+    return isa::avx512;
+  }
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+    return isa::avx2;
+  }
+  return isa::sse2;
+#elif defined(CFNUM_SIMD_NEON)
+  return isa::neon;
+#else
+  return isa::scalar;
+#endif
+}
+
+inline isa & active_isa_ref() noexcept {
+  static isa current = detect_isa();
+  return current;
+}
+
+inline isa active_isa() noexcept {
+  return active_isa_ref();
+}
+
+inline bool supports(isa i_) noexcept {
+  isa const best = detect_isa();
+  if (i_ == isa::scalar || i_ == best) {
+    return true;
+  }
+#if defined(CFNUM_SIMD_X86)
+  return i_ != isa::neon && static_cast<int>(i_) < static_cast<int>(best);
+#else
+  return false;
+#endif
+}
+
+//  Select a kernel family; requests the CPU cannot run are ignored.
+inline void force_isa(isa i_) noexcept {
+  if (supports(i_)) {
+    active_isa_ref() = i_;
+  }
+}
+
+//  Element types with hand-written kernels.
+template <typename T>
+concept kernel_type = std::same_as<T, double> || std::same_as<T, float>
+                   || std::same_as<T, std::int32_t> || std::same_as<T, std::int64_t>;
+
+namespace detail {
+
+//  Integers are folded as unsigned so lane overflow wraps instead of being UB.
+template <typename T>
+struct lane { using type = T; };
+
+template <std::integral T>
+struct lane<T> { using type = std::make_unsigned_t<T>; };
+
+template <typename T>
+using lane_t = typename lane<T>::type;
+
+template <typename U, std::size_t Bytes>
+struct vec {
+  typedef U type __attribute__((vector_size(Bytes)));
+  static constexpr std::size_t lanes = Bytes / sizeof(U);
+};
+
+//  Vectors are passed by reference throughout: by-value vector arguments in
+//  functions without the matching target attribute would change the ABI.
+template <typename V, typename U>
+[[gnu::always_inline]] inline void load(V & v_, U const * p_) noexcept {
+  std::memcpy(&v_, p_, sizeof(V));
+}
+
+//  Lane-wise |x| of a vector holding signed values as unsigned lanes
+//  (the most negative value comes out as its true magnitude).
+template <bool Signed, typename V, typename U>
+[[gnu::always_inline]] inline void magnitude_lanes(V & x_) noexcept {
+  if constexpr (Signed) {
+    V const m_ = V {} - (x_ >> (std::numeric_limits<U>::digits - 1));
+    x_ = (x_ ^ m_) - m_;
+  }
+}
+
+struct add_op {
+  template <typename X>
+  [[gnu::always_inline]] static void apply(X & a_, X const & b_) noexcept { a_ += b_; }
+  static constexpr int identity = 0;
+};
+
+struct mul_op {
+  template <typename X>
+  [[gnu::always_inline]] static void apply(X & a_, X const & b_) noexcept { a_ *= b_; }
+  static constexpr int identity = 1;
+};
+
+//  Four independent vector accumulators hide the add/mul latency; the loop-carried
+//  dependency of a strict left fold is what stops the compiler doing this itself.
+template <std::size_t Bytes, typename Op, typename U>
+[[gnu::always_inline]] inline U fold_kernel(U const * p_, std::size_t n_) noexcept {
+  using V = typename vec<U, Bytes>::type;
+  constexpr std::size_t L = vec<U, Bytes>::lanes;
+  V a0 = V {} + U(Op::identity);
+  V a1 = a0, a2 = a0, a3 = a0;
+  V x0, x1, x2, x3;
+  std::size_t i_ = 0;
+  for (; i_ + 4 * L <= n_; i_ += 4 * L) {
+    load(x0, p_ + i_);
+    load(x1, p_ + i_ + L);
+    load(x2, p_ + i_ + 2 * L);
+    load(x3, p_ + i_ + 3 * L);
+    Op::apply(a0, x0);
+    Op::apply(a1, x1);
+    Op::apply(a2, x2);
+    Op::apply(a3, x3);
+  }
+  for (; i_ + L <= n_; i_ += L) {
+    load(x0, p_ + i_);
+    Op::apply(a0, x0);
+  }
+  Op::apply(a0, a1);
+  Op::apply(a2, a3);
+  Op::apply(a0, a2);
+  U r_ = U(Op::identity);
+  for (std::size_t l_ = 0; l_ < L; ++l_) {
+    Op::apply(r_, a0[l_]);
+  }
+  for (; i_ < n_; ++i_) {
+    Op::apply(r_, p_[i_]);
+  }
+  return r_;
+}
+
+template <std::size_t Bytes, typename U>
+[[gnu::always_inline]] inline U dot_kernel(U const * a_, U const * b_, std::size_t n_) noexcept {
+  using V = typename vec<U, Bytes>::type;
+  constexpr std::size_t L = vec<U, Bytes>::lanes;
+  V a0 {}, a1 {}, a2 {}, a3 {};
+  V x0, x1, x2, x3, y0, y1, y2, y3;
+  std::size_t i_ = 0;
+  for (; i_ + 4 * L <= n_; i_ += 4 * L) {
+    load(x0, a_ + i_);
+    load(x1, a_ + i_ + L);
+    load(x2, a_ + i_ + 2 * L);
+    load(x3, a_ + i_ + 3 * L);
+    load(y0, b_ + i_);
+    load(y1, b_ + i_ + L);
+    load(y2, b_ + i_ + 2 * L);
+    load(y3, b_ + i_ + 3 * L);
+    a0 += x0 * y0;
+    a1 += x1 * y1;
+    a2 += x2 * y2;
+    a3 += x3 * y3;
+  }
+  for (; i_ + L <= n_; i_ += L) {
+    load(x0, a_ + i_);
+    load(y0, b_ + i_);
+    a0 += x0 * y0;
+  }
+  a0 = (a0 + a1) + (a2 + a3);
+  U r_ {};
+  for (std::size_t l_ = 0; l_ < L; ++l_) {
+    r_ += a0[l_];
+  }
+  for (; i_ < n_; ++i_) {
+    r_ += a_[i_] * b_[i_];
+  }
+  return r_;
+}
+
+//  Portable fallback: still four accumulators, one element each.
+template <typename Op, typename U>
+inline U fold_scalar(U const * p_, std::size_t n_) noexcept {
+  U a0 = U(Op::identity), a1 = a0, a2 = a0, a3 = a0;
+  std::size_t i_ = 0;
+  for (; i_ + 4 <= n_; i_ += 4) {
+    Op::apply(a0, p_[i_]);
+    Op::apply(a1, p_[i_ + 1]);
+    Op::apply(a2, p_[i_ + 2]);
+    Op::apply(a3, p_[i_ + 3]);
+  }
+  for (; i_ < n_; ++i_) {
+    Op::apply(a0, p_[i_]);
+  }
+  Op::apply(a0, a1);
+  Op::apply(a2, a3);
+  Op::apply(a0, a2);
+  return a0;
+}
+
+template <typename U>
+inline U dot_scalar(U const * a_, U const * b_, std::size_t n_) noexcept {
+  U a0 {}, a1 {}, a2 {}, a3 {};
+  std::size_t i_ = 0;
+  for (; i_ + 4 <= n_; i_ += 4) {
+    a0 += a_[i_] * b_[i_];
+    a1 += a_[i_ + 1] * b_[i_ + 1];
+    a2 += a_[i_ + 2] * b_[i_ + 2];
+    a3 += a_[i_ + 3] * b_[i_ + 3];
+  }
+  for (; i_ < n_; ++i_) {
+    a0 += a_[i_] * b_[i_];
+  }
+  return (a0 + a1) + (a2 + a3);
+}
+
+//  One entry point per instruction set; the generic kernels are inlined into
+//  these and so compiled for the target named in the attribute.
+#if defined(CFNUM_SIMD_X86)
+template <typename Op, typename U>
+[[gnu::target("avx512f,avx512dq")]] U fold_avx512(U const * p_, std::size_t n_) noexcept {
+  return fold_kernel<64, Op>(p_, n_);
+}
+
+template <typename Op, typename U>
+[[gnu::target("avx2,fma")]] U fold_avx2(U const * p_, std::size_t n_) noexcept {
+  return fold_kernel<32, Op>(p_, n_);
+}
+
+template <typename U>
+[[gnu::target("avx512f,avx512dq")]] U dot_avx512(U const * a_, U const * b_, std::size_t n_) noexcept {
+  return dot_kernel<64>(a_, b_, n_);
+}
+
+template <typename U>
+[[gnu::target("avx2,fma")]] U dot_avx2(U const * a_, U const * b_, std::size_t n_) noexcept {
+  return dot_kernel<32>(a_, b_, n_);
+}
+#endif
+
+template <typename Op, typename T>
+inline T fold(std::span<T const> s_) noexcept {
+  using U = lane_t<T>;
+  auto const * p_ = reinterpret_cast<U const *>(s_.data());
+  std::size_t const n_ = s_.size();
+  switch (active_isa()) {
+#if defined(CFNUM_SIMD_X86)
+    case isa::avx512: return static_cast<T>(fold_avx512<Op>(p_, n_));
+    case isa::avx2:   return static_cast<T>(fold_avx2<Op>(p_, n_));
+    case isa::sse2:   return static_cast<T>(fold_kernel<16, Op>(p_, n_));
+#elif defined(CFNUM_SIMD_NEON)
+    case isa::neon:   return static_cast<T>(fold_kernel<16, Op>(p_, n_));
+#endif
+    default:          return static_cast<T>(fold_scalar<Op>(p_, n_));
+  }
+}
+
+} /* namespace detail */
+
+/*
+ *  MARK: sum(), product(), dot()
+ *
+ *  Reassociating folds over contiguous buffers: like std::reduce, the order of the
+ *  floating-point operations is unspecified.  Integer results wrap modulo 2^N.
+ *  dot() reads min(a.size(), b.size()) elements.
+ */
+template <kernel_type T>
+inline T sum(std::span<T const> s_) noexcept {
+  return detail::fold<detail::add_op>(s_);
+}
+
+template <kernel_type T>
+inline T product(std::span<T const> s_) noexcept {
+  return detail::fold<detail::mul_op>(s_);
+}
+
+template <kernel_type T>
+inline T dot(std::span<T const> a_, std::span<T const> b_) noexcept {
+  using U = detail::lane_t<T>;
+  auto const * pa = reinterpret_cast<U const *>(a_.data());
+  auto const * pb = reinterpret_cast<U const *>(b_.data());
+  std::size_t const n_ = a_.size() < b_.size() ? a_.size() : b_.size();
+  switch (active_isa()) {
+#if defined(CFNUM_SIMD_X86)
+    case isa::avx512: return static_cast<T>(detail::dot_avx512(pa, pb, n_));
+    case isa::avx2:   return static_cast<T>(detail::dot_avx2(pa, pb, n_));
+    case isa::sse2:   return static_cast<T>(detail::dot_kernel<16>(pa, pb, n_));
+#elif defined(CFNUM_SIMD_NEON)
+    case isa::neon:   return static_cast<T>(detail::dot_kernel<16>(pa, pb, n_));
+#endif
+    default:          return static_cast<T>(detail::dot_scalar(pa, pb, n_));
+  }
+}
+
+//  Allow sum(vec) etc. without spelling out std::span<const T>.
+template <typename R>
+using element_t = std::remove_cvref_t<decltype(*std::data(std::declval<R &>()))>;
+
+template <typename R>
+  requires kernel_type<element_t<R>>
+inline auto sum(R const & r_) noexcept {
+  return sum(std::span<element_t<R> const>(std::data(r_), std::size(r_)));
+}
+
+template <typename R>
+  requires kernel_type<element_t<R>>
+inline auto product(R const & r_) noexcept {
+  return product(std::span<element_t<R> const>(std::data(r_), std::size(r_)));
+}
+
+template <typename R>
+  requires kernel_type<element_t<R>>
+inline auto dot(R const & a_, R const & b_) noexcept {
+  return dot(std::span<element_t<R> const>(std::data(a_), std::size(a_)),
+             std::span<element_t<R> const>(std::data(b_), std::size(b_)));
+}
+
+} /* namespace cfnum::simd */
+
+#endif /* simd_kernels_hpp */
@@ -0,0 +1,312 @@
+//
+//  simd_scan.hpp
+//  CF.STL_Numeric
+//
+//  MARK: - References.
+//  @see: https://en.wikipedia.org/wiki/Prefix_sum (Hillis-Steele log-step scan)
+//  @see: https://gcc.gnu.org/onlinedocs/gcc/Vector-Extensions.html (__builtin_shufflevector)
+//  @see: https://en.cppreference.com/w/cpp/algorithm/adjacent_difference
+//
+
+#ifndef simd_scan_hpp
+#define simd_scan_hpp
+
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#include "simd_kernels.hpp"
+
+namespace cfnum {
+
+/*
+ *  MARK: maximum, minimum
+ *
+ *  Binary function objects for max/min scans and reductions, spelled like
+ *  std::plus<> so the scan engine can recognise them.
+ */
+struct maximum {
+  template <typename T>
+  constexpr T operator()(T const & a_, T const & b_) const { return a_ < b_ ? b_ : a_; }
+};
+
+struct minimum {
+  template <typename T>
+  constexpr T operator()(T const & a_, T const & b_) const { return b_ < a_ ? b_ : a_; }
+};
+
+namespace simd {
+
+namespace detail {
+
+struct scan_add {
+  template <typename X>
+  [[gnu::always_inline]] static void apply(X & a_, X const & b_) noexcept { a_ += b_; }
+  template <typename U>
+  static constexpr U identity() noexcept { return U(0); }
+};
+
+struct scan_max {
+  template <typename X>
+  [[gnu::always_inline]] static void apply(X & a_, X const & b_) noexcept { a_ = a_ < b_ ? b_ : a_; }
+  template <typename U>
+  static constexpr U identity() noexcept {
+    return std::numeric_limits<U>::has_infinity ? -std::numeric_limits<U>::infinity()
+                                                : std::numeric_limits<U>::lowest();
+  }
+};
+
+struct scan_min {
+  template <typename X>
+  [[gnu::always_inline]] static void apply(X & a_, X const & b_) noexcept { a_ = b_ < a_ ? b_ : a_; }
+  template <typename U>
+  static constexpr U identity() noexcept {
+    return std::numeric_limits<U>::has_infinity ? std::numeric_limits<U>::infinity()
+                                                : std::numeric_limits<U>::max();
+  }
+};
+
+//  Which kernel (if any) implements a user-facing operator.
+template <typename Op>
+struct scan_kind { using type = void; };
+template <typename T>
+struct scan_kind<std::plus<T>> { using type = scan_add; };
+template <>
+struct scan_kind<maximum> { using type = scan_max; };
+template <>
+struct scan_kind<minimum> { using type = scan_min; };
+
+struct diff_sub {
+  template <typename X>
+  [[gnu::always_inline]] static void apply(X & a_, X const & b_) noexcept { a_ -= b_; }
+};
+
+//  Which kernel implements an adjacent_difference operator: minus, or plus for
+//  the Fibonacci-style running pair sum.
+template <typename Op>
+struct diff_kind { using type = void; };
+template <typename T>
+struct diff_kind<std::minus<T>> { using type = diff_sub; };
+template <typename T>
+struct diff_kind<std::plus<T>> { using type = scan_add; };
+
+//  Sums fold in unsigned lanes so they wrap; max/min must compare signed.
+template <typename Kind, typename T>
+using scan_lane_t = std::conditional_t<std::is_same_v<Kind, scan_add>, lane_t<T>, T>;
+
+//  s = v shifted up by K lanes, the vacated low lanes taken from fill.
+template <std::size_t K, std::size_t L, typename V, std::size_t... Is>
+[[gnu::always_inline]] inline void shift_up(V & s_, V const & v_, V const & fill, std::index_sequence<Is...>) noexcept {
+  s_ = __builtin_shufflevector(v_, fill, (Is < K ? L : Is - K)...);
+}
+
+template <std::size_t L, typename V, std::size_t... Is>
+[[gnu::always_inline]] inline void broadcast_last(V & s_, V const & v_, std::index_sequence<Is...>) noexcept {
+  s_ = __builtin_shufflevector(v_, v_, ((void) Is, L - 1)...);
+}
+
+//  log2(L) shift-and-combine steps leave the in-register inclusive scan in v.
+template <std::size_t K, std::size_t L, typename Kind, typename V>
+[[gnu::always_inline]] inline void log_step(V & v_, V const & fill) noexcept {
+  if constexpr (K < L) {
+    V s_;
+    shift_up<K, L>(s_, v_, fill, std::make_index_sequence<L> {});
+    Kind::apply(v_, s_);
+    log_step<2 * K, L, Kind>(v_, fill);
+  }
+}
+
+//  Each block is scanned in-register, then combined with the running carry, which
+//  stays broadcast across a vector so the loop never goes through a scalar.
+template <std::size_t Bytes, typename Kind, typename U>
+[[gnu::always_inline]] inline U scan_kernel(U const * in, U * out, std::size_t n_, U carry) noexcept {
+  using V = typename vec<U, Bytes>::type;
+  constexpr std::size_t L = vec<U, Bytes>::lanes;
+  V const fill = V {} + Kind::template identity<U>();
+  V carry_v = V {} + carry;
+  V v_;
+  std::size_t i_ = 0;
+  for (; i_ + L <= n_; i_ += L) {
+    load(v_, in + i_);
+    log_step<1, L, Kind>(v_, fill);
+    Kind::apply(v_, carry_v);
+    std::memcpy(out + i_, &v_, sizeof(V));
+    broadcast_last<L>(carry_v, v_, std::make_index_sequence<L> {});
+  }
+  carry = carry_v[0];
+  for (; i_ < n_; ++i_) {
+    Kind::apply(carry, in[i_]);
+    out[i_] = carry;
+  }
+  return carry;
+}
+
+template <typename Kind, typename U>
+inline U scan_scalar(U const * in, U * out, std::size_t n_, U carry) noexcept {
+  for (std::size_t i_ = 0; i_ < n_; ++i_) {
+    Kind::apply(carry, in[i_]);
+    out[i_] = carry;
+  }
+  return carry;
+}
+
+//  out[i] = in[i] op in[i - 1], the previous elements taken by shifting the
+//  vector just loaded up one lane under the last one of the vector before.
+//  Nothing is read twice, so out may be in itself.
+template <std::size_t Bytes, typename Kind, typename U>
+[[gnu::always_inline]] inline U diff_kernel(U const * in, U * out, std::size_t n_, U prev) noexcept {
+  using V = typename vec<U, Bytes>::type;
+  constexpr std::size_t L = vec<U, Bytes>::lanes;
+  V fill = V {} + prev;
+  V v_;
+  V s_;
+  std::size_t i_ = 0;
+  for (; i_ + L <= n_; i_ += L) {
+    load(v_, in + i_);
+    shift_up<1, L>(s_, v_, fill, std::make_index_sequence<L> {});
+    broadcast_last<L>(fill, v_, std::make_index_sequence<L> {});
+    Kind::apply(v_, s_);
+    std::memcpy(out + i_, &v_, sizeof(V));
+  }
+  prev = fill[0];
+  for (; i_ < n_; ++i_) {
+    U d_ = in[i_];
+    U const x_ = d_;
+    Kind::apply(d_, prev);
+    prev = x_;
+    out[i_] = d_;
+  }
+  return prev;
+}
+
+template <typename Kind, typename U>
+inline U diff_scalar(U const * in, U * out, std::size_t n_, U prev) noexcept {
+  for (std::size_t i_ = 0; i_ < n_; ++i_) {
+    U d_ = in[i_];
+    U const x_ = d_;
+    Kind::apply(d_, prev);
+    prev = x_;
+    out[i_] = d_;
+  }
+  return prev;
+}
+
+#if defined(CFNUM_SIMD_X86)
+template <typename Kind, typename U>
+[[gnu::target("avx512f,avx512dq")]] U scan_avx512(U const * in, U * out, std::size_t n_, U carry) noexcept {
+  return scan_kernel<64, Kind>(in, out, n_, carry);
+}
+
+template <typename Kind, typename U>
+[[gnu::target("avx2,fma")]] U scan_avx2(U const * in, U * out, std::size_t n_, U carry) noexcept {
+  return scan_kernel<32, Kind>(in, out, n_, carry);
+}
+
+template <typename Kind, typename U>
+[[gnu::target("avx512f,avx512dq")]] U diff_avx512(U const * in, U * out, std::size_t n_, U prev) noexcept {
+  return diff_kernel<64, Kind>(in, out, n_, prev);
+}
+
+template <typename Kind, typename U>
+[[gnu::target("avx2,fma")]] U diff_avx2(U const * in, U * out, std::size_t n_, U prev) noexcept {
+  return diff_kernel<32, Kind>(in, out, n_, prev);
+}
+#endif
+
+} /* namespace detail */
+
+/*
+ *  MARK: scan_operator, exact_scan
+ *
+ *  scan_operator: Op has a vector kernel for T (std::plus, cfnum::maximum,
+ *  cfnum::minimum over the kernel_type element types).
+ *  exact_scan: additionally gives results identical to a serial left fold, which
+ *  holds for every max/min and for integer sums.  Floating-point sums reassociate
+ *  inside each vector, so the scan engine only uses them when asked to.
+ */
+template <typename Op, typename T>
+concept scan_operator = kernel_type<T>
+  && (std::same_as<Op, std::plus<>> || std::same_as<Op, std::plus<T>>
+      || std::same_as<Op, maximum> || std::same_as<Op, minimum>);
+
+template <typename Op, typename T>
+concept exact_scan = scan_operator<Op, T>
+  && (std::is_integral_v<T> || !std::is_same_v<typename detail::scan_kind<Op>::type, detail::scan_add>);
+
+template <typename Op, typename T>
+  requires scan_operator<Op, T>
+constexpr T scan_identity() noexcept {
+  return detail::scan_kind<Op>::type::template identity<T>();
+}
+
+/*
+ *  MARK: inclusive_scan()
+ *
+ *  out[i] = carry op in[0] op ... op in[i]; returns the last value written (the
+ *  carry for the next block).  out may alias in.  out.size() must be >= in.size().
+ */
+template <kernel_type T, typename Op = std::plus<>>
+  requires scan_operator<Op, T>
+inline T inclusive_scan(std::span<T const> in, std::span<T> out, Op = {},
+                        T carry = scan_identity<Op, T>()) noexcept {
+  using Kind = typename detail::scan_kind<Op>::type;
+  using U = detail::scan_lane_t<Kind, T>;
+  auto const * pi = reinterpret_cast<U const *>(in.data());
+  auto * po = reinterpret_cast<U *>(out.data());
+  auto const c_ = static_cast<U>(carry);
+  switch (active_isa()) {
+#if defined(CFNUM_SIMD_X86)
+    case isa::avx512: return static_cast<T>(detail::scan_avx512<Kind>(pi, po, in.size(), c_));
+    case isa::avx2:   return static_cast<T>(detail::scan_avx2<Kind>(pi, po, in.size(), c_));
+    case isa::sse2:   return static_cast<T>(detail::scan_kernel<16, Kind>(pi, po, in.size(), c_));
+#elif defined(CFNUM_SIMD_NEON)
+    case isa::neon:   return static_cast<T>(detail::scan_kernel<16, Kind>(pi, po, in.size(), c_));
+#endif
+    default:          return static_cast<T>(detail::scan_scalar<Kind>(pi, po, in.size(), c_));
+  }
+}
+
+/*
+ *  MARK: difference_operator, adjacent_difference()
+ *
+ *  out[i] = in[i] op in[i - 1], with prev standing in for in[-1]; returns the
+ *  last element of in (the prev for the next block).  The default prev of zero
+ *  gives std::adjacent_difference, out[0] = in[0].  With std::minus this is
+ *  delta encoding, undone by inclusive_scan with the same carry; integers wrap.
+ *  out may be in itself but must not otherwise overlap it.
+ */
+template <typename Op, typename T>
+concept difference_operator = kernel_type<T>
+  && (std::same_as<Op, std::minus<>> || std::same_as<Op, std::minus<T>>
+      || std::same_as<Op, std::plus<>> || std::same_as<Op, std::plus<T>>);
+
+template <kernel_type T, typename Op = std::minus<>>
+  requires difference_operator<Op, T>
+inline T adjacent_difference(std::span<T const> in, std::span<T> out, Op = {}, T prev = T {}) noexcept {
+  using Kind = typename detail::diff_kind<Op>::type;
+  using U = detail::lane_t<T>;
+  auto const * pi = reinterpret_cast<U const *>(in.data());
+  auto * po = reinterpret_cast<U *>(out.data());
+  auto const p_ = static_cast<U>(prev);
+  switch (active_isa()) {
+#if defined(CFNUM_SIMD_X86)
+    case isa::avx512: return static_cast<T>(detail::diff_avx512<Kind>(pi, po, in.size(), p_));
+    case isa::avx2:   return static_cast<T>(detail::diff_avx2<Kind>(pi, po, in.size(), p_));
+    case isa::sse2:   return static_cast<T>(detail::diff_kernel<16, Kind>(pi, po, in.size(), p_));
+#elif defined(CFNUM_SIMD_NEON)
+    case isa::neon:   return static_cast<T>(detail::diff_kernel<16, Kind>(pi, po, in.size(), p_));
+#endif
+    default:          return static_cast<T>(detail::diff_scalar<Kind>(pi, po, in.size(), p_));
+  }
+}
+
+} /* namespace simd */
+
+} /* namespace cfnum */
+
+#endif /* simd_scan_hpp */
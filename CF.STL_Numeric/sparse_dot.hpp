@@ -0,0 +1,655 @@
+//
+//  sparse_dot.hpp
+//  CF.STL_Numeric
+//
+//  MARK: - References.
+//  @see: https://en.wikipedia.org/wiki/Sparse_matrix#Compressed_sparse_row_(CSR,_CRS_or_Yale_format)
+//  @see: https://www.intel.com/content/www/us/en/docs/intrinsics-guide/ (vgatherdpd, vpgatherdd)
+//  @see: Bentley & Yao, "An almost optimal algorithm for unbounded searching" (1976)
+//
+
+#ifndef sparse_dot_hpp
+#define sparse_dot_hpp
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "thread_pool.hpp"
+#include "parallel_reduce.hpp"
+#include "simd_kernels.hpp"
+
+namespace cfnum {
+
+/*
+ *  MARK: sparse_span, strided_span, csr_view
+ *
+ *  Non-owning views.  A sparse_span is the nonzeros of a vector, strictly
+ *  increasing indices and their values in two parallel arrays.  A strided_span
+ *  is size elements stride apart: a column of a row-major matrix, every k-th
+ *  sample, a reversed array for stride -1.  A csr_view is a matrix in compressed
+ *  sparse rows, row r being entries [row_ptr[r], row_ptr[r + 1]) of col and
+ *  value.
+ */
+template <simd::kernel_type T>
+struct sparse_span {
+  std::span<std::uint32_t const> index;
+  std::span<T const> value;
+
+  std::size_t nonzeros() const noexcept { return index.size(); }
+
+  sparse_span subspan(std::size_t offset, std::size_t count) const noexcept {
+    return { index.subspan(offset, count), value.subspan(offset, count) };
+  }
+};
+
+template <simd::kernel_type T>
+struct strided_span {
+  T const * data;
+  std::size_t size;
+  std::ptrdiff_t stride;
+
+  T const & operator[](std::size_t i_) const noexcept {
+    return data[static_cast<std::ptrdiff_t>(i_) * stride];
+  }
+
+  strided_span subspan(std::size_t offset, std::size_t count) const noexcept {
+    return { data + static_cast<std::ptrdiff_t>(offset) * stride, count, stride };
+  }
+};
+
+template <simd::kernel_type T>
+struct csr_view {
+  std::size_t cols;
+  std::span<std::size_t const> row_ptr;
+  std::span<std::uint32_t const> col;
+  std::span<T const> value;
+
+  std::size_t rows() const noexcept { return row_ptr.empty() ? 0 : row_ptr.size() - 1; }
+
+  sparse_span<T> row(std::size_t r_) const noexcept {
+    return { col.subspan(row_ptr[r_], row_ptr[r_ + 1] - row_ptr[r_]),
+             value.subspan(row_ptr[r_], row_ptr[r_ + 1] - row_ptr[r_]) };
+  }
+};
+
+//  Sparse-sparse products switch from a merge to galloping once one side has
+//  this many times the nonzeros of the other.
+inline constexpr std::size_t gallop_ratio = 16;
+
+namespace detail {
+
+//  Gather indices are signed 32-bit lanes: dense sides of more elements than
+//  this, and strides whose L - 1 multiple does not fit, take the scalar loops.
+inline constexpr std::size_t gather_limit = std::size_t(1) << 31;
+
+inline bool gatherable(std::ptrdiff_t stride) noexcept {
+  return static_cast<std::size_t>(stride < 0 ? -stride : stride) < gather_limit / 16;
+}
+
+#if defined(CFNUM_SIMD_X86)
+//  g[l] = base[j[l]] for the L lanes of V, j holding L signed 32-bit indices.
+//  Only ever inlined into the avx2 and avx512 entry points, so the builtins'
+//  vector returns never cross an ABI boundary; -Wpsabi cannot see that.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+template <std::size_t Bytes, typename V, typename J, typename U>
+[[gnu::always_inline]] inline void gather(V & g_, U const * base, J const & j_) noexcept {
+  if constexpr (Bytes == 64) {
+    if constexpr (std::is_same_v<U, double>) {
+      g_ = __builtin_ia32_gathersiv8df(V {}, base, j_, 0xFF, 8);
+    }
+    else if constexpr (std::is_same_v<U, float>) {
+      g_ = __builtin_ia32_gathersiv16sf(V {}, base, j_, 0xFFFF, 4);
+    }
+    else if constexpr (sizeof(U) == 4) {
+      g_ = V(__builtin_ia32_gathersiv16si(J {}, base, j_, 0xFFFF, 4));
+    }
+    else {
+      using Q = typename simd::detail::vec<long long, 64>::type;
+      g_ = V(__builtin_ia32_gathersiv8di(Q {}, base, j_, 0xFF, 8));
+    }
+  }
+  else {
+    //  The AVX2 forms take the lane mask as a vector, all bits set to load.
+    if constexpr (std::is_same_v<U, double>) {
+      using Q = typename simd::detail::vec<long long, 32>::type;
+      g_ = __builtin_ia32_gathersiv4df(V {}, base, j_, V(Q {} - 1), 8);
+    }
+    else if constexpr (std::is_same_v<U, float>) {
+      g_ = __builtin_ia32_gathersiv8sf(V {}, base, j_, V(J {} - 1), 4);
+    }
+    else if constexpr (sizeof(U) == 4) {
+      g_ = V(__builtin_ia32_gathersiv8si(J {}, reinterpret_cast<int const *>(base), j_, J {} - 1, 4));
+    }
+    else {
+      using Q = typename simd::detail::vec<long long, 32>::type;
+      g_ = V(__builtin_ia32_gathersiv4di(Q {}, reinterpret_cast<long long const *>(base), j_, Q {} - 1, 8));
+    }
+  }
+}
+#pragma GCC diagnostic pop
+
+//  sum v[k] x[i[k]]: indices and values loaded, the dense side gathered, four
+//  vectors in flight as in dot_kernel.
+template <std::size_t Bytes, typename U>
+[[gnu::always_inline]] inline U gather_dot_kernel(U const * v_, std::uint32_t const * i_, U const * x_,
+                                                  std::size_t n_) noexcept {
+  using V = typename simd::detail::vec<U, Bytes>::type;
+  constexpr std::size_t L = simd::detail::vec<U, Bytes>::lanes;
+  using J = typename simd::detail::vec<std::int32_t, L * 4>::type;
+  V a0 {}, a1 {}, a2 {}, a3 {};
+  V y0, y1, y2, y3, g0, g1, g2, g3;
+  J j0, j1, j2, j3;
+  std::size_t k_ = 0;
+  for (; k_ + 4 * L <= n_; k_ += 4 * L) {
+    simd::detail::load(j0, i_ + k_);
+    simd::detail::load(j1, i_ + k_ + L);
+    simd::detail::load(j2, i_ + k_ + 2 * L);
+    simd::detail::load(j3, i_ + k_ + 3 * L);
+    gather<Bytes>(g0, x_, j0);
+    gather<Bytes>(g1, x_, j1);
+    gather<Bytes>(g2, x_, j2);
+    gather<Bytes>(g3, x_, j3);
+    simd::detail::load(y0, v_ + k_);
+    simd::detail::load(y1, v_ + k_ + L);
+    simd::detail::load(y2, v_ + k_ + 2 * L);
+    simd::detail::load(y3, v_ + k_ + 3 * L);
+    a0 += y0 * g0;
+    a1 += y1 * g1;
+    a2 += y2 * g2;
+    a3 += y3 * g3;
+  }
+  for (; k_ + L <= n_; k_ += L) {
+    simd::detail::load(j0, i_ + k_);
+    gather<Bytes>(g0, x_, j0);
+    simd::detail::load(y0, v_ + k_);
+    a0 += y0 * g0;
+  }
+  a0 = (a0 + a1) + (a2 + a3);
+  U r_ {};
+  for (std::size_t l_ = 0; l_ < L; ++l_) {
+    r_ += a0[l_];
+  }
+  for (; k_ < n_; ++k_) {
+    r_ += v_[k_] * x_[i_[k_]];
+  }
+  return r_;
+}
+
+//  L elements stride apart from p, the stride's multiples in j; loaded directly
+//  when Unit says the stride is 1.
+template <std::size_t Bytes, bool Unit, typename V, typename J, typename U>
+[[gnu::always_inline]] inline void gather_strided(V & g_, U const * p_, J const & j_) noexcept {
+  if constexpr (Unit) {
+    simd::detail::load(g_, p_);
+  }
+  else {
+    gather<Bytes>(g_, p_, j_);
+  }
+}
+
+//  sum a[i sa] b[i sb], a gathered through the index vector (0, sa, 2 sa, ...)
+//  moved along by L sa per vector; b too unless Unit, when it is loaded.
+template <std::size_t Bytes, bool Unit, typename U>
+[[gnu::always_inline]] inline U strided_dot_kernel(U const * a_, std::ptrdiff_t sa, U const * b_, std::ptrdiff_t sb,
+                                                   std::size_t n_) noexcept {
+  using V = typename simd::detail::vec<U, Bytes>::type;
+  constexpr std::size_t L = simd::detail::vec<U, Bytes>::lanes;
+  using J = typename simd::detail::vec<std::int32_t, L * 4>::type;
+  J ja, jb;
+  for (std::size_t l_ = 0; l_ < L; ++l_) {
+    ja[l_] = static_cast<std::int32_t>(static_cast<std::ptrdiff_t>(l_) * sa);
+    jb[l_] = static_cast<std::int32_t>(static_cast<std::ptrdiff_t>(l_) * sb);
+  }
+  std::ptrdiff_t const da = static_cast<std::ptrdiff_t>(L) * sa;
+  std::ptrdiff_t const db = static_cast<std::ptrdiff_t>(L) * sb;
+  V a0 {}, a1 {}, a2 {}, a3 {};
+  V x0, x1, x2, x3, y0, y1, y2, y3;
+  std::size_t i_ = 0;
+  for (; i_ + 4 * L <= n_; i_ += 4 * L) {
+    U const * pa = a_ + static_cast<std::ptrdiff_t>(i_) * sa;
+    U const * pb = b_ + static_cast<std::ptrdiff_t>(i_) * sb;
+    gather<Bytes>(x0, pa, ja);
+    gather<Bytes>(x1, pa + da, ja);
+    gather<Bytes>(x2, pa + 2 * da, ja);
+    gather<Bytes>(x3, pa + 3 * da, ja);
+    gather_strided<Bytes, Unit>(y0, pb, jb);
+    gather_strided<Bytes, Unit>(y1, pb + db, jb);
+    gather_strided<Bytes, Unit>(y2, pb + 2 * db, jb);
+    gather_strided<Bytes, Unit>(y3, pb + 3 * db, jb);
+    a0 += x0 * y0;
+    a1 += x1 * y1;
+    a2 += x2 * y2;
+    a3 += x3 * y3;
+  }
+  for (; i_ + L <= n_; i_ += L) {
+    gather<Bytes>(x0, a_ + static_cast<std::ptrdiff_t>(i_) * sa, ja);
+    gather_strided<Bytes, Unit>(y0, b_ + static_cast<std::ptrdiff_t>(i_) * sb, jb);
+    a0 += x0 * y0;
+  }
+  a0 = (a0 + a1) + (a2 + a3);
+  U r_ {};
+  for (std::size_t l_ = 0; l_ < L; ++l_) {
+    r_ += a0[l_];
+  }
+  for (; i_ < n_; ++i_) {
+    r_ += a_[static_cast<std::ptrdiff_t>(i_) * sa] * b_[static_cast<std::ptrdiff_t>(i_) * sb];
+  }
+  return r_;
+}
+#endif
+
+template <typename U>
+inline U gather_dot_scalar(U const * v_, std::uint32_t const * i_, U const * x_, std::size_t n_) noexcept {
+  U a0 {}, a1 {}, a2 {}, a3 {};
+  std::size_t k_ = 0;
+  for (; k_ + 4 <= n_; k_ += 4) {
+    a0 += v_[k_] * x_[i_[k_]];
+    a1 += v_[k_ + 1] * x_[i_[k_ + 1]];
+    a2 += v_[k_ + 2] * x_[i_[k_ + 2]];
+    a3 += v_[k_ + 3] * x_[i_[k_ + 3]];
+  }
+  for (; k_ < n_; ++k_) {
+    a0 += v_[k_] * x_[i_[k_]];
+  }
+  return (a0 + a1) + (a2 + a3);
+}
+
+template <typename U>
+inline U strided_dot_scalar(U const * a_, std::ptrdiff_t sa, U const * b_, std::ptrdiff_t sb,
+                            std::size_t n_) noexcept {
+  U a0 {}, a1 {}, a2 {}, a3 {};
+  std::ptrdiff_t const n4 = static_cast<std::ptrdiff_t>(n_ / 4 * 4);
+  std::ptrdiff_t i_ = 0;
+  for (; i_ < n4; i_ += 4) {
+    a0 += a_[i_ * sa] * b_[i_ * sb];
+    a1 += a_[(i_ + 1) * sa] * b_[(i_ + 1) * sb];
+    a2 += a_[(i_ + 2) * sa] * b_[(i_ + 2) * sb];
+    a3 += a_[(i_ + 3) * sa] * b_[(i_ + 3) * sb];
+  }
+  for (; i_ < static_cast<std::ptrdiff_t>(n_); ++i_) {
+    a0 += a_[i_ * sa] * b_[i_ * sb];
+  }
+  return (a0 + a1) + (a2 + a3);
+}
+
+//  Rows [r0, r1) of a csr matrix times x, one isa switch for the whole range
+//  rather than one per row.
+template <std::size_t Bytes, typename U>
+[[gnu::always_inline]] inline void csr_rows_kernel(std::size_t const * row_ptr, std::uint32_t const * col,
+                                                   U const * value, U const * x_, U * y_,
+                                                   std::size_t r0, std::size_t r1) noexcept {
+  for (std::size_t r_ = r0; r_ < r1; ++r_) {
+    std::size_t const k_ = row_ptr[r_];
+    std::size_t const n_ = row_ptr[r_ + 1] - k_;
+    if constexpr (Bytes == 0) {
+      y_[r_] = gather_dot_scalar(value + k_, col + k_, x_, n_);
+    }
+#if defined(CFNUM_SIMD_X86)
+    else {
+      y_[r_] = gather_dot_kernel<Bytes>(value + k_, col + k_, x_, n_);
+    }
+#endif
+  }
+}
+
+#if defined(CFNUM_SIMD_X86)
+template <typename U>
+[[gnu::target("avx512f,avx512dq")]] U gather_dot_avx512(U const * v_, std::uint32_t const * i_, U const * x_,
+                                                        std::size_t n_) noexcept {
+  return gather_dot_kernel<64>(v_, i_, x_, n_);
+}
+
+template <typename U>
+[[gnu::target("avx2,fma")]] U gather_dot_avx2(U const * v_, std::uint32_t const * i_, U const * x_,
+                                              std::size_t n_) noexcept {
+  return gather_dot_kernel<32>(v_, i_, x_, n_);
+}
+
+template <bool Unit, typename U>
+[[gnu::target("avx512f,avx512dq")]] U strided_dot_avx512(U const * a_, std::ptrdiff_t sa, U const * b_,
+                                                         std::ptrdiff_t sb, std::size_t n_) noexcept {
+  return strided_dot_kernel<64, Unit>(a_, sa, b_, sb, n_);
+}
+
+template <bool Unit, typename U>
+[[gnu::target("avx2,fma")]] U strided_dot_avx2(U const * a_, std::ptrdiff_t sa, U const * b_,
+                                               std::ptrdiff_t sb, std::size_t n_) noexcept {
+  return strided_dot_kernel<32, Unit>(a_, sa, b_, sb, n_);
+}
+
+template <typename U>
+[[gnu::target("avx512f,avx512dq")]] void csr_rows_avx512(std::size_t const * row_ptr, std::uint32_t const * col,
+                                                         U const * value, U const * x_, U * y_,
+                                                         std::size_t r0, std::size_t r1) noexcept {
+  csr_rows_kernel<64>(row_ptr, col, value, x_, y_, r0, r1);
+}
+
+template <typename U>
+[[gnu::target("avx2,fma")]] void csr_rows_avx2(std::size_t const * row_ptr, std::uint32_t const * col,
+                                               U const * value, U const * x_, U * y_,
+                                               std::size_t r0, std::size_t r1) noexcept {
+  csr_rows_kernel<32>(row_ptr, col, value, x_, y_, r0, r1);
+}
+#endif
+
+//  Gathers only pay on AVX2 and AVX-512; SSE2 and NEON have none and take the
+//  scalar loop, as does a dense side too long for 32-bit gather indices.
+template <simd::kernel_type T>
+inline T gather_dot(sparse_span<T> a_, std::span<T const> x_) noexcept {
+  using U = simd::detail::lane_t<T>;
+  auto const * v_ = reinterpret_cast<U const *>(a_.value.data());
+  auto const * p_ = reinterpret_cast<U const *>(x_.data());
+  std::uint32_t const * i_ = a_.index.data();
+  std::size_t const n_ = a_.nonzeros();
+  switch (x_.size() <= gather_limit ? simd::active_isa() : simd::isa::scalar) {
+#if defined(CFNUM_SIMD_X86)
+    case simd::isa::avx512: return static_cast<T>(gather_dot_avx512(v_, i_, p_, n_));
+    case simd::isa::avx2:   return static_cast<T>(gather_dot_avx2(v_, i_, p_, n_));
+#endif
+    default:                return static_cast<T>(gather_dot_scalar(v_, i_, p_, n_));
+  }
+}
+
+template <simd::kernel_type T>
+inline T strided_dot(strided_span<T> a_, strided_span<T> b_) noexcept {
+  using U = simd::detail::lane_t<T>;
+  std::size_t const n_ = std::min(a_.size, b_.size);
+  if (a_.stride == 1 && b_.stride == 1) {
+    return simd::dot(std::span<T const>(a_.data, n_), std::span<T const>(b_.data, n_));
+  }
+  //  The unit-stride side, if any, is the one loaded.
+  if (a_.stride == 1) {
+    std::swap(a_, b_);
+  }
+  auto const * pa = reinterpret_cast<U const *>(a_.data);
+  auto const * pb = reinterpret_cast<U const *>(b_.data);
+  bool const gather_ = gatherable(a_.stride) && gatherable(b_.stride);
+  switch (gather_ ? simd::active_isa() : simd::isa::scalar) {
+#if defined(CFNUM_SIMD_X86)
+    case simd::isa::avx512:
+      return static_cast<T>(b_.stride == 1 ? strided_dot_avx512<true>(pa, a_.stride, pb, b_.stride, n_)
+                                           : strided_dot_avx512<false>(pa, a_.stride, pb, b_.stride, n_));
+    case simd::isa::avx2:
+      return static_cast<T>(b_.stride == 1 ? strided_dot_avx2<true>(pa, a_.stride, pb, b_.stride, n_)
+                                           : strided_dot_avx2<false>(pa, a_.stride, pb, b_.stride, n_));
+#endif
+    default:
+      return static_cast<T>(strided_dot_scalar(pa, a_.stride, pb, b_.stride, n_));
+  }
+}
+
+template <simd::kernel_type T>
+inline void csr_rows(csr_view<T> const & m_, std::span<T const> x_, std::span<T> y_,
+                     std::size_t r0, std::size_t r1) noexcept {
+  using U = simd::detail::lane_t<T>;
+  auto const * value = reinterpret_cast<U const *>(m_.value.data());
+  auto const * p_ = reinterpret_cast<U const *>(x_.data());
+  auto * out = reinterpret_cast<U *>(y_.data());
+  switch (m_.cols <= gather_limit ? simd::active_isa() : simd::isa::scalar) {
+#if defined(CFNUM_SIMD_X86)
+    case simd::isa::avx512: csr_rows_avx512(m_.row_ptr.data(), m_.col.data(), value, p_, out, r0, r1); break;
+    case simd::isa::avx2:   csr_rows_avx2(m_.row_ptr.data(), m_.col.data(), value, p_, out, r0, r1); break;
+#endif
+    default:                csr_rows_kernel<0>(m_.row_ptr.data(), m_.col.data(), value, p_, out, r0, r1); break;
+  }
+}
+
+//  p when k, else zero, by masking its bits: a conditional expression on a
+//  floating-point p compiles to a branch, which mispredicts on every
+//  irregular match.
+template <typename U>
+[[gnu::always_inline]] inline U keep_if(bool k_, U p_) noexcept {
+  using B = std::conditional_t<sizeof(U) == 8, std::uint64_t, std::uint32_t>;
+  return std::bit_cast<U>(static_cast<B>(std::bit_cast<B>(p_) & (B(0) - B(k_))));
+}
+
+//  Both index lists walked together; a pair is multiplied on every step and
+//  kept only when the indices match, so the loop has no data-dependent branch
+//  to mispredict at any density.
+template <typename U>
+inline U merge_dot(std::uint32_t const * ia, U const * va, std::size_t na,
+                   std::uint32_t const * ib, U const * vb, std::size_t nb) noexcept {
+  U r_ {};
+  std::size_t i_ = 0;
+  std::size_t j_ = 0;
+  while (i_ < na && j_ < nb) {
+    std::uint32_t const x_ = ia[i_];
+    std::uint32_t const y_ = ib[j_];
+    U const p_ = va[i_] * vb[j_];
+    r_ += keep_if(x_ == y_, p_);
+    i_ += x_ <= y_;
+    j_ += y_ <= x_;
+  }
+  return r_;
+}
+
+//  Each index of the short side looked up in the long one from where the last
+//  lookup ended: steps of 1, 2, 4, ... then a binary search inside the last
+//  step, O(m log(n / m)) against the merge's O(m + n).  The products are taken
+//  in the same order, so the result equals merge_dot's exactly.
+template <typename U>
+inline U gallop_dot(std::uint32_t const * ia, U const * va, std::size_t na,
+                    std::uint32_t const * ib, U const * vb, std::size_t nb) noexcept {
+  U r_ {};
+  std::size_t j_ = 0;
+  for (std::size_t i_ = 0; i_ < na; ++i_) {
+    std::uint32_t const x_ = ia[i_];
+    std::size_t d_ = 1;
+    while (j_ + d_ <= nb && ib[j_ + d_ - 1] < x_) {
+      j_ += d_;
+      d_ *= 2;
+    }
+    j_ = static_cast<std::size_t>(std::lower_bound(ib + j_, ib + std::min(j_ + d_, nb), x_) - ib);
+    if (j_ == nb) {
+      break;
+    }
+    if (ib[j_] == x_) {
+      r_ += va[i_] * vb[j_];
+    }
+  }
+  return r_;
+}
+
+template <simd::kernel_type T>
+inline T sparse_sparse_dot(sparse_span<T> a_, sparse_span<T> b_) noexcept {
+  using U = simd::detail::lane_t<T>;
+  std::size_t const na = a_.nonzeros();
+  std::size_t const nb = b_.nonzeros();
+  auto const * va = reinterpret_cast<U const *>(a_.value.data());
+  auto const * vb = reinterpret_cast<U const *>(b_.value.data());
+  if (nb / gallop_ratio >= na) {
+    return static_cast<T>(gallop_dot(a_.index.data(), va, na, b_.index.data(), vb, nb));
+  }
+  if (na / gallop_ratio >= nb) {
+    return static_cast<T>(gallop_dot(b_.index.data(), vb, nb, a_.index.data(), va, na));
+  }
+  return static_cast<T>(merge_dot(a_.index.data(), va, na, b_.index.data(), vb, nb));
+}
+
+} /* namespace detail */
+
+/*
+ *  MARK: sparse_dot()
+ *
+ *  Inner products with a sparse side.  Against a dense vector the values are
+ *  multiplied by x gathered at their indices, a vector of them per instruction
+ *  on AVX2 and AVX-512.  Against another sparse vector only the indices both
+ *  share contribute: the two lists are merged, or the shorter one is galloped
+ *  through the longer when their sizes differ by gallop_ratio or more.  Every
+ *  index must be smaller than the dense side's size.  Like simd::dot, the order
+ *  of floating-point additions is unspecified and integers wrap.
+ */
+template <simd::kernel_type T>
+T sparse_dot(sparse_span<T> a_, std::type_identity_t<std::span<T const>> x_) noexcept {
+  return detail::gather_dot(a_, x_);
+}
+
+template <simd::kernel_type T>
+T sparse_dot(sparse_span<T> a_, sparse_span<T> b_) noexcept {
+  return detail::sparse_sparse_dot(a_, b_);
+}
+
+/*
+ *  MARK: strided_dot()
+ *
+ *  sum a[i] b[i] over min(a.size, b.size) elements of two strided spans:
+ *  simd::dot when both are contiguous, otherwise gathers of L elements
+ *  stride apart, with the contiguous side, if any, loaded directly.
+ */
+template <simd::kernel_type T>
+T strided_dot(strided_span<T> a_, strided_span<T> b_) noexcept {
+  return detail::strided_dot(a_, b_);
+}
+
+/*
+ *  MARK: csr_multiply()
+ *
+ *  y = M x for a csr matrix: every row a sparse_dot against x.  y must have
+ *  m.rows() elements and x m.cols.
+ */
+template <simd::kernel_type T>
+void csr_multiply(csr_view<T> const & m_, std::type_identity_t<std::span<T const>> x_,
+                  std::type_identity_t<std::span<T>> y_) noexcept {
+  detail::csr_rows(m_, x_, y_, 0, m_.rows());
+}
+
+/*
+ *  MARK: parallel_sparse_dot(), parallel_strided_dot(), parallel_csr_multiply()
+ *
+ *  The same products split across the pool.  A sparse-dense product is split
+ *  by nonzeros; a sparse-sparse one splits the side with more nonzeros by
+ *  position and each chunk takes the part of the other side between its first
+ *  index and the next chunk's; a csr product splits its rows so that every
+ *  chunk has about the same number of nonzeros, however uneven the rows are.
+ */
+template <simd::kernel_type T>
+T parallel_sparse_dot(thread_pool & pool, sparse_span<T> a_, std::type_identity_t<std::span<T const>> x_,
+                      std::size_t grain = reduce_grain) {
+  std::size_t const n_ = a_.nonzeros();
+  std::size_t const chunks = detail::chunk_count(n_, pool.size(), grain);
+  if (chunks == 1) {
+    return detail::gather_dot(a_, x_);
+  }
+  std::vector<detail::padded<T>> partial(chunks);
+  pool.parallel_for(chunks, [&](std::size_t c_) {
+    std::size_t const lo = n_ * c_ / chunks;
+    std::size_t const hi = n_ * (c_ + 1) / chunks;
+    partial[c_].value = detail::gather_dot(a_.subspan(lo, hi - lo), x_);
+  });
+  T result {};
+  for (auto const & p_ : partial) {
+    result += p_.value;
+  }
+  return result;
+}
+
+template <simd::kernel_type T>
+T parallel_sparse_dot(thread_pool & pool, sparse_span<T> a_, sparse_span<T> b_,
+                      std::size_t grain = reduce_grain) {
+  if (a_.nonzeros() < b_.nonzeros()) {
+    std::swap(a_, b_);
+  }
+  std::size_t const n_ = a_.nonzeros();
+  std::size_t const chunks = detail::chunk_count(n_, pool.size(), grain);
+  if (chunks == 1) {
+    return detail::sparse_sparse_dot(a_, b_);
+  }
+  //  b's split points: the first of its indices not below each chunk's first.
+  std::vector<std::size_t> split(chunks + 1);
+  for (std::size_t c_ = 1; c_ < chunks; ++c_) {
+    std::uint32_t const first = a_.index[n_ * c_ / chunks];
+    split[c_] = static_cast<std::size_t>(std::lower_bound(b_.index.begin(), b_.index.end(), first)
+                                         - b_.index.begin());
+  }
+  split[chunks] = b_.nonzeros();
+  std::vector<detail::padded<T>> partial(chunks);
+  pool.parallel_for(chunks, [&](std::size_t c_) {
+    std::size_t const lo = n_ * c_ / chunks;
+    std::size_t const hi = n_ * (c_ + 1) / chunks;
+    partial[c_].value = detail::sparse_sparse_dot(a_.subspan(lo, hi - lo),
+                                                  b_.subspan(split[c_], split[c_ + 1] - split[c_]));
+  });
+  T result {};
+  for (auto const & p_ : partial) {
+    result += p_.value;
+  }
+  return result;
+}
+
+template <simd::kernel_type T>
+T parallel_strided_dot(thread_pool & pool, strided_span<T> a_, strided_span<T> b_,
+                       std::size_t grain = reduce_grain) {
+  std::size_t const n_ = std::min(a_.size, b_.size);
+  std::size_t const chunks = detail::chunk_count(n_, pool.size(), grain);
+  if (chunks == 1) {
+    return detail::strided_dot(a_, b_);
+  }
+  std::vector<detail::padded<T>> partial(chunks);
+  pool.parallel_for(chunks, [&](std::size_t c_) {
+    std::size_t const lo = n_ * c_ / chunks;
+    std::size_t const hi = n_ * (c_ + 1) / chunks;
+    partial[c_].value = detail::strided_dot(a_.subspan(lo, hi - lo), b_.subspan(lo, hi - lo));
+  });
+  T result {};
+  for (auto const & p_ : partial) {
+    result += p_.value;
+  }
+  return result;
+}
+
+template <simd::kernel_type T>
+void parallel_csr_multiply(thread_pool & pool, csr_view<T> const & m_, std::type_identity_t<std::span<T const>> x_,
+                           std::type_identity_t<std::span<T>> y_, std::size_t grain = reduce_grain) {
+  std::size_t const rows = m_.rows();
+  std::size_t const nnz = rows == 0 ? 0 : m_.row_ptr[rows] - m_.row_ptr[0];
+  std::size_t const chunks = detail::chunk_count(nnz + rows, pool.size(), grain);
+  if (chunks == 1) {
+    detail::csr_rows(m_, x_, y_, 0, rows);
+    return;
+  }
+  //  First row of each chunk: the one holding its share's first nonzero.
+  auto row_at = [&](std::size_t c_) {
+    if (c_ == chunks) {
+      return rows;
+    }
+    std::size_t const k_ = m_.row_ptr[0] + nnz * c_ / chunks;
+    return static_cast<std::size_t>(std::upper_bound(m_.row_ptr.begin(), m_.row_ptr.begin() + rows, k_)
+                                    - m_.row_ptr.begin()) - 1;
+  };
+  pool.parallel_for(chunks, [&](std::size_t c_) {
+    detail::csr_rows(m_, x_, y_, c_ == 0 ? 0 : row_at(c_), row_at(c_ + 1));
+  });
+}
+
+//  Convenience overloads running on default_pool().
+template <simd::kernel_type T>
+T parallel_sparse_dot(sparse_span<T> a_, std::type_identity_t<std::span<T const>> x_) {
+  return parallel_sparse_dot(default_pool(), a_, x_);
+}
+
+template <simd::kernel_type T>
+T parallel_sparse_dot(sparse_span<T> a_, sparse_span<T> b_) {
+  return parallel_sparse_dot(default_pool(), a_, b_);
+}
+
+template <simd::kernel_type T>
+T parallel_strided_dot(strided_span<T> a_, strided_span<T> b_) {
+  return parallel_strided_dot(default_pool(), a_, b_);
+}
+
+template <simd::kernel_type T>
+void parallel_csr_multiply(csr_view<T> const & m_, std::type_identity_t<std::span<T const>> x_,
+                           std::type_identity_t<std::span<T>> y_) {
+  parallel_csr_multiply(default_pool(), m_, x_, y_);
+}
+
+} /* namespace cfnum */
+
+#endif /* sparse_dot_hpp */
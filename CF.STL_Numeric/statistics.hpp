@@ -0,0 +1,318 @@
+//
+//  statistics.hpp
+//  CF.STL_Numeric
+//
+//  MARK: - References.
+//  @see: Welford, "Note on a Method for Calculating Corrected Sums of Squares and Products" (1962)
+//  @see: Chan, Golub & LeVeque, "Updating Formulae and a Pairwise Algorithm for Computing Sample Variances" (1979)
+//  @see: https://en.wikipedia.org/wiki/Algorithms_for_calculating_variance
+//
+
+#ifndef statistics_hpp
+#define statistics_hpp
+
+#include <algorithm>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "thread_pool.hpp"
+#include "parallel_reduce.hpp"
+#include "simd_kernels.hpp"
+
+namespace cfnum {
+
+namespace detail {
+
+//  Exact sums for integers (64 bits for up to 32-bit elements, 128 for 64-bit
+//  ones), double or wider for floating point.
+template <typename T>
+struct stats_sum { using type = std::common_type_t<T, double>; };
+
+template <std::integral T>
+struct stats_sum<T> { using type = std::conditional_t<(sizeof(T) < 8), std::int64_t, __int128>; };
+
+} /* namespace detail */
+
+/*
+ *  MARK: statistics
+ *
+ *  count, sum, mean, min, max and the sum of squared deviations m2, from which
+ *  both variances follow.  merge() is the pairwise update of Chan, Golub and
+ *  LeVeque, so partial results from blocks or threads combine without losing
+ *  the accuracy of a two-pass variance.  min and max skip NaNs; the mean of an
+ *  empty range is NaN.
+ */
+template <typename T>
+struct statistics {
+  using sum_type = typename detail::stats_sum<T>::type;
+
+  std::size_t count = 0;
+  sum_type sum {};
+  double mean = std::numeric_limits<double>::quiet_NaN();
+  double m2 = 0.0;
+  T min = std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max();
+  T max = std::numeric_limits<T>::has_infinity ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::lowest();
+
+  double variance() const noexcept { return m2 / static_cast<double>(count); }
+  double sample_variance() const noexcept { return m2 / static_cast<double>(count - 1); }
+  double stddev() const noexcept { return std::sqrt(variance()); }
+
+  //  Welford's update for one more element.
+  void push(T const & x_) noexcept {
+    double const d_ = static_cast<double>(x_);
+    ++count;
+    sum += static_cast<sum_type>(x_);
+    double const delta = count == 1 ? d_ : d_ - mean;
+    if constexpr (std::is_integral_v<T>) {
+      mean = static_cast<double>(sum) / static_cast<double>(count);
+    }
+    else {
+      mean = count == 1 ? d_ : mean + delta / static_cast<double>(count);
+    }
+    m2 += count == 1 ? 0.0 : delta * (d_ - mean);
+    min = x_ < min ? x_ : min;
+    max = max < x_ ? x_ : max;
+  }
+
+  statistics & merge(statistics const & b_) noexcept {
+    if (b_.count == 0) {
+      return *this;
+    }
+    if (count == 0) {
+      return *this = b_;
+    }
+    double const na = static_cast<double>(count);
+    double const nb = static_cast<double>(b_.count);
+    double const delta = b_.mean - mean;
+    count += b_.count;
+    sum += b_.sum;
+    //  Integer sums are exact, so the mean is rounded once rather than per merge.
+    if constexpr (std::is_integral_v<T>) {
+      mean = static_cast<double>(sum) / static_cast<double>(count);
+    }
+    else {
+      mean += delta * nb / (na + nb);
+    }
+    m2 += b_.m2 + delta * delta * na * nb / (na + nb);
+    min = b_.min < min ? b_.min : min;
+    max = max < b_.max ? b_.max : max;
+    return *this;
+  }
+};
+
+namespace detail {
+
+//  Blocks small enough to stay in L1, so the second pass over each one is free
+//  of memory traffic: the whole range is still read from memory once.
+inline constexpr std::size_t stats_block = 2'048;
+
+//  One block, two passes: sum, min and max; then the squared deviations from the
+//  block's own mean, all in double lanes.  Elements are widened lane for lane:
+//  int32 sums in int64 lanes, int64 as separate low and high 32-bit halves (exact
+//  for any block), float and int64 convert to double for the deviations.
+template <std::size_t Bytes, simd::kernel_type T>
+[[gnu::always_inline]] inline void stats_block_kernel(T const * p_, std::size_t n_, statistics<T> & r_) noexcept {
+  using D = typename simd::detail::vec<double, Bytes>::type;
+  using Q = typename simd::detail::vec<std::int64_t, Bytes>::type;
+  constexpr std::size_t L = simd::detail::vec<double, Bytes>::lanes;
+  using N = typename simd::detail::vec<T, L * sizeof(T)>::type;
+  using S = typename statistics<T>::sum_type;
+
+  N lo_ = N {} + r_.min;
+  N hi_ = N {} + r_.max;
+  D fs {};
+  Q qs {};
+  Q qh {};
+  N x_;
+  std::size_t i_ = 0;
+  for (; i_ + L <= n_; i_ += L) {
+    simd::detail::load(x_, p_ + i_);
+    lo_ = x_ < lo_ ? x_ : lo_;
+    hi_ = hi_ < x_ ? x_ : hi_;
+    if constexpr (std::is_same_v<T, std::int32_t>) {
+      qs += __builtin_convertvector(x_, Q);
+    }
+    else if constexpr (std::is_same_v<T, std::int64_t>) {
+      qs += Q(x_ & 0xFFFF'FFFF);
+      qh += Q(x_ >> 32);
+    }
+    else {
+      fs += __builtin_convertvector(x_, D);
+    }
+  }
+  T mn = r_.min;
+  T mx = r_.max;
+  S sum_ {};
+  for (std::size_t l_ = 0; l_ < L; ++l_) {
+    mn = lo_[l_] < mn ? lo_[l_] : mn;
+    mx = mx < hi_[l_] ? hi_[l_] : mx;
+    if constexpr (std::is_same_v<T, std::int64_t>) {
+      sum_ += (S(qh[l_]) << 32) + S(qs[l_]);
+    }
+    else if constexpr (std::is_integral_v<T>) {
+      sum_ += S(qs[l_]);
+    }
+    else {
+      sum_ += S(fs[l_]);
+    }
+  }
+  for (std::size_t j_ = i_; j_ < n_; ++j_) {
+    mn = p_[j_] < mn ? p_[j_] : mn;
+    mx = mx < p_[j_] ? p_[j_] : mx;
+    sum_ += S(p_[j_]);
+  }
+
+  double const mean_ = static_cast<double>(sum_) / static_cast<double>(n_);
+  D const mv = D {} + mean_;
+  D a0 {};
+  for (i_ = 0; i_ + L <= n_; i_ += L) {
+    simd::detail::load(x_, p_ + i_);
+    D const d_ = __builtin_convertvector(x_, D) - mv;
+    a0 += d_ * d_;
+  }
+  double m2_ = 0.0;
+  for (std::size_t l_ = 0; l_ < L; ++l_) {
+    m2_ += a0[l_];
+  }
+  for (; i_ < n_; ++i_) {
+    double const d_ = static_cast<double>(p_[i_]) - mean_;
+    m2_ += d_ * d_;
+  }
+
+  statistics<T> b_;
+  b_.count = n_;
+  b_.sum = sum_;
+  b_.mean = mean_;
+  b_.m2 = m2_;
+  b_.min = mn;
+  b_.max = mx;
+  r_.merge(b_);
+}
+
+template <std::size_t Bytes, simd::kernel_type T>
+[[gnu::always_inline]] inline void stats_kernel(T const * p_, std::size_t n_, statistics<T> & r_) noexcept {
+  for (std::size_t i_ = 0; i_ < n_; i_ += stats_block) {
+    stats_block_kernel<Bytes>(p_ + i_, std::min(stats_block, n_ - i_), r_);
+  }
+}
+
+//  Portable fallback: the same blocks, the deviations taken the same way.
+template <simd::kernel_type T>
+inline void stats_scalar(T const * p_, std::size_t n_, statistics<T> & r_) noexcept {
+  using S = typename statistics<T>::sum_type;
+  for (std::size_t i_ = 0; i_ < n_; i_ += stats_block) {
+    std::size_t const m_ = std::min(stats_block, n_ - i_);
+    statistics<T> b_;
+    b_.count = m_;
+    for (std::size_t j_ = i_; j_ < i_ + m_; ++j_) {
+      b_.sum += S(p_[j_]);
+      b_.min = p_[j_] < b_.min ? p_[j_] : b_.min;
+      b_.max = b_.max < p_[j_] ? p_[j_] : b_.max;
+    }
+    b_.mean = static_cast<double>(b_.sum) / static_cast<double>(m_);
+    for (std::size_t j_ = i_; j_ < i_ + m_; ++j_) {
+      double const d_ = static_cast<double>(p_[j_]) - b_.mean;
+      b_.m2 += d_ * d_;
+    }
+    r_.merge(b_);
+  }
+}
+
+#if defined(CFNUM_SIMD_X86)
+template <simd::kernel_type T>
+[[gnu::target("avx512f,avx512dq")]] void stats_avx512(T const * p_, std::size_t n_, statistics<T> & r_) noexcept {
+  stats_kernel<64>(p_, n_, r_);
+}
+
+template <simd::kernel_type T>
+[[gnu::target("avx2,fma")]] void stats_avx2(T const * p_, std::size_t n_, statistics<T> & r_) noexcept {
+  stats_kernel<32>(p_, n_, r_);
+}
+#endif
+
+template <simd::kernel_type T>
+inline statistics<T> describe_span(std::span<T const> s_) noexcept {
+  statistics<T> r_;
+  switch (simd::active_isa()) {
+#if defined(CFNUM_SIMD_X86)
+    case simd::isa::avx512: stats_avx512(s_.data(), s_.size(), r_); break;
+    case simd::isa::avx2:   stats_avx2(s_.data(), s_.size(), r_); break;
+    case simd::isa::sse2:   stats_kernel<16>(s_.data(), s_.size(), r_); break;
+#elif defined(CFNUM_SIMD_NEON)
+    case simd::isa::neon:   stats_kernel<16>(s_.data(), s_.size(), r_); break;
+#endif
+    default:                stats_scalar(s_.data(), s_.size(), r_); break;
+  }
+  return r_;
+}
+
+} /* namespace detail */
+
+/*
+ *  MARK: describe()
+ *
+ *  Every statistic in one trip through memory.  Contiguous kernel_type ranges
+ *  run the blocked simd kernel above; any other input range gets Welford's
+ *  update one element at a time.
+ */
+template <typename InputIt>
+statistics<std::iter_value_t<InputIt>> describe(InputIt first, InputIt last) {
+  using T = std::iter_value_t<InputIt>;
+  if constexpr (std::contiguous_iterator<InputIt> && simd::kernel_type<T>) {
+    auto const n_ = static_cast<std::size_t>(std::distance(first, last));
+    return detail::describe_span(std::span<T const>(std::to_address(first), n_));
+  }
+  else {
+    statistics<T> r_;
+    for (; first != last; ++first) {
+      r_.push(*first);
+    }
+    return r_;
+  }
+}
+
+template <typename R>
+auto describe(R const & r_) {
+  return describe(std::ranges::begin(r_), std::ranges::end(r_));
+}
+
+/*
+ *  MARK: parallel_describe()
+ *
+ *  Chunks described on the pool, merged left to right.  count, sum, min and max
+ *  come out identical to describe(); mean and m2 can differ in the last bits.
+ */
+template <simd::kernel_type T>
+statistics<T> parallel_describe(thread_pool & pool, std::span<T const> s_, std::size_t grain = reduce_grain) {
+  std::size_t const chunks = detail::chunk_count(s_.size(), pool.size(), grain);
+  if (chunks == 1) {
+    return detail::describe_span(s_);
+  }
+  std::vector<detail::padded<statistics<T>>> partial(chunks);
+  pool.parallel_for(chunks, [&](std::size_t c_) {
+    std::size_t const lo = s_.size() * c_ / chunks;
+    std::size_t const hi = s_.size() * (c_ + 1) / chunks;
+    partial[c_].value = detail::describe_span(s_.subspan(lo, hi - lo));
+  });
+  statistics<T> result;
+  for (auto const & p_ : partial) {
+    result.merge(p_.value);
+  }
+  return result;
+}
+
+template <simd::kernel_type T>
+statistics<T> parallel_describe(std::span<T const> s_) {
+  return parallel_describe(default_pool(), s_);
+}
+
+} /* namespace cfnum */
+
+#endif /* statistics_hpp */
@@ -0,0 +1,277 @@
+//
+//  streaming.hpp
+//  CF.STL_Numeric
+//
+//  MARK: - References.
+//  @see: https://en.cppreference.com/w/cpp/io/c/fread
+//  @see: https://en.cppreference.com/w/cpp/thread/async
+//
+
+#ifndef streaming_hpp
+#define streaming_hpp
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "thread_pool.hpp"
+#include "parallel_reduce.hpp"
+#include "parallel_scan.hpp"
+#include "mapped_file.hpp"
+
+namespace cfnum::stream {
+
+/*
+ *  MARK: options
+ *
+ *  Inputs are flat arrays of T in native byte order, optionally after a header of
+ *  `offset` bytes.  Peak memory is a small multiple of chunk_bytes whatever the
+ *  file size: two read buffers (buffered), or one mapped window kept resident (mapped),
+ *  plus two write buffers when a scan streams its output back to disk.
+ */
+enum class source { buffered, mapped, };
+
+struct options {
+  std::size_t chunk_bytes = std::size_t(16) << 20;
+  source io = source::buffered;
+  std::size_t offset = 0;
+  thread_pool * pool = nullptr;       //  per-chunk work runs here; default_pool() when null
+};
+
+namespace detail {
+
+inline thread_pool & pool_of(options const & opts) {
+  return opts.pool != nullptr ? *opts.pool : default_pool();
+}
+
+template <typename T>
+std::size_t chunk_elements(options const & opts) noexcept {
+  return std::max<std::size_t>(opts.chunk_bytes / sizeof(T), 1);
+}
+
+struct file_closer {
+  void operator()(std::FILE * f_) const noexcept { std::fclose(f_); }
+};
+using file_ptr = std::unique_ptr<std::FILE, file_closer>;
+
+//  Read the next chunk into buf[1] while fn consumes buf[0].
+template <typename T, typename Fn>
+bool for_each_buffered(std::string const & path, options const & opts, Fn & fn) {
+  file_ptr in { std::fopen(path.c_str(), "rb") };
+  if (!in || std::fseek(in.get(), static_cast<long>(opts.offset), SEEK_SET) != 0) {
+    return false;
+  }
+  std::size_t const elems = chunk_elements<T>(opts);
+  std::vector<T> current(elems);
+  std::vector<T> next(elems);
+  auto read = [f_ = in.get(), elems](std::vector<T> & buf) {
+    return std::fread(buf.data(), sizeof(T), elems, f_);
+  };
+
+  std::size_t got = read(current);
+  while (got != 0) {
+    auto pending = std::async(std::launch::async, read, std::ref(next));
+    fn(std::span<T const>(current.data(), got));
+    got = pending.get();
+    current.swap(next);
+  }
+  return std::ferror(in.get()) == 0;
+}
+
+//  Walk a read-only mapping window by window: prefetch the next window, release
+//  the one just finished so resident memory stays near one chunk.
+template <typename T, typename Fn>
+bool for_each_mapped(std::string const & path, options const & opts, Fn & fn) {
+  mapped_file map { path };
+  if (!map) {
+    return false;
+  }
+  if (map.size() <= opts.offset) {
+    return true;
+  }
+  auto const * base = map.data() + opts.offset;
+  if (reinterpret_cast<std::uintptr_t>(base) % alignof(T) != 0) {
+    return for_each_buffered<T>(path, opts, fn);
+  }
+  std::size_t const total = (map.size() - opts.offset) / sizeof(T);
+  std::size_t const elems = chunk_elements<T>(opts);
+  map.advise(mapped_file::advice::sequential);
+  for (std::size_t lo = 0; lo < total; lo += elems) {
+    std::size_t const n_ = std::min(elems, total - lo);
+    map.advise(mapped_file::advice::will_need, opts.offset + (lo + n_) * sizeof(T), elems * sizeof(T));
+    fn(std::span<T const>(reinterpret_cast<T const *>(base) + lo, n_));
+    map.advise(mapped_file::advice::dont_need, opts.offset + lo * sizeof(T), n_ * sizeof(T));
+  }
+  return true;
+}
+
+} /* namespace detail */
+
+/*
+ *  MARK: for_each_chunk()
+ *
+ *  Calls fn(std::span<T const>) once per chunk, in file order.  Returns false if
+ *  the file could not be opened or a read failed.
+ */
+template <typename T, typename Fn>
+  requires std::is_trivially_copyable_v<T>
+bool for_each_chunk(std::string const & path, options const & opts, Fn && fn) {
+  return opts.io == source::mapped ? detail::for_each_mapped<T>(path, opts, fn)
+                                   : detail::for_each_buffered<T>(path, opts, fn);
+}
+
+/*
+ *  MARK: chunk_writer
+ *
+ *  Double-buffered output: fill buffer() then commit(n); the write of one buffer
+ *  overlaps filling the other.
+ */
+template <typename T>
+class chunk_writer {
+public:
+  chunk_writer(std::string const & path, std::size_t elems)
+    : out_(std::fopen(path.c_str(), "wb")), fill_(elems), flush_(elems) {}
+
+  chunk_writer(chunk_writer const &) = delete;
+  chunk_writer & operator=(chunk_writer const &) = delete;
+  ~chunk_writer() { finish(); }
+
+  explicit operator bool() const noexcept { return out_ != nullptr && ok_; }
+
+  std::span<T> buffer() noexcept { return fill_; }
+
+  void commit(std::size_t n_) {
+    if (!out_) {
+      return;
+    }
+    wait();
+    fill_.swap(flush_);
+    pending_ = std::async(std::launch::async, [this, n_] {
+      return std::fwrite(flush_.data(), sizeof(T), n_, out_.get()) == n_;
+    });
+  }
+
+  bool finish() {
+    wait();
+    if (out_) {
+      ok_ = std::fflush(out_.get()) == 0 && ok_;
+    }
+    return static_cast<bool>(*this);
+  }
+
+private:
+  void wait() {
+    if (pending_.valid()) {
+      ok_ = pending_.get() && ok_;
+    }
+  }
+
+  detail::file_ptr out_;
+  std::vector<T> fill_;
+  std::vector<T> flush_;
+  std::future<bool> pending_;
+  bool ok_ = true;
+};
+
+/*
+ *  MARK: generate()
+ *
+ *  Writes count values gen(i) to path chunk by chunk, so building a test input
+ *  larger than RAM needs no more memory than reading it back.
+ */
+template <typename T, typename Gen>
+bool generate(std::string const & path, std::size_t count, Gen gen, options const & opts = {}) {
+  std::size_t const elems = detail::chunk_elements<T>(opts);
+  chunk_writer<T> out(path, elems);
+  for (std::size_t lo = 0; lo < count && out; lo += elems) {
+    std::size_t const n_ = std::min(elems, count - lo);
+    auto buf = out.buffer();
+    for (std::size_t i_ = 0; i_ < n_; ++i_) {
+      buf[i_] = gen(lo + i_);
+    }
+    out.commit(n_);
+  }
+  return out.finish();
+}
+
+/*
+ *  MARK: reduce(), transform_reduce()
+ *
+ *  Chunk by chunk on the pool, folding the running total in as each chunk's init.
+ *  Same requirements on op as std::reduce.  std::nullopt on an I/O error.
+ */
+template <typename T, typename U, typename BinaryOp, typename UnaryOp>
+std::optional<U> transform_reduce(std::string const & path, U init,
+                                  BinaryOp reduce_op, UnaryOp transform_op,
+                                  options const & opts = {}) {
+  thread_pool & pool = detail::pool_of(opts);
+  U acc = init;
+  bool const ok = for_each_chunk<T>(path, opts, [&](std::span<T const> chunk) {
+    acc = parallel_transform_reduce(pool, chunk.begin(), chunk.end(), acc, reduce_op, transform_op);
+  });
+  return ok ? std::optional<U>(acc) : std::nullopt;
+}
+
+template <typename T, typename BinaryOp = std::plus<>>
+std::optional<T> reduce(std::string const & path, T init, BinaryOp op = {}, options const & opts = {}) {
+  thread_pool & pool = detail::pool_of(opts);
+  T acc = init;
+  bool const ok = for_each_chunk<T>(path, opts, [&](std::span<T const> chunk) {
+    if constexpr (simd::kernel_type<T> && std::is_same_v<BinaryOp, std::plus<>>) {
+      acc += parallel_sum(pool, chunk);
+    }
+    else {
+      acc = parallel_reduce(pool, chunk.begin(), chunk.end(), acc, op);
+    }
+  });
+  return ok ? std::optional<T>(acc) : std::nullopt;
+}
+
+/*
+ *  MARK: inclusive_scan()
+ *
+ *  Streams the inclusive scan of in_path to out_path (same element type, no
+ *  header).  The running total is carried from one chunk into the next, so the
+ *  file written equals std::inclusive_scan over the whole input.  Returns the final
+ *  total, or std::nullopt on an I/O error (or an empty input).
+ */
+template <typename T, typename BinaryOp = std::plus<>>
+std::optional<T> inclusive_scan(std::string const & in_path, std::string const & out_path,
+                                BinaryOp op = {}, options const & opts = {}) {
+  thread_pool & pool = detail::pool_of(opts);
+  std::optional<chunk_writer<T>> out;
+  std::optional<T> carry;
+  bool const ok = for_each_chunk<T>(in_path, opts, [&](std::span<T const> chunk) {
+    //  Opened with the first chunk, so an input that cannot be read leaves
+    //  out_path as it was.
+    if (!out) {
+      out.emplace(out_path, detail::chunk_elements<T>(opts));
+    }
+    if (!*out) {
+      return;
+    }
+    auto buf = out->buffer();
+    if (carry) {
+      parallel_inclusive_scan(pool, chunk.begin(), chunk.end(), buf.begin(), op, *carry);
+    }
+    else {
+      parallel_inclusive_scan(pool, chunk.begin(), chunk.end(), buf.begin(), op);
+    }
+    carry = buf[chunk.size() - 1];
+    out->commit(chunk.size());
+  });
+  return ok && out && out->finish() ? carry : std::nullopt;
+}
+
+} /* namespace cfnum::stream */
+
+#endif /* streaming_hpp */
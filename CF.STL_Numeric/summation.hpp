@@ -0,0 +1,303 @@
+//
+//  summation.hpp
+//  CF.STL_Numeric
+//
+//  MARK: - References.
+//  @see: https://en.wikipedia.org/wiki/Kahan_summation_algorithm
+//  @see: https://en.wikipedia.org/wiki/Pairwise_summation
+//  @see: https://en.wikipedia.org/wiki/2Sum
+//
+
+#ifndef summation_hpp
+#define summation_hpp
+
+#include <algorithm>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <iterator>
+#include <numeric>
+#include <span>
+#include <vector>
+
+#include "thread_pool.hpp"
+#include "simd_kernels.hpp"
+
+namespace cfnum {
+
+/*
+ *  MARK: summation
+ *
+ *  naive             left fold, O(n) error growth (std::accumulate)
+ *  kahan             compensated, loses the compensation when |x| > |sum|
+ *  neumaier          compensated, exact error term for any operand order
+ *  pairwise          recursive halving, O(log n) error growth
+ *  blocked_pairwise  SIMD-summed blocks combined pairwise
+ *  reproducible      fixed block decomposition; bit-identical for any thread count
+ */
+enum class summation { naive, kahan, neumaier, pairwise, blocked_pairwise, reproducible, };
+
+inline char const * summation_name(summation s_) noexcept {
+  switch (s_) {
+    case summation::kahan:            return "kahan";
+    case summation::neumaier:         return "neumaier";
+    case summation::pairwise:         return "pairwise";
+    case summation::blocked_pairwise: return "blocked_pairwise";
+    case summation::reproducible:     return "reproducible";
+    default:                          return "naive";
+  }
+}
+
+/*
+ *  MARK: neumaier_accumulator
+ *
+ *  Running sum plus the exact rounding error of every addition so far, for
+ *  folding over iterators that are not contiguous.  merge() combines two
+ *  partial accumulators, so it also works as a parallel reduction state.
+ */
+template <std::floating_point T>
+struct neumaier_accumulator {
+  T sum {};
+  T compensation {};
+
+  constexpr void add(T x_) noexcept {
+    T const t_ = sum + x_;
+    if (std::abs(sum) >= std::abs(x_)) {
+      compensation += (sum - t_) + x_;
+    }
+    else {
+      compensation += (x_ - t_) + sum;
+    }
+    sum = t_;
+  }
+
+  constexpr void merge(neumaier_accumulator const & other) noexcept {
+    add(other.sum);
+    compensation += other.compensation;
+  }
+
+  constexpr T value() const noexcept { return sum + compensation; }
+};
+
+template <typename InputIt, std::floating_point T>
+constexpr T kahan_accumulate(InputIt first, InputIt last, T init) noexcept {
+  T sum = init;
+  T c_ {};
+  for (; first != last; ++first) {
+    T const y_ = static_cast<T>(*first) - c_;
+    T const t_ = sum + y_;
+    c_ = (t_ - sum) - y_;
+    sum = t_;
+  }
+  return sum;
+}
+
+template <typename InputIt, std::floating_point T>
+constexpr T neumaier_accumulate(InputIt first, InputIt last, T init) noexcept {
+  neumaier_accumulator<T> acc { init, T {} };
+  for (; first != last; ++first) {
+    acc.add(static_cast<T>(*first));
+  }
+  return acc.value();
+}
+
+namespace detail {
+
+//  Knuth's branch-free TwoSum: s + e == a + b exactly.  Used by the vector kernels
+//  in place of Neumaier's comparison, which would need a per-lane select.
+template <typename V>
+[[gnu::always_inline]] inline void two_sum_add(V & s_, V & c_, V const & x_) noexcept {
+  V const t_ = s_ + x_;
+  V const z_ = t_ - s_;
+  c_ += (s_ - (t_ - z_)) + (x_ - z_);
+  s_ = t_;
+}
+
+//  Per-lane compensated sum, two vectors of lanes in flight.  Bytes fixes the
+//  lane count, so the result depends only on Bytes, not on the instruction set
+//  the caller was compiled for.
+template <std::size_t Bytes, std::floating_point T>
+[[gnu::always_inline]] inline neumaier_accumulator<T> compensated_kernel(T const * p_, std::size_t n_) noexcept {
+  using V = typename simd::detail::vec<T, Bytes>::type;
+  constexpr std::size_t L = simd::detail::vec<T, Bytes>::lanes;
+  V s0 {}, s1 {}, c0 {}, c1 {};
+  V x0, x1;
+  std::size_t i_ = 0;
+  for (; i_ + 2 * L <= n_; i_ += 2 * L) {
+    simd::detail::load(x0, p_ + i_);
+    simd::detail::load(x1, p_ + i_ + L);
+    two_sum_add(s0, c0, x0);
+    two_sum_add(s1, c1, x1);
+  }
+  two_sum_add(s0, c0, s1);
+  c0 += c1;
+  neumaier_accumulator<T> acc;
+  for (std::size_t l_ = 0; l_ < L; ++l_) {
+    acc.add(s0[l_]);
+    acc.compensation += c0[l_];
+  }
+  for (; i_ < n_; ++i_) {
+    acc.add(p_[i_]);
+  }
+  return acc;
+}
+
+#if defined(CFNUM_SIMD_X86)
+template <std::floating_point T>
+[[gnu::target("avx512f,avx512dq")]] neumaier_accumulator<T> compensated_avx512(T const * p_, std::size_t n_) noexcept {
+  return compensated_kernel<64>(p_, n_);
+}
+
+template <std::floating_point T>
+[[gnu::target("avx2,fma")]] neumaier_accumulator<T> compensated_avx2(T const * p_, std::size_t n_) noexcept {
+  return compensated_kernel<32>(p_, n_);
+}
+
+template <std::floating_point T>
+[[gnu::target("avx2,fma")]] neumaier_accumulator<T> compensated_fixed_avx2(T const * p_, std::size_t n_) noexcept {
+  return compensated_kernel<64>(p_, n_);
+}
+#endif
+
+template <std::floating_point T>
+inline neumaier_accumulator<T> compensated_block(std::span<T const> s_) noexcept {
+  switch (simd::active_isa()) {
+#if defined(CFNUM_SIMD_X86)
+    case simd::isa::avx512: return compensated_avx512(s_.data(), s_.size());
+    case simd::isa::avx2:   return compensated_avx2(s_.data(), s_.size());
+#endif
+    default:                return compensated_kernel<16>(s_.data(), s_.size());
+  }
+}
+
+//  Fixed 64-byte lane layout whatever the CPU, for the reproducible mode.
+template <std::floating_point T>
+inline neumaier_accumulator<T> compensated_block_fixed(std::span<T const> s_) noexcept {
+#if defined(CFNUM_SIMD_X86)
+  if (static_cast<int>(simd::active_isa()) >= static_cast<int>(simd::isa::avx2)) {
+    return compensated_fixed_avx2(s_.data(), s_.size());
+  }
+#endif
+  return compensated_kernel<64>(s_.data(), s_.size());
+}
+
+template <std::floating_point T>
+T pairwise(T const * p_, std::size_t n_, std::size_t base) noexcept {
+  if (n_ <= base) {
+    T a0 {}, a1 {}, a2 {}, a3 {};
+    std::size_t i_ = 0;
+    for (; i_ + 4 <= n_; i_ += 4) {
+      a0 += p_[i_];
+      a1 += p_[i_ + 1];
+      a2 += p_[i_ + 2];
+      a3 += p_[i_ + 3];
+    }
+    for (; i_ < n_; ++i_) {
+      a0 += p_[i_];
+    }
+    return (a0 + a1) + (a2 + a3);
+  }
+  std::size_t const half = n_ / 2;
+  return pairwise(p_, half, base) + pairwise(p_ + half, n_ - half, base);
+}
+
+//  Combine per-block results in a balanced tree whose shape depends only on the
+//  number of blocks.
+template <typename T, typename Combine>
+T tree_combine(std::vector<T> & v_, Combine combine) {
+  if (v_.empty()) {
+    return T {};
+  }
+  for (std::size_t width = 1; width < v_.size(); width *= 2) {
+    for (std::size_t i_ = 0; i_ + width < v_.size(); i_ += 2 * width) {
+      v_[i_] = combine(v_[i_], v_[i_ + width]);
+    }
+  }
+  return v_.front();
+}
+
+} /* namespace detail */
+
+//  Block length of the blocked and reproducible strategies; part of the
+//  reproducible result, so changing it changes the bits returned.
+inline constexpr std::size_t summation_block = 2'048;
+
+/*
+ *  MARK: kahan_sum(), neumaier_sum(), pairwise_sum(), blocked_pairwise_sum()
+ */
+template <std::floating_point T>
+T kahan_sum(std::span<T const> s_) noexcept {
+  return kahan_accumulate(s_.begin(), s_.end(), T {});
+}
+
+//  Vectorized: per-lane TwoSum compensation, then a Neumaier fold of the lanes.
+template <std::floating_point T>
+T neumaier_sum(std::span<T const> s_) noexcept {
+  return detail::compensated_block(s_).value();
+}
+
+template <std::floating_point T>
+T pairwise_sum(std::span<T const> s_, std::size_t base = 128) noexcept {
+  return detail::pairwise(s_.data(), s_.size(), base < 4 ? 4 : base);
+}
+
+template <std::floating_point T>
+T blocked_pairwise_sum(std::span<T const> s_) {
+  std::vector<T> blocks((s_.size() + summation_block - 1) / summation_block);
+  for (std::size_t b_ = 0; b_ < blocks.size(); ++b_) {
+    blocks[b_] = simd::sum(s_.subspan(b_ * summation_block,
+                                      std::min(summation_block, s_.size() - b_ * summation_block)));
+  }
+  return detail::tree_combine(blocks, [](T a_, T b_) { return a_ + b_; });
+}
+
+/*
+ *  MARK: reproducible_sum()
+ *
+ *  The input is cut into summation_block-sized blocks no matter how many threads
+ *  run; each block gets a compensated sum with a fixed lane layout and the block
+ *  results are merged in a fixed tree.  Threads only decide who computes which
+ *  block, so the result is bit-identical for any pool size (and any supported
+ *  instruction set).
+ */
+template <std::floating_point T>
+T reproducible_sum(thread_pool & pool, std::span<T const> s_) {
+  std::size_t const blocks = (s_.size() + summation_block - 1) / summation_block;
+  std::vector<neumaier_accumulator<T>> partial(blocks);
+  std::size_t const per_task = 64;
+  pool.parallel_for((blocks + per_task - 1) / per_task, [&](std::size_t t_) {
+    std::size_t const hi = std::min(blocks, (t_ + 1) * per_task);
+    for (std::size_t b_ = t_ * per_task; b_ < hi; ++b_) {
+      std::size_t const lo = b_ * summation_block;
+      partial[b_] = detail::compensated_block_fixed(s_.subspan(lo, std::min(summation_block, s_.size() - lo)));
+    }
+  });
+  return detail::tree_combine(partial, [](auto a_, auto const & b_) {
+    a_.merge(b_);
+    return a_;
+  }).value();
+}
+
+template <std::floating_point T>
+T reproducible_sum(std::span<T const> s_) {
+  return reproducible_sum(default_pool(), s_);
+}
+
+/*
+ *  MARK: sum()
+ */
+template <std::floating_point T>
+T sum(std::span<T const> s_, summation strategy) {
+  switch (strategy) {
+    case summation::kahan:            return kahan_sum(s_);
+    case summation::neumaier:         return neumaier_sum(s_);
+    case summation::pairwise:         return pairwise_sum(s_);
+    case summation::blocked_pairwise: return blocked_pairwise_sum(s_);
+    case summation::reproducible:     return reproducible_sum(s_);
+    default:                          return std::accumulate(s_.begin(), s_.end(), T {});
+  }
+}
+
+} /* namespace cfnum */
+
+#endif /* summation_hpp */
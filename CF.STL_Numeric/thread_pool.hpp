@@ -0,0 +1,186 @@
+//
+//  thread_pool.hpp
+//  CF.STL_Numeric
+//
+//  MARK: - References.
+//  @see: https://en.cppreference.com/w/cpp/thread
+//
+
+#ifndef thread_pool_hpp
+#define thread_pool_hpp
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cfnum {
+
+/*
+ *  MARK: thread_pool
+ *
+ *  Fork-join pool used by the parallel numeric algorithms.
+ *  A pool of size N runs work on N - 1 worker threads plus the calling thread.
+ *  parallel_for() blocks until every task has finished; calls made from inside
+ *  a running task execute serially on the current thread instead of deadlocking.
+ */
+class thread_pool {
+public:
+  explicit thread_pool(std::size_t threads = hardware_threads()) {
+    threads = std::max<std::size_t>(threads, 1);
+    workers_.reserve(threads - 1);
+    for (std::size_t t_ = 1; t_ < threads; ++t_) {
+      workers_.emplace_back([this] { worker_loop(); });
+    }
+  }
+
+  thread_pool(thread_pool const &) = delete;
+  thread_pool & operator=(thread_pool const &) = delete;
+
+  ~thread_pool() {
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto & w_ : workers_) {
+      w_.join();
+    }
+  }
+
+  std::size_t size() const noexcept { return workers_.size() + 1; }
+
+  static std::size_t hardware_threads() noexcept {
+    return std::max(1U, std::thread::hardware_concurrency());
+  }
+
+  //  Invoke fn(i) for every i in [0, tasks).  Tasks are handed out dynamically,
+  //  so callers may over-decompose to balance uneven chunks.
+  template <typename Fn>
+  void parallel_for(std::size_t tasks, Fn && fn) {
+    if (tasks == 0) {
+      return;
+    }
+    if (tasks == 1 || workers_.empty() || in_task()) {
+      for (std::size_t i_ = 0; i_ < tasks; ++i_) {
+        fn(i_);
+      }
+      return;
+    }
+
+    std::lock_guard<std::mutex> serial(submit_mtx_);
+    auto job = std::make_shared<job_t>();
+    job->fn = std::ref(fn);
+    job->tasks = tasks;
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      job_ = job;
+      ++generation_;
+    }
+    wake_.notify_all();
+
+    run_tasks(*job);
+
+    std::unique_lock<std::mutex> lock(mtx_);
+    done_.wait(lock, [&job] { return job->finished.load(std::memory_order_acquire) == job->tasks; });
+    job_.reset();
+  }
+
+private:
+  struct job_t {
+    std::function<void(std::size_t)> fn;
+    std::size_t tasks = 0;
+    std::atomic<std::size_t> next { 0 };
+    std::atomic<std::size_t> finished { 0 };
+  };
+
+  static bool & in_task() noexcept {
+    thread_local bool flag = false;
+    return flag;
+  }
+
+  void run_tasks(job_t & job) {
+    bool const nested = in_task();
+    in_task() = true;
+    std::size_t ran = 0;
+    for (std::size_t i_ = job.next.fetch_add(1, std::memory_order_relaxed);
+         i_ < job.tasks;
+         i_ = job.next.fetch_add(1, std::memory_order_relaxed)) {
+      job.fn(i_);
+      ++ran;
+    }
+    in_task() = nested;
+    if (ran != 0 && job.finished.fetch_add(ran, std::memory_order_acq_rel) + ran == job.tasks) {
+      std::lock_guard<std::mutex> lock(mtx_);
+      done_.notify_all();
+    }
+  }
+
+  void worker_loop() {
+    std::size_t seen = 0;
+    for (;;) {
+      std::shared_ptr<job_t> job;
+      {
+        std::unique_lock<std::mutex> lock(mtx_);
+        wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+        if (stop_) {
+          return;
+        }
+        seen = generation_;
+        job = job_;
+      }
+      if (job) {
+        run_tasks(*job);
+      }
+    }
+  }
+
+  std::vector<std::thread> workers_;
+  std::mutex submit_mtx_;
+  std::mutex mtx_;
+  std::condition_variable wake_;
+  std::condition_variable done_;
+  std::shared_ptr<job_t> job_;
+  std::size_t generation_ = 0;
+  bool stop_ = false;
+};
+
+/*
+ *  MARK: default_pool()
+ *
+ *  Process-wide pool shared by the convenience overloads.  Its size defaults to
+ *  std::thread::hardware_concurrency() and can be changed with
+ *  set_default_concurrency() before (or between) parallel calls.
+ */
+inline std::size_t & default_concurrency_ref() noexcept {
+  static std::size_t threads = thread_pool::hardware_threads();
+  return threads;
+}
+
+inline thread_pool & default_pool() {
+  static std::unique_ptr<thread_pool> pool;
+  static std::mutex mtx;
+  std::lock_guard<std::mutex> lock(mtx);
+  if (!pool || pool->size() != default_concurrency_ref()) {
+    pool.reset();
+    pool = std::make_unique<thread_pool>(default_concurrency_ref());
+  }
+  return *pool;
+}
+
+inline void set_default_concurrency(std::size_t threads) noexcept {
+  default_concurrency_ref() = std::max<std::size_t>(threads, 1);
+}
+
+inline std::size_t default_concurrency() noexcept {
+  return default_concurrency_ref();
+}
+
+} /* namespace cfnum */
+
+#endif /* thread_pool_hpp */